@@ -0,0 +1,440 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Headless pixel regression tests for SoftGfxDevice.
+//
+// Runs every test of the gfxdevice_testapp testsuites on a SoftGfxDevice for each
+// canvas PixelFormat and default BlendMode, and compares a hash of the output
+// against the reference index in the reference directory. If the reference image
+// is present as well, the number of mismatching pixels is reported.
+//
+// Reference images are stored as RLE compressed 32-bit TGA files named by their
+// hash, so identical outputs share a file.
+//
+// Usage: gfxregression [--generate] [--images] [--filter name] referenceDir
+//
+//   --generate		Write a new reference index (and images with --images) instead of comparing.
+//   --images		Also write images. When comparing, the output of each failing test is
+//					written to the reference directory so it can be inspected.
+//   --filter name	Only run tests or suites with name containing the given string.
+//
+// Returns 0 if all outputs match their references.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <wondergui.h>
+#include <wg_softgfxdevice.h>
+#include <wg_softsurface.h>
+#include <wg_softsurfacefactory.h>
+
+#include <testsuites/testsuite.h>
+#include <testsuites/filltests.h>
+#include <testsuites/plottests.h>
+#include <testsuites/linetests.h>
+#include <testsuites/canvasformattests.h>
+#include <testsuites/blittests.h>
+#include <testsuites/segmenttests.h>
+#include <testsuites/wavetests.h>
+#include <testsuites/clutblittests.h>
+#include <testsuites/widgettests.h>
+
+using namespace wg;
+using namespace std;
+
+const Size			c_canvasSize(512, 512);
+
+const PixelFormat	c_canvasFormats[] = { PixelFormat::BGRA_8, PixelFormat::BGRX_8, PixelFormat::BGR_8, PixelFormat::BGRA_4, PixelFormat::BGR_565 };
+const BlendMode		c_blendModes[] = { BlendMode::Replace, BlendMode::Blend, BlendMode::Add, BlendMode::Subtract, BlendMode::Multiply, BlendMode::Invert };
+
+//____ create_testsuites() ____________________________________________________
+
+vector<TestSuite*> create_testsuites()
+{
+	return {	new FillTests(),
+				new PlotTests(),
+				new LineTests(),
+				new CanvasFormatTests(),
+				new PatchBlitTests(),
+				new SegmentTests(),
+				new WaveTests(),
+				new ClutBlitTests(),
+				new WidgetTests() };
+}
+
+//____ read_canvas() __________________________________________________________
+//
+// Reads the canvas as 32-bit ARGB, independent of the canvas pixel format.
+
+void read_canvas(Surface * pCanvas, vector<uint32_t>& out)
+{
+	Size size = pCanvas->size();
+	out.resize(size.w * size.h);
+
+	int bytesPerPixel = pCanvas->pixelDescription()->bits / 8;
+	const uint8_t * pPixels = pCanvas->lock(AccessMode::ReadOnly);
+	int pitch = pCanvas->pitch();
+
+	for (int y = 0; y < size.h; y++)
+	{
+		const uint8_t * p = pPixels + y * pitch;
+		for (int x = 0; x < size.w; x++)
+		{
+			uint32_t pixel = 0;
+			for (int i = 0; i < bytesPerPixel; i++)
+				pixel |= p[i] << (i * 8);
+
+			out[y * size.w + x] = pCanvas->pixelToColor(pixel).argb;
+			p += bytesPerPixel;
+		}
+	}
+
+	pCanvas->unlock();
+}
+
+//____ hash_pixels() __________________________________________________________
+
+uint64_t hash_pixels(const vector<uint32_t>& pixels)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (uint32_t pixel : pixels)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			hash ^= (pixel >> (i * 8)) & 0xFF;
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+//____ write_tga() ____________________________________________________________
+
+bool write_tga(const char * pPath, Size size, const vector<uint32_t>& pixels)
+{
+	FILE * fp = fopen(pPath, "wb");
+	if (!fp)
+		return false;
+
+	uint8_t header[18] = { 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+							(uint8_t)size.w, (uint8_t)(size.w >> 8), (uint8_t)size.h, (uint8_t)(size.h >> 8), 32, 0x28 };
+	fwrite(header, 1, 18, fp);
+
+	// RLE packets of up to 128 pixels, not crossing lines.
+
+	for (int y = 0; y < size.h; y++)
+	{
+		const uint32_t * pLine = &pixels[y * size.w];
+		int x = 0;
+		while (x < size.w)
+		{
+			int run = 1;
+			while (x + run < size.w && run < 128 && pLine[x + run] == pLine[x])
+				run++;
+
+			if (run > 1)
+			{
+				fputc(0x80 | (run - 1), fp);
+				fwrite(&pLine[x], 4, 1, fp);
+			}
+			else
+			{
+				while (x + run < size.w && run < 128 && (x + run + 1 >= size.w || pLine[x + run] != pLine[x + run + 1]))
+					run++;
+
+				fputc(run - 1, fp);
+				fwrite(&pLine[x], 4, run, fp);
+			}
+			x += run;
+		}
+	}
+
+	bool bOk = !ferror(fp);
+	fclose(fp);
+	return bOk;
+}
+
+//____ read_tga() _____________________________________________________________
+//
+// Only reads the 32-bit top-left origin TGA files written by write_tga().
+
+bool read_tga(const char * pPath, Size& size, vector<uint32_t>& pixels)
+{
+	FILE * fp = fopen(pPath, "rb");
+	if (!fp)
+		return false;
+
+	uint8_t header[18];
+	if (fread(header, 1, 18, fp) != 18 || (header[2] != 10 && header[2] != 2) || header[16] != 32 || (header[17] & 0x20) == 0)
+	{
+		fclose(fp);
+		return false;
+	}
+	fseek(fp, header[0], SEEK_CUR);
+
+	size.w = header[12] | (header[13] << 8);
+	size.h = header[14] | (header[15] << 8);
+	pixels.resize(size.w * size.h);
+
+	bool bRLE = (header[2] == 10);
+	size_t ofs = 0;
+
+	while (ofs < pixels.size())
+	{
+		int packet = bRLE ? fgetc(fp) : 0xFF;
+		if (packet == EOF)
+			break;
+
+		int count = bRLE ? (packet & 0x7F) + 1 : (int) pixels.size();
+		if (ofs + count > pixels.size())
+			break;
+
+		if (packet & 0x80 && bRLE)
+		{
+			uint32_t pixel;
+			if (fread(&pixel, 4, 1, fp) != 1)
+				break;
+			for (int i = 0; i < count; i++)
+				pixels[ofs++] = pixel;
+		}
+		else
+		{
+			if (fread(&pixels[ofs], 4, count, fp) != (size_t) count)
+				break;
+			ofs += count;
+		}
+	}
+
+	fclose(fp);
+	return ofs == pixels.size();
+}
+
+//____ read_index() ___________________________________________________________
+
+bool read_index(const string& path, map<string,uint64_t>& index)
+{
+	FILE * fp = fopen(path.c_str(), "r");
+	if (!fp)
+		return false;
+
+	char line[512];
+	while (fgets(line, sizeof(line), fp))
+	{
+		char suite[128], test[128], format[32], blendMode[32];
+		unsigned long long hash;
+
+		if (line[0] == '#' || sscanf(line, "%127s %127s %31s %31s %llx", suite, test, format, blendMode, &hash) != 5)
+			continue;
+
+		index[string(suite) + " " + test + " " + format + " " + blendMode] = hash;
+	}
+
+	fclose(fp);
+	return true;
+}
+
+//____ main() _________________________________________________________________
+
+int main(int argc, char * argv[])
+{
+	bool			bGenerate = false;
+	bool			bImages = false;
+	const char *	pFilter = nullptr;
+	const char *	pRefDir = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--generate") == 0)
+			bGenerate = true;
+		else if (strcmp(argv[i], "--images") == 0)
+			bImages = true;
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			pFilter = argv[++i];
+		else if (argv[i][0] != '-' && !pRefDir)
+			pRefDir = argv[i];
+		else
+			pRefDir = nullptr, argc = 0;
+	}
+
+	if (!pRefDir)
+	{
+		printf("Usage: gfxregression [--generate] [--images] [--filter name] referenceDir\n");
+		return -1;
+	}
+
+	string refDir = pRefDir;
+	string indexPath = refDir + "/references.txt";
+
+	map<string,uint64_t> index;
+	if (!bGenerate && !read_index(indexPath, index))
+	{
+		printf("Unable to read reference index '%s'. Run with --generate first.\n", indexPath.c_str());
+		return -1;
+	}
+
+	FILE * pIndexFile = nullptr;
+	if (bGenerate)
+	{
+		pIndexFile = fopen(indexPath.c_str(), "w");
+		if (!pIndexFile)
+		{
+			printf("Unable to write reference index '%s'.\n", indexPath.c_str());
+			return -1;
+		}
+		fprintf(pIndexFile, "# suite test canvasformat blendmode hash\n");
+	}
+
+	Base::init();
+
+	Rect canvasRect(c_canvasSize);
+
+	vector<SoftSurface_p> canvases;
+	for (PixelFormat format : c_canvasFormats)
+		canvases.push_back(SoftSurface::create(c_canvasSize, format));
+
+	SoftGfxDevice_p pDevice = SoftGfxDevice::create(canvases[0]);
+
+	vector<TestSuite*> suites = create_testsuites();
+	vector<uint32_t> output;
+	vector<uint32_t> reference;
+
+	int nPassed = 0, nFailed = 0, nMissing = 0, nSkipped = 0;
+
+	for (auto pSuite : suites)
+	{
+		if (!pSuite->init(pDevice, canvasRect))
+		{
+			printf("%s failed to initialize, skipped.\n", pSuite->name.c_str());
+			nSkipped += (int) pSuite->tests.size();
+			continue;
+		}
+
+		for (auto& test : pSuite->tests)
+		{
+			if (pFilter && pSuite->name.find(pFilter) == string::npos && test.name.find(pFilter) == string::npos)
+				continue;
+
+			for (auto& pCanvas : canvases)
+			{
+				for (BlendMode blendMode : c_blendModes)
+				{
+					pDevice->setCanvas(pCanvas);
+					pDevice->beginRender();
+					pDevice->setClipList(1, &canvasRect);
+					pDevice->setBlendMode(BlendMode::Replace);
+					pDevice->fill(canvasRect, Color::Black);
+					pDevice->setBlendMode(blendMode);
+					pDevice->setTintColor(Color::White);
+
+					if (test.init != nullptr)
+						test.init(pDevice, canvasRect);
+
+					test.run(pDevice, canvasRect);
+
+					if (test.exit != nullptr)
+						test.exit(pDevice, canvasRect);
+
+					pDevice->endRender();
+
+					read_canvas(pCanvas, output);
+					uint64_t hash = hash_pixels(output);
+
+					char hashStr[20];
+					sprintf(hashStr, "%016llx", (unsigned long long) hash);
+					string imagePath = refDir + "/" + hashStr + ".tga";
+
+					string key = pSuite->name + " " + test.name + " " + toString(pCanvas->pixelFormat()) + " " + toString(blendMode);
+
+					if (bGenerate)
+					{
+						fprintf(pIndexFile, "%s %s\n", key.c_str(), hashStr);
+						if (bImages)
+						{
+							FILE * fp = fopen(imagePath.c_str(), "rb");
+							if (fp)
+								fclose(fp);
+							else if (!write_tga(imagePath.c_str(), c_canvasSize, output))
+								printf("Unable to write '%s'.\n", imagePath.c_str());
+						}
+						nPassed++;
+						continue;
+					}
+
+					auto it = index.find(key);
+					if (it == index.end())
+					{
+						printf("%-60s NO REFERENCE\n", key.c_str());
+						nMissing++;
+					}
+					else if (it->second == hash)
+						nPassed++;
+					else
+					{
+						char refHashStr[20];
+						sprintf(refHashStr, "%016llx", (unsigned long long) it->second);
+
+						Size refSize;
+						if (read_tga((refDir + "/" + refHashStr + ".tga").c_str(), refSize, reference) && refSize == c_canvasSize)
+						{
+							int nDiff = 0;
+							for (size_t i = 0; i < output.size(); i++)
+								if (output[i] != reference[i])
+									nDiff++;
+
+							printf("%-60s DIFFERS, %d pixels\n", key.c_str(), nDiff);
+						}
+						else
+							printf("%-60s DIFFERS (%s != %s)\n", key.c_str(), hashStr, refHashStr);
+
+						if (bImages)
+							write_tga(imagePath.c_str(), c_canvasSize, output);
+
+						nFailed++;
+					}
+				}
+			}
+		}
+
+		pSuite->exit(pDevice, canvasRect);
+	}
+
+	for (auto pSuite : suites)
+		delete pSuite;
+
+	if (pIndexFile)
+		fclose(pIndexFile);
+
+	pDevice = nullptr;
+	canvases.clear();
+	Base::exit();
+
+	if (bGenerate)
+		printf("Wrote %d references to '%s'.\n", nPassed, indexPath.c_str());
+	else
+		printf("%d passed, %d failed, %d without reference, %d skipped.\n", nPassed, nFailed, nMissing, nSkipped);
+
+	return nFailed > 0 ? 1 : 0;
+}
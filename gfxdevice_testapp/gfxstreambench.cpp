@@ -0,0 +1,436 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Capture and replay of GfxStreams for benchmarking SoftGfxDevice on recorded sessions.
+//
+// A capture file is simply the raw chunks of a GfxStream, exactly as they come out of a
+// GfxStreamPlug, so any application can record its own session by draining the output of
+// the plug its StreamGfxDevice writes to (see drain_plug() below), or by writing the
+// packages of a GfxStreamWriter to a file.
+//
+// Usage:	gfxstreambench record [--filter name] [--repeat n] file
+//			gfxstreambench replay [--loops n] [--no-chunk-timing] file
+//
+//   record		Renders the gfxdevice_testapp testsuites through a StreamGfxDevice, one frame
+//				per test, and saves the stream to file.
+//
+//   replay		Loads the file into memory and plays it through a GfxStreamPlayer into a
+//				SoftGfxDevice as fast as possible, n times. Reports frames per second,
+//				frame time distribution and time spent per chunk type.
+//
+//				Timing each chunk adds the cost of reading the clock twice per chunk, which is
+//				noticeable on streams with many small chunks. Use --no-chunk-timing to only
+//				time whole frames.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <wondergui.h>
+#include <wg_softgfxdevice.h>
+#include <wg_softsurface.h>
+#include <wg_softsurfacefactory.h>
+#include <wg_streamgfxdevice.h>
+#include <wg_streamsurface.h>
+#include <wg_gfxstreamplug.h>
+#include <wg_gfxstreamreader.h>
+#include <wg_gfxstreamplayer.h>
+
+#include <testsuites/testsuite.h>
+#include <testsuites/filltests.h>
+#include <testsuites/plottests.h>
+#include <testsuites/linetests.h>
+#include <testsuites/canvasformattests.h>
+#include <testsuites/blittests.h>
+#include <testsuites/segmenttests.h>
+#include <testsuites/wavetests.h>
+#include <testsuites/clutblittests.h>
+#include <testsuites/widgettests.h>
+
+using namespace wg;
+using namespace std;
+
+typedef std::chrono::steady_clock	Clock;
+
+const Size			c_canvasSize(512, 512);
+
+//____ now_ns() _______________________________________________________________
+
+static int64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+//____ create_testsuites() ____________________________________________________
+
+vector<TestSuite*> create_testsuites()
+{
+	return {	new FillTests(),
+				new PlotTests(),
+				new LineTests(),
+				new CanvasFormatTests(),
+				new PatchBlitTests(),
+				new SegmentTests(),
+				new WaveTests(),
+				new ClutBlitTests(),
+				new WidgetTests() };
+}
+
+//____ drain_plug() ___________________________________________________________
+//
+// Writes all complete chunks waiting in the stream to file, as header followed by payload.
+
+bool drain_plug(GfxInStream& in, FILE * fp, size_t& bytesWritten)
+{
+	static char	buffer[65536];
+
+	while (!in.isEmpty())
+	{
+		GfxStream::Header header;
+		in >> header;
+
+		if (header.type == GfxChunkId::OutOfData || (int) header.type >= GfxChunkId_size)
+		{
+			printf("Stream is out of sync, a chunk header does not match its content.\n");
+			return false;
+		}
+
+		uint16_t raw[2] = { (uint16_t)header.type, (uint16_t)header.size };
+		in >> GfxStream::DataChunk{ header.size, buffer };
+
+		if (fwrite(raw, sizeof(raw), 1, fp) != 1 || (header.size > 0 && fwrite(buffer, header.size, 1, fp) != 1))
+			return false;
+
+		bytesWritten += sizeof(raw) + header.size;
+	}
+	return true;
+}
+
+//____ record() _______________________________________________________________
+
+int record(const char * pPath, const char * pFilter, int repeat)
+{
+	FILE * fp = fopen(pPath, "wb");
+	if (!fp)
+	{
+		printf("Unable to open '%s' for writing.\n", pPath);
+		return -1;
+	}
+
+	Base::init();
+
+	GfxStreamPlug_p pPlug = GfxStreamPlug::create();
+	pPlug->openOutput(0);
+
+	StreamGfxDevice_p pDevice = StreamGfxDevice::create(c_canvasSize, pPlug->input);
+	StreamSurface_p pCanvas = StreamSurface::create(pPlug->input, c_canvasSize, PixelFormat::BGRA_8);
+	pDevice->setCanvas(pCanvas);
+
+	Rect canvasRect(c_canvasSize);
+
+	vector<TestSuite*> suites = create_testsuites();
+
+	size_t	bytes = 0;
+	int		nFrames = 0;
+	bool	bOk = true;
+
+	for (auto pSuite : suites)
+	{
+		if (!pSuite->init(pDevice, canvasRect))
+		{
+			printf("%s failed to initialize, skipped.\n", pSuite->name.c_str());
+			continue;
+		}
+
+		for (int pass = 0; pass < repeat && bOk; pass++)
+		{
+			for (auto& test : pSuite->tests)
+			{
+				if (pFilter && pSuite->name.find(pFilter) == string::npos && test.name.find(pFilter) == string::npos)
+					continue;
+
+				pDevice->beginRender();
+				pDevice->setClipList(1, &canvasRect);
+				pDevice->setBlendMode(BlendMode::Replace);
+				pDevice->fill(canvasRect, Color::Black);
+				pDevice->setBlendMode(BlendMode::Blend);
+				pDevice->setTintColor(Color::White);
+
+				if (test.init != nullptr)
+					test.init(pDevice, canvasRect);
+
+				test.run(pDevice, canvasRect);
+
+				if (test.exit != nullptr)
+					test.exit(pDevice, canvasRect);
+
+				pDevice->endRender();
+				nFrames++;
+
+				if (!drain_plug(pPlug->output[0], fp, bytes))
+				{
+					bOk = false;
+					break;
+				}
+			}
+		}
+
+		pSuite->exit(pDevice, canvasRect);
+	}
+
+	for (auto pSuite : suites)
+		delete pSuite;
+
+	pCanvas = nullptr;
+	pDevice = nullptr;
+
+	if (bOk)
+		bOk = drain_plug(pPlug->output[0], fp, bytes);		// Catch DeleteSurface chunks.
+
+	pPlug = nullptr;
+	Base::exit();
+
+	if (fclose(fp) != 0 || !bOk)
+	{
+		printf("Failed writing to '%s'.\n", pPath);
+		return -1;
+	}
+
+	printf("Recorded %d frames, %.1f KB to '%s'.\n", nFrames, bytes / 1024.0, pPath);
+	return 0;
+}
+
+//____ load_capture() _________________________________________________________
+//
+// Loads the file and cuts it after the last complete chunk, so a capture from a
+// session that was killed still can be replayed.
+
+bool load_capture(const char * pPath, vector<char>& data)
+{
+	FILE * fp = fopen(pPath, "rb");
+	if (!fp)
+		return false;
+
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	data.resize(size);
+	bool bOk = size == 0 || fread(data.data(), size, 1, fp) == 1;
+	fclose(fp);
+
+	if (!bOk)
+		return false;
+
+	size_t ofs = 0;
+	while (ofs + 4 <= data.size())
+	{
+		uint16_t raw[2];
+		memcpy(raw, &data[ofs], 4);
+
+		if (raw[0] >= GfxChunkId_size || ofs + 4 + raw[1] > data.size())
+			break;
+
+		ofs += 4 + raw[1];
+	}
+
+	if (ofs < data.size())
+		printf("Warning: Capture is truncated or corrupt after %d bytes, ignoring the rest.\n", (int) ofs);
+
+	data.resize(ofs);
+	return true;
+}
+
+//____ percentile() ___________________________________________________________
+
+static double percentile(const vector<int64_t>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+
+	size_t i = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+	return sorted[i] / 1000000.0;
+}
+
+//____ replay() _______________________________________________________________
+
+int replay(const char * pPath, int loops, bool bChunkTiming)
+{
+	vector<char> data;
+	if (!load_capture(pPath, data))
+	{
+		printf("Unable to read '%s'.\n", pPath);
+		return -1;
+	}
+
+	struct ChunkStats
+	{
+		int64_t	count = 0;
+		int64_t	bytes = 0;
+		int64_t	nanoseconds = 0;
+	};
+
+	ChunkStats		chunkStats[GfxChunkId_size];
+	vector<int64_t>	frameTimes;
+	int64_t			totalTime = 0;
+
+	Base::init();
+
+	for (int loop = 0; loop < loops; loop++)
+	{
+		// Start over with a new device and player each loop, so surfaces are
+		// created and uploaded again just like in the recorded session.
+
+		size_t readOfs = 0;
+
+		GfxStreamReader_p pReader = GfxStreamReader::create([&data, &readOfs](int nBytes, void * pDest)
+		{
+			int n = (int) std::min((size_t) nBytes, data.size() - readOfs);
+			memcpy(pDest, data.data() + readOfs, n);
+			readOfs += n;
+			return n;
+		});
+
+		SoftGfxDevice_p pDevice = SoftGfxDevice::create();
+		GfxStreamPlayer_p pPlayer = GfxStreamPlayer::create(pReader->stream, pDevice, pDevice->surfaceFactory());
+
+		int64_t frameStart = 0;
+		int64_t loopStart = now_ns();
+
+		while (!pPlayer->isEmpty())
+		{
+			GfxStream::Header header = pPlayer->peekChunk();
+
+			int64_t before = (bChunkTiming || header.type == GfxChunkId::BeginRender) ? now_ns() : 0;
+
+			pPlayer->playChunk();
+
+			if (bChunkTiming || header.type == GfxChunkId::EndRender)
+			{
+				int64_t after = now_ns();
+
+				ChunkStats& stats = chunkStats[(int) header.type];
+				stats.count++;
+				stats.bytes += header.size + 4;
+				stats.nanoseconds += after - before;
+
+				if (header.type == GfxChunkId::EndRender)
+					frameTimes.push_back(after - frameStart);
+			}
+
+			if (header.type == GfxChunkId::BeginRender)
+				frameStart = before;
+		}
+
+		totalTime += now_ns() - loopStart;
+	}
+
+	Base::exit();
+
+	if (frameTimes.empty())
+	{
+		printf("No frames found in '%s'.\n", pPath);
+		return -1;
+	}
+
+	int64_t frameTimeSum = 0;
+	for (int64_t t : frameTimes)
+		frameTimeSum += t;
+
+	vector<int64_t> sorted = frameTimes;
+	std::sort(sorted.begin(), sorted.end());
+
+	int nFrames = (int) frameTimes.size();
+
+	printf("%s: %d frames in %d loops, %.1f KB of stream data.\n\n", pPath, nFrames, loops, data.size() / 1024.0);
+	printf("Total %.2f ms, frames %.2f ms, %.1f frames/s.\n", totalTime / 1000000.0, frameTimeSum / 1000000.0, nFrames * 1000000000.0 / frameTimeSum);
+	printf("Frame ms: min %.3f, median %.3f, p90 %.3f, p99 %.3f, max %.3f\n", percentile(sorted, 0.0), percentile(sorted, 0.5),
+			percentile(sorted, 0.9), percentile(sorted, 0.99), sorted.back() / 1000000.0);
+
+	if (bChunkTiming)
+	{
+		printf("\n%-24s %10s %12s %12s %12s %7s\n", "Chunk", "Count", "KB", "Total ms", "ns/chunk", "Share");
+
+		int64_t chunkTimeSum = 0;
+		for (auto& stats : chunkStats)
+			chunkTimeSum += stats.nanoseconds;
+
+		for (int i = 0; i < GfxChunkId_size; i++)
+		{
+			ChunkStats& stats = chunkStats[i];
+			if (stats.count == 0)
+				continue;
+
+			printf("%-24s %10lld %12.1f %12.3f %12.0f %6.1f%%\n", toString((GfxChunkId) i), (long long) stats.count,
+					stats.bytes / 1024.0, stats.nanoseconds / 1000000.0, stats.nanoseconds / (double) stats.count,
+					chunkTimeSum > 0 ? stats.nanoseconds * 100.0 / chunkTimeSum : 0.0);
+		}
+	}
+
+	return 0;
+}
+
+//____ main() _________________________________________________________________
+
+int main(int argc, char * argv[])
+{
+	const char *	pMode = argc > 1 ? argv[1] : "";
+	const char *	pPath = nullptr;
+	const char *	pFilter = nullptr;
+	int				repeat = 1;
+	int				loops = 10;
+	bool			bChunkTiming = true;
+	bool			bBadArgs = false;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			pFilter = argv[++i];
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+			repeat = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+			loops = std::max(1, atoi(argv[++i]));
+		else if (strcmp(argv[i], "--no-chunk-timing") == 0)
+			bChunkTiming = false;
+		else if (argv[i][0] != '-' && !pPath)
+			pPath = argv[i];
+		else
+			bBadArgs = true;
+	}
+
+	if (pPath && !bBadArgs)
+	{
+		if (strcmp(pMode, "record") == 0)
+			return record(pPath, pFilter, repeat);
+
+		if (strcmp(pMode, "replay") == 0)
+			return replay(pPath, loops, bChunkTiming);
+	}
+
+	printf("Usage: gfxstreambench record [--filter name] [--repeat n] file\n");
+	printf("       gfxstreambench replay [--loops n] [--no-chunk-timing] file\n");
+	return -1;
+}
@@ -0,0 +1,126 @@
+#include <testsuites/testsuite.h>
+
+#include <wg_rootpanel.h>
+#include <wg_splitpanel.h>
+#include <wg_filler.h>
+#include <wg_colorskin.h>
+#include <wg_flexpanel.h>
+#include <wg_blockskin.h>
+#include <wg_surfaceatlas.h>
+
+// Renders widget trees through a RootPanel, to catch regressions in how containers
+// mask and render their patches.
+
+class WidgetTests : public TestSuite
+{
+public:
+	WidgetTests()
+	{
+		name = "WidgetTests";
+
+		addTest("SplitPanelOpaqueHandle", &WidgetTests::splitPanelOpaqueHandle);
+		addTest("AtlasBlockSkins", &WidgetTests::atlasBlockSkins);
+		addTest("AtlasInterpolatedBlockSkins", &WidgetTests::atlasInterpolatedBlockSkins);
+	}
+
+	// The opaque handle is drawn by the SplitPanel itself and must not be masked
+	// away from its own render, only from what is beneath it.
+
+	bool	splitPanelOpaqueHandle(GfxDevice * pDevice, const Rect& canvas)
+	{
+		auto pFirst = Filler::create();
+		pFirst->setSkin(ColorSkin::create(Color(0, 0, 255)));
+
+		auto pSecond = Filler::create();
+		pSecond->setSkin(ColorSkin::create(Color(0, 255, 0)));
+
+		auto pSplit = SplitPanel::create();
+		pSplit->setOrientation(Orientation::Horizontal);
+		pSplit->setHandleSkin(ColorSkin::create(Color(255, 0, 0)));
+		pSplit->setHandleThickness(16);
+		pSplit->first = pFirst;
+		pSplit->second = pSecond;
+
+		auto pRoot = RootPanel::create(pDevice);
+		pRoot->setGeo(canvas);
+		pRoot->child = pSplit;
+		pRoot->addDirtyPatch(canvas);
+
+		pRoot->renderSection(canvas);
+		return true;
+	}
+
+	// Skins packed into the same atlas page share blit source, so the device should
+	// not see a change of blit source between them.
+
+	bool	atlasBlockSkins(GfxDevice * pDevice, const Rect& canvas)
+	{
+		return renderAtlasBlockSkins(pDevice, canvas, ScaleMode::Nearest, 1);
+	}
+
+	// Interpolated surfaces are packed into pages of their own, which must interpolate
+	// too, without the stretched skins picking up their neighbours in the page.
+
+	bool	atlasInterpolatedBlockSkins(GfxDevice * pDevice, const Rect& canvas)
+	{
+		return renderAtlasBlockSkins(pDevice, canvas, ScaleMode::Interpolate, 2);
+	}
+
+	// Every second surface gets scaleMode, the rest Nearest.
+
+	bool	renderAtlasBlockSkins(GfxDevice * pDevice, const Rect& canvas, ScaleMode scaleMode, int nbPages)
+	{
+		auto pAtlas = SurfaceAtlas::create(pDevice->surfaceFactory(), Size(64, 64));
+
+		Surface_p	surfaces[4];
+		for (int i = 0; i < 4; i++)
+		{
+			surfaces[i] = pDevice->surfaceFactory()->createSurface(Size(16, 16), PixelFormat::BGRA_8);
+			surfaces[i]->setScaleMode(i % 2 == 0 ? scaleMode : ScaleMode::Nearest);
+
+			uint8_t * pPixels = surfaces[i]->lock(AccessMode::WriteOnly);
+			int pitch = surfaces[i]->pitch();
+			for (int y = 0; y < 16; y++)
+			{
+				uint8_t * p = pPixels + y * pitch;
+				for (int x = 0; x < 16; x++)
+				{
+					p[x * 4] = x * 16;
+					p[x * 4 + 1] = y * 16;
+					p[x * 4 + 2] = i * 64;
+					p[x * 4 + 3] = 128 + x * 8;
+				}
+			}
+			surfaces[i]->unlock();
+
+			pAtlas->add(surfaces[i]);
+		}
+
+		if (!pAtlas->pack() || pAtlas->nbPages() != nbPages)
+			return false;
+
+		auto pFlex = FlexPanel::create();
+		pFlex->setSkin(ColorSkin::create(Color(64, 64, 64)));
+
+		int	cellW = canvas.w / 8;
+		int cellH = canvas.h / 4;
+
+		for (int i = 0; i < 32; i++)
+		{
+			auto pSkin = BlockSkin::create(surfaces[i % 4], Rect(0, 0, 16, 16), Border(4));
+			pAtlas->relocate(pSkin);
+
+			auto pFiller = Filler::create();
+			pFiller->setSkin(pSkin);
+			pFlex->children.addMovable(pFiller, Rect((i % 8) * cellW + 2, (i / 8) * cellH + 2, cellW - 4, cellH - 4));
+		}
+
+		auto pRoot = RootPanel::create(pDevice);
+		pRoot->setGeo(canvas);
+		pRoot->child = pFlex;
+		pRoot->addDirtyPatch(canvas);
+
+		pRoot->renderSection(canvas);
+		return true;
+	}
+};
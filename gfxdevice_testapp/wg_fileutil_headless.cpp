@@ -0,0 +1,133 @@
+/*=========================================================================
+
+                         >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+                            -----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// FileUtil without SDL, for headless builds of the testsuites.
+//
+// There is no image decoder available without SDL_image, so loadSurface()
+// generates a deterministic substitute instead of decoding the file. Indexed
+// formats (GIF) give an I8 surface with a CLUT, everything else a BGRA_8
+// surface with varying alpha. Output is the same on every run and platform,
+// which is all the pixel regression tests need.
+
+#include <wg_fileutil.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+namespace wg
+{
+
+	//____ loadBlob() _________________________________________________________
+
+	Blob_p FileUtil::loadBlob(const char * pPath)
+	{
+		FILE * fp = fopen(pPath, "rb");
+		if (!fp)
+			return nullptr;
+
+		fseek(fp, 0, SEEK_END);
+		int size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+
+		Blob_p pBlob = Blob::create(size);
+
+		int nRead = fread(pBlob->data(), 1, size, fp);
+		fclose(fp);
+
+		if (nRead < size)
+			return nullptr;
+
+		return pBlob;
+	}
+
+	//____ loadSurface() ______________________________________________________
+
+	Surface_p FileUtil::loadSurface(const char * pPath, SurfaceFactory * pFactory)
+	{
+		// Seed pattern from the filename so different files look different.
+
+		uint32_t seed = 2166136261u;
+		for (const char * p = pPath; *p; p++)
+			seed = (seed ^ tolower(*p)) * 16777619u;
+
+		const char * pExt = strrchr(pPath, '.');
+		bool bIndexed = pExt && (tolower(pExt[1]) == 'g' && tolower(pExt[2]) == 'i' && tolower(pExt[3]) == 'f');
+
+		Surface_p pSurface;
+
+		if (bIndexed)
+		{
+			Color clut[256];
+			for (int i = 0; i < 256; i++)
+				clut[i] = Color((i * 7 + seed) & 0xFF, (i * 3) & 0xFF, 255 - i, 255);
+
+			Size size(320, 240);
+			pSurface = pFactory->createSurface(size, PixelFormat::I8, SurfaceFlag::Static, clut);
+			if (!pSurface)
+				return nullptr;
+
+			uint8_t * pPixels = pSurface->lock(AccessMode::WriteOnly);
+			int pitch = pSurface->pitch();
+
+			for (int y = 0; y < size.h; y++)
+			{
+				uint8_t * pLine = pPixels + y * pitch;
+				for (int x = 0; x < size.w; x++)
+					pLine[x] = (uint8_t)(((x / 8) ^ (y / 8)) * 16 + (x + y + seed) % 16);
+			}
+			pSurface->unlock();
+		}
+		else
+		{
+			Size size(640, 480);
+			pSurface = pFactory->createSurface(size, PixelFormat::BGRA_8);
+			if (!pSurface)
+				return nullptr;
+
+			uint8_t * pPixels = pSurface->lock(AccessMode::WriteOnly);
+			int pitch = pSurface->pitch();
+			int centerX = size.w / 2;
+			int centerY = size.h / 2;
+
+			for (int y = 0; y < size.h; y++)
+			{
+				uint8_t * p = pPixels + y * pitch;
+				for (int x = 0; x < size.w; x++)
+				{
+					int dx = x - centerX;
+					int dy = y - centerY;
+					int dist2 = dx * dx + dy * dy;
+
+					p[0] = (uint8_t)(x * 255 / size.w);
+					p[1] = (uint8_t)(y * 255 / size.h);
+					p[2] = (uint8_t)(((x / 16) ^ (y / 16) ^ seed) & 1 ? 224 : 32);
+					p[3] = dist2 < 200 * 200 ? 255 : dist2 < 230 * 230 ? (uint8_t)((230 * 230 - dist2) * 255 / (230 * 230 - 200 * 200)) : 0;
+					p += 4;
+				}
+			}
+			pSurface->unlock();
+		}
+
+		return pSurface;
+	}
+}
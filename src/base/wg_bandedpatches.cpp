@@ -0,0 +1,382 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_bandedpatches.h>
+#include <wg_patches.h>
+
+#include <algorithm>
+
+namespace wg
+{
+
+	//____ Constructor _____________________________________________________________
+
+	BandedPatches::BandedPatches() : m_bRectsValid(true)
+	{
+	}
+
+	BandedPatches::BandedPatches( const Patches& source ) : m_bRectsValid(true)
+	{
+		add( source );
+	}
+
+	//____ clear() _________________________________________________________________
+
+	void BandedPatches::clear()
+	{
+		m_bands.clear();
+		m_rects.clear();
+		m_bRectsValid = true;
+	}
+
+	//____ add() ___________________________________________________________________
+
+	void BandedPatches::add( const Rect& rect )
+	{
+		if( rect.w <= 0 || rect.h <= 0 )
+			return;
+
+		int x1 = rect.x;
+		int x2 = rect.x + rect.w;
+		int y2 = rect.y + rect.h;
+
+		int first = _firstBand( rect.y );
+		int i = first;
+		int y = rect.y;
+
+		while( y < y2 )
+		{
+			if( i == (int) m_bands.size() || m_bands[i].y1 >= y2 )
+			{
+				_insertBand( i++, y, y2, x1, x2 );								// Rest of rect is below any band.
+				break;
+			}
+
+			if( m_bands[i].y1 > y )
+			{
+				int gapEnd = m_bands[i].y1;
+				_insertBand( i++, y, gapEnd, x1, x2 );							// Fill gap above band.
+				y = gapEnd;
+				continue;
+			}
+
+			if( m_bands[i].y1 < y )
+			{
+				_splitBand( i++, y );											// Band starts above rect.
+				continue;
+			}
+
+			if( m_bands[i].y2 > y2 )
+				_splitBand( i, y2 );											// Band ends below rect.
+
+			_addSpan( m_bands[i].spans, x1, x2 );
+			y = m_bands[i].y2;
+			i++;
+		}
+
+		_coalesce( first - 1, i );
+		m_bRectsValid = false;
+	}
+
+	void BandedPatches::add( const BandedPatches& source )
+	{
+		for( auto& band : source.m_bands )
+			for( auto& span : band.spans )
+				add( Rect( span.x1, band.y1, span.x2 - span.x1, band.y2 - band.y1 ) );
+	}
+
+	void BandedPatches::add( const Patches& source )
+	{
+		for( const Rect * pRect = source.begin() ; pRect != source.end() ; pRect++ )
+			add( *pRect );
+	}
+
+	//____ sub() ___________________________________________________________________
+
+	void BandedPatches::sub( const Rect& rect )
+	{
+		if( rect.w <= 0 || rect.h <= 0 )
+			return;
+
+		int x1 = rect.x;
+		int x2 = rect.x + rect.w;
+		int y2 = rect.y + rect.h;
+
+		int first = _firstBand( rect.y );
+		int i = first;
+
+		while( i < (int) m_bands.size() && m_bands[i].y1 < y2 )
+		{
+			std::vector<Span>& spans = m_bands[i].spans;
+
+			// Leave bands untouched, and unsplit, if rect misses their spans.
+
+			int s = _firstSpan( spans, x1 );
+			if( s == (int) spans.size() || spans[s].x1 >= x2 )
+			{
+				i++;
+				continue;
+			}
+
+			if( m_bands[i].y1 < rect.y )
+			{
+				_splitBand( i++, rect.y );
+				continue;
+			}
+
+			if( m_bands[i].y2 > y2 )
+				_splitBand( i, y2 );
+
+			_subSpan( m_bands[i].spans, x1, x2 );
+
+			if( m_bands[i].spans.empty() )
+				m_bands.erase( m_bands.begin() + i );
+			else
+				i++;
+		}
+
+		_coalesce( first - 1, i );
+		m_bRectsValid = false;
+	}
+
+	void BandedPatches::sub( const BandedPatches& source )
+	{
+		for( auto& band : source.m_bands )
+			for( auto& span : band.spans )
+				sub( Rect( span.x1, band.y1, span.x2 - span.x1, band.y2 - band.y1 ) );
+	}
+
+	//____ swap() __________________________________________________________________
+
+	void BandedPatches::swap( BandedPatches& other )
+	{
+		m_bands.swap( other.m_bands );
+		m_rects.swap( other.m_rects );
+		std::swap( m_bRectsValid, other.m_bRectsValid );
+	}
+
+	//____ clip() __________________________________________________________________
+
+	void BandedPatches::clip( const Rect& clip )
+	{
+		int x1 = clip.x;
+		int x2 = clip.x + clip.w;
+		int y1 = clip.y;
+		int y2 = clip.y + clip.h;
+
+		if( clip.w <= 0 || clip.h <= 0 )
+		{
+			clear();
+			return;
+		}
+
+		// Remove bands outside clip vertically and trim the ones on the edges.
+
+		int first = _firstBand( y1 );
+		int last = first;
+		while( last < (int) m_bands.size() && m_bands[last].y1 < y2 )
+			last++;
+
+		m_bands.erase( m_bands.begin() + last, m_bands.end() );
+		m_bands.erase( m_bands.begin(), m_bands.begin() + first );
+
+		if( m_bands.empty() )
+		{
+			m_bRectsValid = false;
+			return;
+		}
+
+		m_bands.front().y1 = std::max( m_bands.front().y1, y1 );
+		m_bands.back().y2 = std::min( m_bands.back().y2, y2 );
+
+		// Trim spans of all remaining bands horizontally.
+
+		for( int i = 0 ; i < (int) m_bands.size() ; )
+		{
+			std::vector<Span>& spans = m_bands[i].spans;
+
+			int s1 = _firstSpan( spans, x1 );
+			int s2 = s1;
+			while( s2 < (int) spans.size() && spans[s2].x1 < x2 )
+				s2++;
+
+			spans.erase( spans.begin() + s2, spans.end() );
+			spans.erase( spans.begin(), spans.begin() + s1 );
+
+			if( spans.empty() )
+				m_bands.erase( m_bands.begin() + i );
+			else
+			{
+				spans.front().x1 = std::max( spans.front().x1, x1 );
+				spans.back().x2 = std::min( spans.back().x2, x2 );
+				i++;
+			}
+		}
+
+		_coalesce( 0, (int) m_bands.size() );
+		m_bRectsValid = false;
+	}
+
+	//____ getUnion() ______________________________________________________________
+
+	Rect BandedPatches::getUnion() const
+	{
+		if( m_bands.empty() )
+			return Rect();
+
+		int x1 = m_bands.front().spans.front().x1;
+		int x2 = m_bands.front().spans.back().x2;
+
+		for( auto& band : m_bands )
+		{
+			x1 = std::min( x1, band.spans.front().x1 );
+			x2 = std::max( x2, band.spans.back().x2 );
+		}
+
+		return Rect( x1, m_bands.front().y1, x2 - x1, m_bands.back().y2 - m_bands.front().y1 );
+	}
+
+	//____ _firstBand() ____________________________________________________________
+	// Index of first band ending below y.
+
+	int BandedPatches::_firstBand( int y ) const
+	{
+		auto it = std::upper_bound( m_bands.begin(), m_bands.end(), y, []( int y, const Band& band ) { return y < band.y2; } );
+		return int(it - m_bands.begin());
+	}
+
+	//____ _splitBand() ____________________________________________________________
+
+	void BandedPatches::_splitBand( int index, int y )
+	{
+		m_bands.insert( m_bands.begin() + index + 1, m_bands[index] );
+		m_bands[index].y2 = y;
+		m_bands[index+1].y1 = y;
+	}
+
+	//____ _insertBand() ___________________________________________________________
+
+	void BandedPatches::_insertBand( int index, int y1, int y2, int x1, int x2 )
+	{
+		Band band;
+		band.y1 = y1;
+		band.y2 = y2;
+		band.spans.push_back( { x1, x2 } );
+
+		m_bands.insert( m_bands.begin() + index, std::move(band) );
+	}
+
+	//____ _coalesce() _____________________________________________________________
+	// Joins touching bands with identical spans from first up to and including last.
+
+	void BandedPatches::_coalesce( int first, int last )
+	{
+		int i = std::max( first, 0 ) + 1;
+		last = std::min( last, (int) m_bands.size() - 1 );
+
+		while( i <= last )
+		{
+			Band& above = m_bands[i-1];
+			Band& band = m_bands[i];
+
+			if( above.y2 == band.y1 && above.spans == band.spans )
+			{
+				above.y2 = band.y2;
+				m_bands.erase( m_bands.begin() + i );
+				last--;
+			}
+			else
+				i++;
+		}
+	}
+
+	//____ _firstSpan() ____________________________________________________________
+	// Index of first span ending right of x.
+
+	int BandedPatches::_firstSpan( const std::vector<Span>& spans, int x )
+	{
+		auto it = std::upper_bound( spans.begin(), spans.end(), x, []( int x, const Span& span ) { return x < span.x2; } );
+		return int(it - spans.begin());
+	}
+
+	//____ _addSpan() ______________________________________________________________
+
+	void BandedPatches::_addSpan( std::vector<Span>& spans, int x1, int x2 )
+	{
+		// Find range of spans overlapping or touching the new one.
+
+		auto first = std::lower_bound( spans.begin(), spans.end(), x1, []( const Span& span, int x ) { return span.x2 < x; } );
+		auto last = first;
+		while( last != spans.end() && last->x1 <= x2 )
+			last++;
+
+		if( first == last )
+		{
+			spans.insert( first, { x1, x2 } );
+			return;
+		}
+
+		first->x1 = std::min( first->x1, x1 );
+		first->x2 = std::max( (last-1)->x2, x2 );
+		spans.erase( first + 1, last );
+	}
+
+	//____ _subSpan() ______________________________________________________________
+
+	bool BandedPatches::_subSpan( std::vector<Span>& spans, int x1, int x2 )
+	{
+		int first = _firstSpan( spans, x1 );
+		int last = first;
+		while( last < (int) spans.size() && spans[last].x1 < x2 )
+			last++;
+
+		if( first == last )
+			return false;
+
+		Span	remains[2];
+		int		nRemains = 0;
+
+		if( spans[first].x1 < x1 )
+			remains[nRemains++] = { spans[first].x1, x1 };
+
+		if( spans[last-1].x2 > x2 )
+			remains[nRemains++] = { x2, spans[last-1].x2 };
+
+		spans.erase( spans.begin() + first, spans.begin() + last );
+		spans.insert( spans.begin() + first, remains, remains + nRemains );
+		return true;
+	}
+
+	//____ _buildRects() ___________________________________________________________
+
+	void BandedPatches::_buildRects() const
+	{
+		m_rects.clear();
+
+		for( auto& band : m_bands )
+			for( auto& span : band.spans )
+				m_rects.push_back( Rect( span.x1, band.y1, span.x2 - span.x1, band.y2 - band.y1 ) );
+
+		m_bRectsValid = true;
+	}
+
+} // namespace wg
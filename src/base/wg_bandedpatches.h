@@ -0,0 +1,126 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_BANDEDPATCHES_DOT_H
+#define WG_BANDEDPATCHES_DOT_H
+#pragma once
+
+#include <vector>
+
+#include <wg_geo.h>
+
+namespace wg
+{
+	class Patches;
+
+	//____ BandedPatches ______________________________________________________
+	/**
+	 * @brief	Set of non-overlapping rectangles stored as horizontal bands.
+	 *
+	 * BandedPatches covers the same need as Patches, but keeps its area as a list
+	 * of bands sorted from top to bottom, each band holding the sorted horizontal spans
+	 * covered within it. Bands and spans are found through binary search, so adding,
+	 * subtracting and trimming only touches the bands and spans affected instead of
+	 * testing against every rectangle. Use it instead of Patches when the number of
+	 * rectangles can grow large.
+	 *
+	 * Neighbouring bands with identical spans are joined and touching spans are merged,
+	 * so the same area always gives the same set of rectangles.
+	 *
+	 * The rectangles are made available as a flat array, sorted top to bottom and left to
+	 * right, which can be handed directly to GfxDevice::setClipList(). The array is rebuilt
+	 * on first access after a modification.
+	 */
+
+	class BandedPatches
+	{
+		friend class Patches;
+	public:
+
+		//.____ Creation ______________________________________________________
+
+		BandedPatches();
+		BandedPatches( const Patches& source );
+
+		//.____ Control ________________________________________________________
+
+		void			clear();
+
+		void			add( const Rect& rect );
+		void			add( const BandedPatches& source );
+		void			add( const Patches& source );
+
+		void			sub( const Rect& rect );
+		void			sub( const BandedPatches& source );
+
+		void			swap( BandedPatches& other );
+
+		//.____ Misc __________________________________________________________
+
+		void			clip( const Rect& clip );
+		Rect			getUnion() const;
+
+		//.____ Content ________________________________________________________
+
+		const Rect *	begin() const { _updateRects(); return m_rects.data(); }
+		const Rect *	end() const { _updateRects(); return m_rects.data() + m_rects.size(); }
+		int				size() const { _updateRects(); return (int) m_rects.size(); }
+		bool			isEmpty() const { return m_bands.empty(); }
+
+		int				bands() const { return (int) m_bands.size(); }
+
+	private:
+
+		struct Span
+		{
+			int		x1;
+			int		x2;
+
+			bool	operator==( const Span& other ) const { return x1 == other.x1 && x2 == other.x2; }
+		};
+
+		struct Band
+		{
+			int					y1;
+			int					y2;
+			std::vector<Span>	spans;
+		};
+
+		int			_firstBand( int y ) const;
+		void		_splitBand( int index, int y );
+		void		_insertBand( int index, int y1, int y2, int x1, int x2 );
+		void		_coalesce( int first, int last );
+
+		static void	_addSpan( std::vector<Span>& spans, int x1, int x2 );
+		static bool	_subSpan( std::vector<Span>& spans, int x1, int x2 );
+		static int	_firstSpan( const std::vector<Span>& spans, int x );
+
+		void		_updateRects() const { if( !m_bRectsValid ) _buildRects(); }
+		void		_buildRects() const;
+
+		std::vector<Band>			m_bands;
+
+		mutable std::vector<Rect>	m_rects;
+		mutable bool				m_bRectsValid;
+	};
+
+} // namespace wg
+#endif //WG_BANDEDPATCHES_DOT_H
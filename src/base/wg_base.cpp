@@ -30,6 +30,7 @@
 #include <wg_mempool.h>
 #include <wg_standardformatter.h>
 #include <wg_inputhandler.h>
+#include <wg_scheduler.h>
 
 
 namespace wg
@@ -60,8 +61,13 @@ namespace wg
 		s_pData->pDefaultValueFormatter = StandardFormatter::create();
 
 		s_pData->pMsgRouter = MsgRouter::create();
+		s_pData->pScheduler = Scheduler::create();
 		s_pData->pInputHandler = InputHandler::create();
 
+		// Hosts posting TickMsgs instead of ticking the scheduler directly.
+
+		s_pData->pMsgRouter->addRoute( MsgType::Tick, [](Msg * pMsg) { s_pData->pScheduler->tick( static_cast<TickMsg*>(pMsg)->timestamp() ); } );
+
 		s_pData->pDefaultStyle = TextStyle::create();
 		s_pData->pDefaultStyle->setFont( DummyFont::create() );
 
@@ -111,6 +117,20 @@ namespace wg
 		return s_pData->pInputHandler;
 	}
 
+	//____ scheduler() _________________________________________________________
+	/**
+	 * @brief Get the scheduler driving all timed updates.
+	 *
+	 * The host should call tick() on the scheduler once per frame with a
+	 * millisecond timestamp. Posting a TickMsg to the msgRouter does the same thing
+	 * when the message is dispatched, but has the overhead of a message.
+	 */
+
+	Scheduler_p Base::scheduler()
+	{
+		return s_pData->pScheduler;
+	}
+
 
 
 	//____ _allocWeakPtrHub() ______________________________________________________
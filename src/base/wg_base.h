@@ -45,6 +45,7 @@ namespace wg
 	class MsgRouter;
 	class ValueFormatter;
 	class InputHandler;
+	class Scheduler;
 	class TextMapper;
 	class Caret;
 	class TextStyle;
@@ -52,6 +53,7 @@ namespace wg
 	typedef	StrongPtr<MsgRouter>		MsgRouter_p;
 	typedef	StrongPtr<ValueFormatter>	ValueFormatter_p;
 	typedef	StrongPtr<InputHandler>		InputHandler_p;
+	typedef	StrongPtr<Scheduler>		Scheduler_p;
 	typedef	StrongPtr<TextMapper>		TextMapper_p;
 	typedef	StrongPtr<Caret>			Caret_p;
 	typedef	StrongPtr<TextStyle>		TextStyle_p;
@@ -84,6 +86,7 @@ namespace wg
 
 		static MsgRouter_p	msgRouter();
 		static InputHandler_p	inputHandler();
+		static Scheduler_p	scheduler();
 
 		static void			setDefaultTextMapper( TextMapper * pTextMapper );
 		static TextMapper_p defaultTextMapper();
@@ -111,6 +114,7 @@ namespace wg
 		struct Data
 		{
 			MsgRouter_p		pMsgRouter;
+			Scheduler_p		pScheduler;
 			InputHandler_p	pInputHandler;
 
 
@@ -948,7 +948,7 @@ namespace wg
 					// Move both beginning and end to make space
 
 					_copyChars( m_pHead, 0, m_pHead, m_pHead->m_beg, ofs );
-					_copyChars( m_pHead, ofs+addSpace, m_pHead, m_pHead->m_beg+ofs+delChar, sizeChange - begBuffer +1 );
+					_copyChars( m_pHead, ofs+addSpace, m_pHead, m_pHead->m_beg+ofs+delChar, m_pHead->m_len-ofs-delChar+1 );
 					m_pHead->m_beg = 0;
 				}
 
@@ -1095,7 +1095,7 @@ namespace wg
 		if( ofs < 0 || len <= 0 || ofs >= m_pHead->m_len )
 			return;
 
-		if( ofs + len > m_pHead->m_len )
+		if( len > m_pHead->m_len - ofs )
 			len = m_pHead->m_len - ofs;
 
 		if( m_pHead->m_refCnt > 1 )
@@ -1120,7 +1120,7 @@ namespace wg
 		if( ofs < 0 || len <= 0 || ofs >= m_pHead->m_len )
 			return;
 
-		if( ofs + len > m_pHead->m_len )
+		if( len > m_pHead->m_len - ofs )
 			len = m_pHead->m_len - ofs;
 
 		if( m_pHead->m_refCnt > 1 )
@@ -1146,7 +1146,7 @@ namespace wg
 		if( ofs < 0 || len <= 0 || ofs >= m_pHead->m_len )
 			return;
 
-		if( ofs + len > m_pHead->m_len )
+		if( len > m_pHead->m_len - ofs )
 			len = m_pHead->m_len - ofs;
 
 		if( m_pHead->m_refCnt > 1 )
@@ -1169,7 +1169,7 @@ namespace wg
 		if( ofs < 0 || len <= 0 || ofs >= m_pHead->m_len )
 			return;
 
-		if( ofs + len > m_pHead->m_len )
+		if( len > m_pHead->m_len - ofs )
 			len = m_pHead->m_len - ofs;
 
 		if( m_pHead->m_refCnt > 1 )
@@ -0,0 +1,1029 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <memory.h>
+#include <string.h>
+#include <algorithm>
+
+#include <wg_chunkedcharbuffer.h>
+#include <wg_charseq.h>
+#include <wg_texttool.h>
+
+namespace wg
+{
+
+	const int	ChunkedCharBuffer::c_chunkCapacity;
+	const uint32_t	ChunkedCharBuffer::c_emptyChar;
+
+	int			ChunkedCharBuffer::s_nChunks = 0;
+	uint32_t	ChunkedCharBuffer::s_randomSeed = 0x9E3779B9;
+
+
+	//____ Constructor() ___________________________________________________________
+
+	ChunkedCharBuffer::ChunkedCharBuffer() : m_pRoot(nullptr), m_pFlat(nullptr)
+	{
+	}
+
+	/// @brief Creates a copy of another ChunkedCharBuffer.
+	///
+	/// No characters are copied, the new buffer shares all chunks with the original
+	/// until one of them is modified.
+
+	ChunkedCharBuffer::ChunkedCharBuffer( const ChunkedCharBuffer& r ) : m_pRoot(r.m_pRoot), m_pFlat(nullptr)
+	{
+		if( m_pRoot )
+			m_pRoot->refCnt++;
+	}
+
+	/// @brief Creates a buffer filled with the content of a character sequence.
+
+	ChunkedCharBuffer::ChunkedCharBuffer( const CharSeq& seq ) : m_pRoot(nullptr), m_pFlat(nullptr)
+	{
+		pushBack( seq );
+	}
+
+	//____ Destructor ______________________________________________________________
+
+	ChunkedCharBuffer::~ChunkedCharBuffer()
+	{
+		_clearFlat();
+		_release( m_pRoot );
+	}
+
+	//____ operator=() _____________________________________________________________
+
+	ChunkedCharBuffer& ChunkedCharBuffer::operator=( ChunkedCharBuffer const & r )
+	{
+		if( m_pRoot != r.m_pRoot )
+		{
+			if( r.m_pRoot )
+				r.m_pRoot->refCnt++;
+
+			_clearFlat();
+			_release( m_pRoot );
+			m_pRoot = r.m_pRoot;
+		}
+		return *this;
+	}
+
+	ChunkedCharBuffer& ChunkedCharBuffer::operator=( CharSeq const & seq )
+	{
+		reset();
+		pushBack( seq );
+		return *this;
+	}
+
+	//____ operator==() ____________________________________________________________
+
+	bool ChunkedCharBuffer::operator==( const ChunkedCharBuffer& other ) const
+	{
+		if( m_pRoot == other.m_pRoot )
+			return true;
+
+		int len = nbChars();
+		if( len != other.nbChars() )
+			return false;
+
+		int ofs = 0;
+		while( ofs < len )
+		{
+			int ofs1 = ofs;
+			int ofs2 = ofs;
+			const Chunk * p1 = _find( m_pRoot, ofs1, false );
+			const Chunk * p2 = _find( other.m_pRoot, ofs2, false );
+
+			int n = std::min( p1->nChars - ofs1, p2->nChars - ofs2 );
+
+			if( p1 != p2 && memcmp( p1->chars + ofs1, p2->chars + ofs2, n*sizeof(uint32_t) ) != 0 )
+				return false;
+
+			ofs += n;
+		}
+		return true;
+	}
+
+	//____ operator[]() ____________________________________________________________
+	//
+	/// @brief Gets a character from the buffer.
+	///
+	/// Unlike for CharBuffer this is an O(log n) operation, so use copyTo() to read
+	/// longer runs of characters.
+	///
+	/// @return Reference to the character at the specified offset or an empty character
+	///			if offset is out of range.
+
+	const Char& ChunkedCharBuffer::operator[]( int i ) const
+	{
+		static Char	s_emptyChar;
+
+		if( i < 0 || i >= nbChars() )
+			return s_emptyChar;
+
+		const Chunk * p = _find( m_pRoot, i, false );
+		return ((const Char*)p->chars)[i];
+	}
+
+	//____ reset() _________________________________________________________________
+	//
+	/// @brief Deletes all content.
+
+	void ChunkedCharBuffer::reset()
+	{
+		_clearFlat();
+		_release( m_pRoot );
+		m_pRoot = nullptr;
+	}
+
+	//____ pushFront() _____________________________________________________________
+	//
+	/// @brief Grows the content by pushing whitespace to the front.
+	///
+	/// @return Number of characters the content was grown with. Always equals nChars.
+
+	int ChunkedCharBuffer::pushFront( int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( 0, 0, nChars );
+	}
+
+	/// @brief Grows the content by pushing a character to the front.
+	///
+	/// @return Number of characters the content was grown with. Always 1.
+
+	int ChunkedCharBuffer::pushFront( const Char& character )
+	{
+		return _replace( 0, 0, 1, &character );
+	}
+
+	/// @brief Grows the content by pushing a null-terminated string of characters to the front.
+	///
+	/// @return Number of characters the content was grown with.
+
+	int ChunkedCharBuffer::pushFront( const Char * pChars )
+	{
+		return _replace( 0, 0, TextTool::strlen( pChars ), pChars );
+	}
+
+	/// @brief Grows the content by pushing a specified number of characters to the front.
+	///
+	/// @return Number of characters the content was grown with. Always equals nChars.
+
+	int ChunkedCharBuffer::pushFront( const Char * pChars, int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( 0, 0, nChars, pChars );
+	}
+
+	/// @brief Grows the content by pushing the content of a character sequence to the front.
+	///
+	/// @return Number of characters the content was grown with. Always equals length of sequence.
+
+	int ChunkedCharBuffer::pushFront( const CharSeq& seq )
+	{
+		const CharSeq::CharBasket basket = seq.getChars();
+		return _replace( 0, 0, basket.length, basket.ptr );
+	}
+
+	//____ popFront() ______________________________________________________________
+	//
+	/// @brief Removes characters from the front of the content.
+	///
+	/// @return Number of characters removed.
+
+	int ChunkedCharBuffer::popFront( int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return 0 - _replace( 0, nChars, 0 );
+	}
+
+	//____ pushBack() ______________________________________________________________
+	//
+	/// @brief Grows the content by pushing whitespace to the back.
+	///
+	/// @return Number of characters the content was grown with. Always equals nChars.
+
+	int ChunkedCharBuffer::pushBack( int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( nbChars(), 0, nChars );
+	}
+
+	/// @brief Grows the content by pushing a character to the back.
+	///
+	/// @return Number of characters the content was grown with. Always 1.
+
+	int ChunkedCharBuffer::pushBack( const Char& character )
+	{
+		return _replace( nbChars(), 0, 1, &character );
+	}
+
+	/// @brief Grows the content by pushing a null-terminated string of characters to the back.
+	///
+	/// @return Number of characters the content was grown with.
+
+	int ChunkedCharBuffer::pushBack( const Char * pChars )
+	{
+		return _replace( nbChars(), 0, TextTool::strlen( pChars ), pChars );
+	}
+
+	/// @brief Grows the content by pushing a specified number of characters to the back.
+	///
+	/// @return Number of characters the content was grown with. Always equals nChars.
+
+	int ChunkedCharBuffer::pushBack( const Char * pChars, int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( nbChars(), 0, nChars, pChars );
+	}
+
+	/// @brief Grows the content by pushing the content of a character sequence to the back.
+	///
+	/// @return Number of characters the content was grown with. Always equals length of sequence.
+
+	int ChunkedCharBuffer::pushBack( const CharSeq& seq )
+	{
+		const CharSeq::CharBasket basket = seq.getChars();
+		return _replace( nbChars(), 0, basket.length, basket.ptr );
+	}
+
+	//____ popBack() _______________________________________________________________
+	//
+	/// @brief Removes characters from the back of the content.
+	///
+	/// @return Number of characters removed.
+
+	int ChunkedCharBuffer::popBack( int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		if( nChars > nbChars() )
+			nChars = nbChars();
+
+		return 0 - _replace( nbChars() - nChars, nChars, 0 );
+	}
+
+	//____ insert() ________________________________________________________________
+	//
+	/// @brief Inserts whitespace characters.
+	///
+	/// If ofs is larger than number of characters in buffer the whitespaces are pushed on the back.
+	///
+	/// @return Number of characters that have been inserted. Always equals nChars.
+
+	int ChunkedCharBuffer::insert( int ofs, int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( ofs, 0, nChars );
+	}
+
+	/// @brief Inserts a character.
+	///
+	/// @return Number of characters that have been inserted. Always 1.
+
+	int ChunkedCharBuffer::insert( int ofs, const Char& character )
+	{
+		return _replace( ofs, 0, 1, &character );
+	}
+
+	/// @brief Inserts a null-terminated string of characters.
+	///
+	/// @return Number of characters that have been inserted.
+
+	int ChunkedCharBuffer::insert( int ofs, const Char * pChars )
+	{
+		return _replace( ofs, 0, TextTool::strlen( pChars ), pChars );
+	}
+
+	/// @brief Inserts a specified number of characters.
+	///
+	/// @return Number of characters that have been inserted. Always equals nChars.
+
+	int ChunkedCharBuffer::insert( int ofs, const Char * pChars, int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return _replace( ofs, 0, nChars, pChars );
+	}
+
+	/// @brief Inserts characters from a character sequence.
+	///
+	/// @return Number of characters that have been inserted. Always equals length of sequence.
+
+	int ChunkedCharBuffer::insert( int ofs, const CharSeq& seq )
+	{
+		const CharSeq::CharBasket basket = seq.getChars();
+		return _replace( ofs, 0, basket.length, basket.ptr );
+	}
+
+	//____ remove() ________________________________________________________________
+	//
+	/// @brief Removes characters from the buffer.
+	///
+	/// @return Number of characters removed.
+
+	int ChunkedCharBuffer::remove( int ofs, int nChars )
+	{
+		if( nChars <= 0 )
+			return 0;
+
+		return 0 - _replace( ofs, nChars, 0 );
+	}
+
+	//____ replace() _______________________________________________________________
+	//
+	/// @brief Replace a character.
+	///
+	/// If ofs is larger than number of characters then character is pushed on the back of the buffer instead.
+	///
+	/// @return Change in number of characters in buffer.
+
+	int ChunkedCharBuffer::replace( int ofs, const Char& character )
+	{
+		if( ofs < 0 )
+			return 0;
+
+		if( ofs >= nbChars() )
+			return pushBack( character );
+
+		_clearFlat();
+		_modify( m_pRoot, ofs, 1, [&character]( Char * p, int n ) { * p = character; } );
+		return 0;
+	}
+
+	/// @brief Replace specified number of characters with (another number of) whitespaces.
+	///
+	/// @return Change in number of characters in buffer.
+
+	int ChunkedCharBuffer::replace( int ofs, int nDelete, int nInsert )
+	{
+		return _replace( ofs, nDelete, nInsert );
+	}
+
+	/// @brief Replace specified number of characters with a null-terminated string.
+	///
+	/// @return Change in number of characters in buffer.
+
+	int ChunkedCharBuffer::replace( int ofs, int nDelete, const Char * pChars )
+	{
+		return _replace( ofs, nDelete, TextTool::strlen( pChars ), pChars );
+	}
+
+	/// @brief Replace specified number of characters with a string of specified length.
+	///
+	/// @return Change in number of characters in buffer.
+
+	int ChunkedCharBuffer::replace( int ofs, int nDelete, const Char * pChars, int nInsert )
+	{
+		return _replace( ofs, nDelete, nInsert, pChars );
+	}
+
+	/// @brief Replace specified number of characters with content of a char sequence.
+	///
+	/// @return Change in number of characters in buffer.
+
+	int ChunkedCharBuffer::replace( int ofs, int nDelete, const CharSeq& seq )
+	{
+		const CharSeq::CharBasket basket = seq.getChars();
+		return _replace( ofs, nDelete, basket.length, basket.ptr );
+	}
+
+	//____ chars() _________________________________________________________________
+	//
+	/// @brief Gets all content as one null-terminated array of characters.
+	///
+	/// The array is created on first call after a modification and is kept until
+	/// the next modification, so calling this is expensive for a large buffer that
+	/// is frequently modified.
+	///
+	/// @return Pointer at the characters. The pointer is only valid until the
+	///			buffer is modified or destroyed.
+
+	const Char * ChunkedCharBuffer::chars() const
+	{
+		if( !m_pFlat )
+		{
+			int len = nbChars();
+			uint32_t * p = new uint32_t[len+1];
+			_copyOut( m_pRoot, 0, len, (Char*) p );
+			p[len] = 0;
+			m_pFlat = (Char*) p;
+		}
+		return m_pFlat;
+	}
+
+	//____ copyTo() ________________________________________________________________
+	//
+	/// @brief Copies characters from the buffer.
+	///
+	/// @param pDest	Destination for the characters. Must have space for len characters.
+	/// @param ofs		Offset of first character to copy.
+	/// @param len		Number of characters to copy.
+	///
+	/// @return Number of characters copied.
+
+	int ChunkedCharBuffer::copyTo( Char * pDest, int ofs, int len ) const
+	{
+		if( ofs < 0 || len <= 0 || ofs >= nbChars() )
+			return 0;
+
+		if( len > nbChars() - ofs )
+			len = nbChars() - ofs;
+
+		_copyOut( m_pRoot, ofs, len, pDest );
+		TextTool::refStyle( pDest, len );
+		return len;
+	}
+
+	//____ fill() __________________________________________________________________
+	//
+	/// @brief Fills a range of the buffer with the specified character.
+
+	void ChunkedCharBuffer::fill( const Char& ch, int ofs, int len )
+	{
+		_clearFlat();
+		_modify( m_pRoot, ofs, len, [&ch]( Char * p, int n ) { TextTool::setChars( ch, p, n ); } );
+	}
+
+	//____ setCharCodes() __________________________________________________________
+	//
+	/// @brief Sets the charcode for a range of characters, leaving their styles intact.
+
+	void ChunkedCharBuffer::setCharCodes( uint16_t charCode, int ofs, int len )
+	{
+		_clearFlat();
+		_modify( m_pRoot, ofs, len, [charCode]( Char * p, int n ) { TextTool::setCharCode( charCode, p, n ); } );
+	}
+
+	//____ setStyle() ______________________________________________________________
+	//
+	/// @brief Sets the style for a range of characters.
+
+	void ChunkedCharBuffer::setStyle( TextStyle * pStyle, int ofs, int len )
+	{
+		_clearFlat();
+		_modify( m_pRoot, ofs, len, [pStyle]( Char * p, int n ) { TextTool::setStyle( pStyle, p, n ); } );
+	}
+
+	//____ clearStyle() ____________________________________________________________
+	//
+	/// @brief Clears the style for a range of characters.
+
+	void ChunkedCharBuffer::clearStyle( int ofs, int len )
+	{
+		_clearFlat();
+		_modify( m_pRoot, ofs, len, []( Char * p, int n ) { TextTool::clearStyle( p, n ); } );
+	}
+
+	//____ findFirst() _____________________________________________________________
+	//
+	/// @brief Finds the first occurence of a charcode.
+	///
+	/// @return Offset of the character or -1 if not found.
+
+	int ChunkedCharBuffer::findFirst( uint16_t character, int ofs ) const
+	{
+		if( ofs < 0 )
+			ofs = 0;
+
+		int len = nbChars();
+		while( ofs < len )
+		{
+			int chunkOfs = ofs;
+			const Chunk * p = _find( m_pRoot, chunkOfs, false );
+			const Char * pChars = (const Char*) p->chars;
+
+			for( int i = chunkOfs ; i < p->nChars ; i++ )
+			{
+				if( pChars[i].code() == character )
+					return ofs + i - chunkOfs;
+			}
+
+			ofs += p->nChars - chunkOfs;
+		}
+		return -1;
+	}
+
+	//____ nbChunks() ______________________________________________________________
+	//
+	/// @brief Gets the number of chunks the content is spread over.
+
+	int ChunkedCharBuffer::nbChunks() const
+	{
+		return _countChunks( m_pRoot );
+	}
+
+	//____ _replace() ______________________________________________________________
+
+	int ChunkedCharBuffer::_replace( int ofs, int nDelete, int nInsert, const Char * pChars )
+	{
+		int len = nbChars();
+
+		if( ofs < 0 )
+			ofs = 0;
+		if( ofs > len )
+			ofs = len;
+		if( nDelete < 0 )
+			nDelete = 0;
+		if( nDelete > len - ofs )
+			nDelete = len - ofs;
+		if( nInsert < 0 )
+			nInsert = 0;
+
+		if( nDelete == 0 && nInsert == 0 )
+			return 0;
+
+		_clearFlat();
+
+		if( nDelete > 0 )
+			_remove( ofs, nDelete );
+
+		if( nInsert > 0 )
+			_insert( ofs, nInsert, pChars );
+
+		return nInsert - nDelete;
+	}
+
+	//____ _remove() _______________________________________________________________
+
+	void ChunkedCharBuffer::_remove( int ofs, int nChars )
+	{
+		// Remove in place if all characters are in the same chunk and some remains.
+
+		int chunkOfs = ofs;
+		const Chunk * pFound = _find( m_pRoot, chunkOfs, false );
+
+		if( chunkOfs + nChars <= pFound->nChars && nChars < pFound->nChars )
+		{
+			Chunk * p = _ownPathTo( m_pRoot, ofs, false, -nChars );
+			Char * pChars = _chars(p);
+
+			TextTool::derefStyle( pChars + ofs, nChars );
+			memmove( pChars + ofs, pChars + ofs + nChars, (p->nChars - ofs - nChars)*sizeof(uint32_t) );
+			p->nChars -= nChars;
+			return;
+		}
+
+		// Cut out the range and join what's left.
+
+		Chunk * pLeft, * pMiddle, * pRight, * pRest;
+
+		_split( m_pRoot, ofs, pLeft, pRest );
+		_split( pRest, nChars, pMiddle, pRight );
+		_release( pMiddle );
+		m_pRoot = _join( pLeft, pRight );
+	}
+
+	//____ _insert() _______________________________________________________________
+
+	void ChunkedCharBuffer::_insert( int ofs, int nChars, const Char * pChars )
+	{
+		// Insert short runs into an existing chunk, splitting it in two if full.
+
+		if( m_pRoot && nChars <= c_chunkCapacity / 2 )
+		{
+			while( true )
+			{
+				int chunkOfs = ofs;
+				const Chunk * pFound = _find( m_pRoot, chunkOfs, true );
+
+				if( pFound->nChars + nChars <= c_chunkCapacity )
+					break;
+
+				Chunk * pLeft, * pRight;
+
+				_split( m_pRoot, ofs - chunkOfs + pFound->nChars / 2, pLeft, pRight );
+				m_pRoot = _merge( pLeft, pRight );
+			}
+
+			Chunk * p = _ownPathTo( m_pRoot, ofs, true, nChars );
+			Char * pDest = _chars(p) + ofs;
+
+			memmove( pDest + nChars, pDest, (p->nChars - ofs)*sizeof(uint32_t) );
+			p->nChars += nChars;
+
+			if( pChars )
+			{
+				memcpy( pDest, pChars, nChars*sizeof(uint32_t) );
+				TextTool::refStyle( pDest, nChars );
+			}
+			else
+			{
+				uint32_t * pRaw = (uint32_t*) pDest;
+				for( int i = 0 ; i < nChars ; i++ )
+					pRaw[i] = c_emptyChar;
+			}
+			return;
+		}
+
+		// Build new chunks for longer runs and merge them in.
+
+		Chunk * pLeft, * pRight;
+
+		_split( m_pRoot, ofs, pLeft, pRight );
+		m_pRoot = _join( _join( pLeft, _build( pChars, nChars ) ), pRight );
+	}
+
+	//____ _modify() _______________________________________________________________
+	//
+	// Calls func for all characters in the range, taking ownership of the chunks
+	// involved first so that shared chunks are left untouched.
+
+	template<class F>
+	void ChunkedCharBuffer::_modify( Chunk *& p, int ofs, int len, const F& func )
+	{
+		if( !p || len <= 0 || ofs >= p->nTotal )
+			return;
+
+		// Clip range to content before calculating its end, ofs + len overflows for len = INT_MAX.
+
+		if( ofs < 0 )
+		{
+			len += ofs;
+			ofs = 0;
+			if( len <= 0 )
+				return;
+		}
+
+		if( len > p->nTotal - ofs )
+			len = p->nTotal - ofs;
+
+		p = _own( p );
+
+		int beg = ofs;
+		int end = ofs + len;
+
+		int chunkBeg = _total( p->pLeft );
+		int chunkEnd = chunkBeg + p->nChars;
+
+		if( beg < chunkBeg )
+			_modify( p->pLeft, beg, std::min(end,chunkBeg) - beg, func );
+
+		int a = std::max( beg, chunkBeg );
+		int b = std::min( end, chunkEnd );
+		if( a < b )
+			func( _chars(p) + a - chunkBeg, b - a );
+
+		if( end > chunkEnd )
+		{
+			int rightBeg = std::max( beg, chunkEnd );
+			_modify( p->pRight, rightBeg - chunkEnd, end - rightBeg, func );
+		}
+	}
+
+	//____ _createChunk() __________________________________________________________
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_createChunk( uint32_t priority )
+	{
+		Chunk * p = new Chunk;
+		p->refCnt = 1;
+		p->priority = priority;
+		p->nChars = 0;
+		p->nTotal = 0;
+		p->pLeft = nullptr;
+		p->pRight = nullptr;
+
+		s_nChunks++;
+		return p;
+	}
+
+	//____ _own() __________________________________________________________________
+	//
+	// Makes sure we have a chunk of our own that we can modify, copying it if shared.
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_own( Chunk * p )
+	{
+		if( p->refCnt == 1 )
+			return p;
+
+		Chunk * pCopy = _createChunk( p->priority );
+		pCopy->nChars = p->nChars;
+		pCopy->nTotal = p->nTotal;
+		pCopy->pLeft = p->pLeft;
+		pCopy->pRight = p->pRight;
+		memcpy( pCopy->chars, p->chars, p->nChars*sizeof(uint32_t) );
+
+		TextTool::refStyle( _chars(pCopy), pCopy->nChars );
+		if( pCopy->pLeft )
+			pCopy->pLeft->refCnt++;
+		if( pCopy->pRight )
+			pCopy->pRight->refCnt++;
+
+		p->refCnt--;
+		return pCopy;
+	}
+
+	//____ _release() ______________________________________________________________
+
+	void ChunkedCharBuffer::_release( Chunk * p )
+	{
+		if( p && --p->refCnt == 0 )
+		{
+			TextTool::derefStyle( _chars(p), p->nChars );
+			_release( p->pLeft );
+			_release( p->pRight );
+			delete p;
+			s_nChunks--;
+		}
+	}
+
+	//____ _split() ________________________________________________________________
+	//
+	// Splits the tree into the characters before and after ofs, cutting a chunk in two if needed.
+	// Takes over the reference to p and returns a reference to each part.
+
+	void ChunkedCharBuffer::_split( Chunk * p, int ofs, Chunk *& pLeft, Chunk *& pRight )
+	{
+		if( !p )
+		{
+			pLeft = pRight = nullptr;
+			return;
+		}
+
+		p = _own( p );
+
+		int chunkBeg = _total( p->pLeft );
+		int chunkEnd = chunkBeg + p->nChars;
+
+		if( ofs <= chunkBeg )
+		{
+			_split( p->pLeft, ofs, pLeft, p->pLeft );
+			_updateTotal( p );
+			pRight = p;
+		}
+		else if( ofs >= chunkEnd )
+		{
+			_split( p->pRight, ofs - chunkEnd, p->pRight, pRight );
+			_updateTotal( p );
+			pLeft = p;
+		}
+		else
+		{
+			// Cut the chunk in two. The new chunk needs a priority of its own, since chunks
+			// sharing priority degenerate the tree into a list when the same end keeps being
+			// split, like when appending. It is merged with what was to the right of the cut.
+
+			int cut = ofs - chunkBeg;
+
+			Chunk * pNew = _createChunk( _randomPriority() );
+			pNew->nChars = p->nChars - cut;
+			memcpy( pNew->chars, p->chars + cut, pNew->nChars*sizeof(uint32_t) );
+			_updateTotal( pNew );
+
+			Chunk * pAfter = p->pRight;
+
+			p->nChars = cut;
+			p->pRight = nullptr;
+			_updateTotal( p );
+
+			pLeft = p;
+			pRight = _merge( pNew, pAfter );
+		}
+	}
+
+	//____ _merge() ________________________________________________________________
+	//
+	// Joins two trees, all characters in pLeft preceding those in pRight.
+	// Takes over the references to both and returns a reference to the result.
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_merge( Chunk * pLeft, Chunk * pRight )
+	{
+		if( !pLeft )
+			return pRight;
+		if( !pRight )
+			return pLeft;
+
+		if( pLeft->priority >= pRight->priority )
+		{
+			pLeft = _own( pLeft );
+			pLeft->pRight = _merge( pLeft->pRight, pRight );
+			_updateTotal( pLeft );
+			return pLeft;
+		}
+		else
+		{
+			pRight = _own( pRight );
+			pRight->pLeft = _merge( pLeft, pRight->pLeft );
+			_updateTotal( pRight );
+			return pRight;
+		}
+	}
+
+	//____ _join() _________________________________________________________________
+	//
+	// Like _merge(), but also moves the characters of the first chunk of pRight into the last
+	// chunk of pLeft if they fit, so that edits don't leave lots of small chunks behind.
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_join( Chunk * pLeft, Chunk * pRight )
+	{
+		if( pLeft && pRight )
+		{
+			const Chunk * pFirst = pRight;
+			while( pFirst->pLeft )
+				pFirst = pFirst->pLeft;
+
+			int end = pLeft->nTotal;
+			const Chunk * pLast = _find( pLeft, end, true );
+
+			if( pLast->nChars + pFirst->nChars <= c_chunkCapacity )
+			{
+				Chunk * pMoved;
+				_split( pRight, pFirst->nChars, pMoved, pRight );
+
+				int n = pMoved->nChars;
+				end = pLeft->nTotal;
+				Chunk * p = _ownPathTo( pLeft, end, true, n );
+
+				memcpy( p->chars + p->nChars, pMoved->chars, n*sizeof(uint32_t) );
+				TextTool::refStyle( _chars(p) + p->nChars, n );
+				p->nChars += n;
+
+				_release( pMoved );
+			}
+		}
+
+		return _merge( pLeft, pRight );
+	}
+
+	//____ _build() ________________________________________________________________
+	//
+	// Builds a tree of new chunks holding the characters, or whitespace if pChars is null.
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_build( const Char * pChars, int nChars )
+	{
+		Chunk * pTree = nullptr;
+
+		while( nChars > 0 )
+		{
+			int n = std::min( nChars, c_chunkCapacity );
+
+			Chunk * p = _createChunk( _randomPriority() );
+			p->nChars = n;
+			p->nTotal = n;
+
+			if( pChars )
+			{
+				memcpy( p->chars, pChars, n*sizeof(uint32_t) );
+				TextTool::refStyle( _chars(p), n );
+				pChars += n;
+			}
+			else
+			{
+				for( int i = 0 ; i < n ; i++ )
+					p->chars[i] = c_emptyChar;
+			}
+
+			pTree = _merge( pTree, p );
+			nChars -= n;
+		}
+		return pTree;
+	}
+
+	//____ _find() _________________________________________________________________
+	//
+	// Finds the chunk containing the character at ofs and converts ofs into an offset
+	// within that chunk. If bAllowEnd is set, ofs may point just past the last character
+	// of a chunk, so that the end of the content can be found.
+
+	const ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_find( const Chunk * p, int& ofs, bool bAllowEnd )
+	{
+		while( true )
+		{
+			int chunkBeg = _total( p->pLeft );
+			int chunkEnd = chunkBeg + p->nChars;
+
+			if( ofs < chunkBeg )
+				p = p->pLeft;
+			else if( ofs < chunkEnd || (bAllowEnd && ofs == chunkEnd) )
+			{
+				ofs -= chunkBeg;
+				return p;
+			}
+			else
+			{
+				ofs -= chunkEnd;
+				p = p->pRight;
+			}
+		}
+	}
+
+	//____ _ownPathTo() ____________________________________________________________
+	//
+	// Same as _find(), but takes ownership of all chunks on the way so that the one found can be
+	// modified and adds sizeChange to their totals.
+
+	ChunkedCharBuffer::Chunk * ChunkedCharBuffer::_ownPathTo( Chunk *& pRoot, int& ofs, bool bAllowEnd, int sizeChange )
+	{
+		Chunk ** pp = &pRoot;
+
+		while( true )
+		{
+			Chunk * p = _own( * pp );
+			* pp = p;
+			p->nTotal += sizeChange;
+
+			int chunkBeg = _total( p->pLeft );
+			int chunkEnd = chunkBeg + p->nChars;
+
+			if( ofs < chunkBeg )
+				pp = &p->pLeft;
+			else if( ofs < chunkEnd || (bAllowEnd && ofs == chunkEnd) )
+			{
+				ofs -= chunkBeg;
+				return p;
+			}
+			else
+			{
+				ofs -= chunkEnd;
+				pp = &p->pRight;
+			}
+		}
+	}
+
+	//____ _copyOut() ______________________________________________________________
+	//
+	// Copies raw characters in the range without touching style references.
+
+	void ChunkedCharBuffer::_copyOut( const Chunk * p, int ofs, int len, Char * pDest )
+	{
+		while( len > 0 )
+		{
+			int chunkOfs = ofs;
+			const Chunk * pChunk = _find( p, chunkOfs, false );
+
+			int n = std::min( len, pChunk->nChars - chunkOfs );
+			memcpy( pDest, pChunk->chars + chunkOfs, n*sizeof(uint32_t) );
+
+			pDest += n;
+			ofs += n;
+			len -= n;
+		}
+	}
+
+	//____ _clearFlat() ____________________________________________________________
+
+	void ChunkedCharBuffer::_clearFlat() const
+	{
+		if( m_pFlat )
+		{
+			delete [] (uint32_t*) m_pFlat;
+			m_pFlat = nullptr;
+		}
+	}
+
+	//____ _randomPriority() _______________________________________________________
+
+	uint32_t ChunkedCharBuffer::_randomPriority()
+	{
+		uint32_t x = s_randomSeed;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		s_randomSeed = x;
+		return x;
+	}
+
+	//____ _countChunks() __________________________________________________________
+
+	int ChunkedCharBuffer::_countChunks( const Chunk * p )
+	{
+		if( !p )
+			return 0;
+
+		return 1 + _countChunks( p->pLeft ) + _countChunks( p->pRight );
+	}
+
+} // namespace wg
@@ -0,0 +1,214 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef WG_CHUNKEDCHARBUFFER_DOT_H
+#define WG_CHUNKEDCHARBUFFER_DOT_H
+#pragma once
+
+#include <wg_types.h>
+#include <wg_char.h>
+
+namespace wg
+{
+
+	class CharSeq;
+	class CharBuffer;
+
+	//____ ChunkedCharBuffer ____________________________________________________________
+
+	/**
+		ChunkedCharBuffer is an alternative to CharBuffer for large texts that are
+		edited in place, like logs, code or documents of several megabytes.
+
+		CharBuffer keeps its content in one contiguous array, so inserting or removing
+		characters in the middle of it moves the whole tail of the text, and the first
+		change to a shared buffer copies all of it. ChunkedCharBuffer instead keeps
+		the characters in chunks of limited size, organized as a balanced tree
+		indexed by character offset. Inserts, removes and lookups are O(log n) and
+		only touch the chunks involved.
+
+		Chunks are reference counted and shared between ChunkedCharBuffers, so
+		copying a buffer is O(1) no matter how large it is. Only the chunks on the path
+		to a change are copied when a shared buffer is modified, which makes it cheap
+		to keep snapshots of the content for undo.
+
+		The methods for modifying the content are the same as for CharBuffer.
+		Methods dealing with capacity and direct write access (beginWrite(), trim()
+		etc) have no counterpart here since there is no single buffer to manage.
+
+		chars() is provided for compatibility with code that needs all characters in
+		one array, but it needs to copy the whole content into a separate
+		buffer the first time it is called after a change, so use it sparingly.
+
+		Example:
+
+		@code
+		ChunkedCharBuffer	text;
+		text.pushBack( "Hello World!" );
+
+		ChunkedCharBuffer	undo = text;		// Snapshot, nothing is copied.
+
+		text.insert( 5, "," );					// Only one chunk is copied.
+		@endcode
+	*/
+
+	class ChunkedCharBuffer
+	{
+	public:
+
+		//.____ Creation ___________________________________________________
+
+		ChunkedCharBuffer();
+		ChunkedCharBuffer( const ChunkedCharBuffer& r );
+		ChunkedCharBuffer( const CharSeq& seq );
+
+		~ChunkedCharBuffer();
+
+
+		//.____ Operators ______________________________________________________
+
+		ChunkedCharBuffer& operator=( ChunkedCharBuffer const & r );
+		ChunkedCharBuffer& operator=( CharSeq const & r );
+
+		bool operator==( const ChunkedCharBuffer& other ) const;
+		inline bool operator!=( const ChunkedCharBuffer& other ) const { return !(*this == other); }
+
+		const Char&			operator[]( int i ) const;
+
+		inline operator bool() const { return nbChars() != 0; }
+
+		//.____ Content ___________________________________________________________
+
+		void	reset();
+
+		int		pushFront( int nChars );
+		int		pushFront( const Char& character );
+		int		pushFront( const Char * pChars );
+		int		pushFront( const Char * pChars, int nChars );
+		int		pushFront( const CharSeq& seq );
+
+		int		popFront( int nChars );
+
+		int		pushBack( int nChars );
+		int		pushBack( const Char& character );
+		int		pushBack( const Char * pChars );
+		int		pushBack( const Char * pChars, int nChars );
+		int		pushBack( const CharSeq& seq );
+
+		int		popBack( int nChars );
+
+		int		insert( int ofs, int nChars );
+		int		insert( int ofs, const Char& character );
+		int		insert( int ofs, const Char * pChars );
+		int		insert( int ofs, const Char * pChars, int nChars );
+		int		insert( int ofs, const CharSeq& seq );
+
+		int		remove( int ofs, int nChars = 1 );
+
+		int		replace( int ofs, const Char& character );
+		int		replace( int ofs, int nDelete, int nInsert );
+		int		replace( int ofs, int nDelete, const Char * pChars );
+		int		replace( int ofs, int nDelete, const Char * pChars, int nInsert );
+		int		replace( int ofs, int nDelete, const CharSeq& seq );
+
+		const Char *		chars() const;
+		int					copyTo( Char * pDest, int ofs = 0, int len = INT_MAX ) const;
+
+		inline int			nbChars() const { return m_pRoot ? m_pRoot->nTotal : 0; }
+		inline int			length() const { return nbChars(); }
+
+		inline void			fill( const Char& ch ) { fill( ch, 0, INT_MAX ); }
+		void				fill( const Char& ch, int ofs, int len );
+
+		inline void			setCharCodes( uint16_t charCode ) { setCharCodes( charCode, 0, INT_MAX ); }
+		void				setCharCodes( uint16_t charCode, int ofs, int len );
+
+		inline void			setStyle( TextStyle * pStyle ) { setStyle( pStyle, 0, INT_MAX ); }
+		void				setStyle( TextStyle * pStyle, int ofs, int len );
+
+		inline void			clear() { remove( 0, INT_MAX ); }
+
+		inline void 		clearStyle() { clearStyle( 0, INT_MAX ); }
+		void				clearStyle( int ofs, int len );
+
+		//.____ Misc ___________________________________________________________
+
+		int					findFirst( uint16_t character, int ofs = 0 ) const;
+
+		// Methods mostly for debugging and profiling purposes.
+
+		int					nbChunks() const;
+		inline static int	nbAllocatedChunks() { return s_nChunks; }
+
+	private:
+
+		const static int	c_chunkCapacity = 1020;		// Chars per chunk. Makes a chunk exactly 4 KB with the header.
+
+		struct Chunk
+		{
+			int			refCnt;
+			uint32_t	priority;			// Chunks with higher priority are closer to the root.
+			int			nChars;				// Chars in this chunk.
+			int			nTotal;				// Chars in this chunk and all its descendants.
+			Chunk *		pLeft;				// Chunks with chars before ours.
+			Chunk *		pRight;				// Chunks with chars after ours.
+			uint32_t	chars[c_chunkCapacity];		// Raw Chars, so we can copy them without touching the style references.
+		};
+
+		inline static Char *	_chars( Chunk * p ) { return (Char*) p->chars; }
+		inline static int		_total( const Chunk * p ) { return p ? p->nTotal : 0; }
+		inline static void		_updateTotal( Chunk * p ) { p->nTotal = _total(p->pLeft) + p->nChars + _total(p->pRight); }
+
+		static Chunk *	_createChunk( uint32_t priority );
+		static Chunk *	_own( Chunk * p );
+		static void		_release( Chunk * p );
+
+		static void		_split( Chunk * p, int ofs, Chunk *& pLeft, Chunk *& pRight );
+		static Chunk *	_merge( Chunk * pLeft, Chunk * pRight );
+		static Chunk *	_join( Chunk * pLeft, Chunk * pRight );
+		static Chunk *	_build( const Char * pChars, int nChars );
+
+		static const Chunk *	_find( const Chunk * p, int& ofs, bool bAllowEnd );
+		static Chunk *	_ownPathTo( Chunk *& p, int& ofs, bool bAllowEnd, int sizeChange );
+		static void		_copyOut( const Chunk * p, int ofs, int len, Char * pDest );
+
+		template<class F>
+		static void		_modify( Chunk *& p, int ofs, int len, const F& func );
+
+		int				_replace( int ofs, int nDelete, int nInsert, const Char * pChars = nullptr );
+		void			_remove( int ofs, int nChars );
+		void			_insert( int ofs, int nChars, const Char * pChars );
+		void			_clearFlat() const;
+
+		static uint32_t	_randomPriority();
+		static int		_countChunks( const Chunk * p );
+
+		const static uint32_t	c_emptyChar = 0x00000020;	// Value to fill out empty Chars with.
+		static int				s_nChunks;					// Number of chunks allocated, for profiling.
+		static uint32_t			s_randomSeed;
+
+		Chunk *			m_pRoot;
+		mutable Char *	m_pFlat;		// Content as one null-terminated array, created by chars() on demand.
+	};
+
+} // namespace wg
+#endif //WG_CHUNKEDCHARBUFFER_DOT_H
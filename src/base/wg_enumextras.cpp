@@ -292,7 +292,8 @@ namespace wg
 			"BGRA_4",
 			"BGR_565",
 			"I8",
-			"A8" };
+			"A8",
+			"BGRA_8_pre" };
 
 		return names[(int)i];
 	}
@@ -329,6 +330,7 @@ namespace wg
 			"ComplexTransformBlit",
 			"TransformDrawSegments",
 			"EdgeSamples",
+			"BlitNinePatch",
 			"CreateSurface",
 			"SetSurfaceScaleMode",
 			"BeginSurfaceUpdate",
@@ -336,7 +338,9 @@ namespace wg
 			"EndSurfaceUpdate",
 			"FillSurface",
 			"CopySurface",
-			"DeleteSurface" };
+			"DeleteSurface",
+			"CreatePalette",
+			"DeletePalette" };
 
 		return names[(int)i];
 	}
@@ -77,9 +77,9 @@ namespace wg
 	const static TextEditMode    TextEditMode_max    = TextEditMode::Editable;
 	const static AccessMode      AccessMode_max      = AccessMode::ReadWrite;
 	const static ScaleMode       ScaleMode_max       = ScaleMode::Interpolate;
-	const static PixelFormat     PixelFormat_max     = PixelFormat::A8;
+	const static PixelFormat     PixelFormat_max     = PixelFormat::BGRA_8_pre;
 	const static MaskOp          MaskOp_max          = MaskOp::Mask;
-	const static GfxChunkId      GfxChunkId_max      = GfxChunkId::DeleteSurface;
+	const static GfxChunkId      GfxChunkId_max      = GfxChunkId::DeletePalette;
 	const static GfxFlip         GfxFlip_max         = GfxFlip::Rot270FlipY;
 
 	const static int             CodePage_size       = (int)CodePage::_874 + 1;
@@ -99,9 +99,9 @@ namespace wg
 	const static int             TextEditMode_size   = (int)TextEditMode::Editable + 1;
 	const static int             AccessMode_size     = (int)AccessMode::ReadWrite + 1;
 	const static int             ScaleMode_size      = (int)ScaleMode::Interpolate + 1;
-	const static int             PixelFormat_size    = (int)PixelFormat::A8 + 1;
+	const static int             PixelFormat_size    = (int)PixelFormat::BGRA_8_pre + 1;
 	const static int             MaskOp_size         = (int)MaskOp::Mask + 1;
-	const static int             GfxChunkId_size     = (int)GfxChunkId::DeleteSurface + 1;
+	const static int             GfxChunkId_size     = (int)GfxChunkId::DeletePalette + 1;
 	const static int             GfxFlip_size        = (int)GfxFlip::Rot270FlipY + 1;
 
 	const char * toString(CodePage);
@@ -22,6 +22,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <cstring>
 
 #include <wg_gfxdevice.h>
 #include <wg_geo.h>
@@ -110,6 +112,8 @@ namespace wg
 
 	GfxDevice::~GfxDevice()
 	{
+		delete m_pStats;
+
 		s_gfxDeviceCount--;
 		if (s_gfxDeviceCount == 0)
 		{
@@ -145,16 +149,44 @@ namespace wg
 		return 0;
 	}
 
+	//____ setStatsEnabled() ______________________________________________________
+	/**
+	 * @brief Enable or disable collection of rendering statistics.
+	 *
+	 * Collecting statistics adds the cost of reading a clock and clipping the destination
+	 * rectangle to every primitive. When disabled the only cost is a pointer check.
+	 *
+	 * Statistics are cleared by beginRender() and can be read through stats() after
+	 * endRender().
+	 */
+
+	void GfxDevice::setStatsEnabled( bool bEnabled )
+	{
+		if( bEnabled && !m_pStats )
+		{
+			m_pStats = new GfxStats();
+			m_pStats->clear();
+		}
+		else if( !bEnabled && m_pStats )
+		{
+			delete m_pStats;
+			m_pStats = nullptr;
+		}
+	}
+
 	//____ setClipList() __________________________________________________________
 
 	bool GfxDevice::setClipList(int nRectangles, const Rect * pRectangles)
 	{
+		_countStateChange();
+
 		if (nRectangles == 0)
 		{
 			m_clipCanvas = m_canvasSize;
 			m_clipBounds = m_canvasSize;
 			m_pClipRects = &m_clipCanvas;
 			m_nClipRects = 1;
+			m_bClipRendered = false;
 			return true;
 		}
 
@@ -168,6 +200,7 @@ namespace wg
 		m_pClipRects = pRectangles;
 		m_nClipRects = nRectangles;
 		m_clipBounds = bounds;
+		m_bClipRendered = false;
 		return true;
 	}
 
@@ -175,16 +208,20 @@ namespace wg
 
 	void GfxDevice::clearClipList()
 	{
+		_countStateChange();
+
 		m_clipBounds = m_canvasSize;
 		m_clipCanvas = m_canvasSize;
 		m_pClipRects = &m_clipCanvas;
 		m_nClipRects = 1;
+		m_bClipRendered = false;
 	}
 
 	//____ setTintColor() __________________________________________________________
 
 	void GfxDevice::setTintColor( Color color )
 	{
+		_countStateChange();
 		m_tintColor = color;
 	}
 
@@ -192,6 +229,8 @@ namespace wg
 
 	bool GfxDevice::setBlendMode( BlendMode blendMode )
 	{
+		_countStateChange();
+
 		if (blendMode == BlendMode::Undefined)
 			m_blendMode = BlendMode::Blend;
 		else
@@ -204,6 +243,7 @@ namespace wg
 
 	bool GfxDevice::setBlitSource(Surface * pSource)
 	{
+		_countStateChange();
 		m_pBlitSource = pSource;
 		return true;
 	}
@@ -212,6 +252,10 @@ namespace wg
 
 	bool GfxDevice::beginRender()
 	{
+		if( m_pStats )
+			m_pStats->clear();
+
+		_clearRenderBounds();
 		return true;	// Assumed to be ok if device doesn't have its own method.
 	}
 
@@ -219,9 +263,69 @@ namespace wg
 
 	bool GfxDevice::endRender()
 	{
+		_markCanvasDirty();
 		return true;	// Assumed to be ok if device doesn't have its own method.
 	}
 
+	//____ _beginStats() ________________________________________________________
+
+	void GfxDevice::_beginStats( GfxStats::Primitive primitive, const Rect& dest, int64_t& startTime )
+	{
+		if( m_bInStatsScope )
+			return;
+
+		int64_t pixels = 0;
+		for( int i = 0 ; i < m_nClipRects ; i++ )
+		{
+			Rect r( dest, m_pClipRects[i] );
+			if( r.w > 0 && r.h > 0 )
+			{
+				pixels += r.w * r.h;
+				m_pStats->clipRects++;
+			}
+		}
+
+		m_bInStatsScope = true;
+		m_statsPrimitive = primitive;
+		m_pStats->primitives[primitive].pixels += pixels;
+		startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void GfxDevice::_beginStats( GfxStats::Primitive primitive, int64_t pixels, int64_t& startTime )
+	{
+		if( m_bInStatsScope )
+			return;
+
+		m_bInStatsScope = true;
+		m_statsPrimitive = primitive;
+		m_pStats->clipRects += m_nClipRects;
+		m_pStats->primitives[primitive].pixels += pixels;
+		startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//____ _endStats() ____________________________________________________________
+
+	void GfxDevice::_endStats( int64_t startTime )
+	{
+		int64_t endTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		m_bInStatsScope = false;
+
+		if( m_pStats )
+		{
+			GfxStats::Counter& counter = m_pStats->primitives[m_statsPrimitive];
+			counter.calls++;
+			counter.nanoseconds += endTime - startTime;
+		}
+	}
+
+	//____ GfxStats::clear() ______________________________________________________
+
+	void GfxStats::clear()
+	{
+		std::memset( this, 0, sizeof(GfxStats) );
+	}
+
 	//____ fill() ______________________________________________________
 
 	void GfxDevice::fill(const Color& col)
@@ -487,13 +591,10 @@ namespace wg
 
 		if (srcFrame.isEmpty() || dstFrame.isEmpty())
 		{
-			stretchBlit(dstRect.pos(), srcRect);
+			_blitNinePatchSection(dstRect, srcRect);
 			return;
 		}
 
-		//TODO: Optimize! Call transformBlit directly instead of going through stretchBlit(), reuse transforms where possible.
-		//TODO: Optimize! Use blit instead of stretchBlit on opportunity,fill if center is only 1 pixel and just blit corners if not stretched.
-
 		Size srcMidSize(srcRect.w - srcFrame.left - srcFrame.right, srcRect.h - srcFrame.top - srcFrame.bottom);
 		Size dstMidSize(dstRect.w - dstFrame.left - dstFrame.right, dstRect.h - dstFrame.top - dstFrame.bottom);
 
@@ -507,14 +608,9 @@ namespace wg
 			Rect	dstN(dstRect.x + dstFrame.left, dstRect.y, dstMidSize.w, dstFrame.top);
 			Rect	dstNE(dstRect.x + dstRect.w - dstFrame.right, dstRect.y, dstFrame.right, dstFrame.top);
 
-			if (srcNW.w + dstNW.w > 0)
-				stretchBlit(dstNW, srcNW);
-
-			if (srcN.w + dstN.w > 0)
-				stretchBlit(dstN, srcN);
-
-			if (srcNE.w + dstNE.w > 0)
-				stretchBlit(dstNE, srcNE);
+			_blitNinePatchSection(dstNW, srcNW);
+			_blitNinePatchSection(dstN, srcN);
+			_blitNinePatchSection(dstNE, srcNE);
 		}
 
 
@@ -528,14 +624,9 @@ namespace wg
 			Rect	dstC(dstRect.x + dstFrame.left, dstRect.y + dstFrame.top, dstMidSize.w, dstMidSize.h);
 			Rect	dstE(dstRect.x + dstRect.w - dstFrame.right, dstRect.y + dstFrame.top, dstFrame.right, dstMidSize.h);
 
-			if (srcW.w + dstW.w > 0)
-				stretchBlit(dstW, srcW);
-
-			if (srcC.w + dstC.w > 0)
-				stretchBlit(dstC, srcC);
-
-			if (srcE.w + dstE.w > 0)
-				stretchBlit(dstE, srcE);
+			_blitNinePatchSection(dstW, srcW);
+			_blitNinePatchSection(dstC, srcC);
+			_blitNinePatchSection(dstE, srcE);
 		}
 
 		if (srcFrame.bottom + dstFrame.bottom > 0)
@@ -548,16 +639,29 @@ namespace wg
 			Rect	dstS(dstRect.x + dstFrame.left, dstRect.y + dstRect.h - dstFrame.bottom, dstMidSize.w, dstFrame.bottom);
 			Rect	dstSE(dstRect.x + dstRect.w - dstFrame.right, dstRect.y + dstRect.h - dstFrame.bottom, dstFrame.right, dstFrame.bottom);
 
-			if (srcSW.w + dstSW.w > 0)
-				stretchBlit(dstSW, srcSW);
+			_blitNinePatchSection(dstSW, srcSW);
+			_blitNinePatchSection(dstS, srcS);
+			_blitNinePatchSection(dstSE, srcSE);
+		}
+	}
 
-			if (srcS.w + dstS.w > 0)
-				stretchBlit(dstS, srcS);
+	//____ _blitNinePatchSection() ________________________________________
+	/*
+		Renders one of the nine sections with the cheapest primitive available. Sections
+		that aren't stretched (typically the corners) are blitted straight, the rest goes
+		through the stretch transform. Devices that can do better for specific cases, like
+		sections of a single pixel, override this.
+	*/
 
-			if (srcSE.w + dstSE.w > 0)
-				stretchBlit(dstSE, srcSE);
-		}
+	void GfxDevice::_blitNinePatchSection(const Rect& dst, const Rect& src)
+	{
+		if (dst.w <= 0 || dst.h <= 0 || src.w <= 0 || src.h <= 0)
+			return;
 
+		if (dst.w == src.w && dst.h == src.h)
+			transformBlit(dst, src.pos(), blitFlipTransforms[(int)GfxFlip::Normal]);
+		else
+			stretchBlit(dst, src);
 	}
 
 	//____ drawWave() ______________________________________________________
@@ -1103,6 +1207,33 @@ namespace wg
 		}
 	}
 
+	//____ _growRenderBounds() ___________________________________________________
+	// Clip bounds limit what a primitive can draw, so the union of the clip bounds
+	// primitives have been drawn through is a cheap upper bound of what has been
+	// modified on the canvas.
+
+	void GfxDevice::_growRenderBounds()
+	{
+		if( m_renderBounds.w == 0 || m_renderBounds.h == 0 )
+			m_renderBounds = m_clipBounds;
+		else if( m_clipBounds.w != 0 && m_clipBounds.h != 0 )
+			m_renderBounds.growToContain(m_clipBounds);
+
+		m_bClipRendered = true;
+	}
+
+	//____ _markCanvasDirty() _____________________________________________________
+	// Flags the area rendered to on the canvas as dirty, so that whoever displays
+	// or streams the canvas can limit their work to that.
+
+	void GfxDevice::_markCanvasDirty()
+	{
+		if( m_pCanvas && m_renderBounds.w > 0 && m_renderBounds.h > 0 )
+			m_pCanvas->markDirty(m_renderBounds);
+
+		_clearRenderBounds();
+	}
+
 	//____ _traceLine() __________________________________________________________
 
 	void GfxDevice::_traceLine(int * pDest, int nPoints, const WaveLine * pWave, int offset)
@@ -60,6 +60,46 @@ namespace wg
 		int		hold;      // Value for extending the line if it is too short (or completely missing).
 	};
 
+	//____ GfxStats ___________________________________________________________
+	/**
+	 * @brief Statistics collected by a GfxDevice while rendering.
+	 *
+	 * Statistics are only collected while enabled through GfxDevice::setStatsEnabled().
+	 * The counters are cleared by beginRender(), so after endRender() they describe
+	 * the last render pass.
+	 *
+	 * Pixels are the number of pixels of the destination rectangle that are
+	 * inside the clip rectangles. For lines and plots they are estimated from
+	 * the length and thickness or the number of coordinates.
+	 */
+
+	struct GfxStats
+	{
+		enum Primitive
+		{
+			Fill,
+			Blit,
+			StretchBlit,		///< Stretch, rotation, scaling and other transforms with non-integer coordinates.
+			Segments,			///< Segments, waves and elipses.
+			Line,
+			Plot,
+			PrimitiveCount
+		};
+
+		struct Counter
+		{
+			int			calls;
+			int64_t		pixels;
+			int64_t		nanoseconds;
+		};
+
+		Counter		primitives[PrimitiveCount];
+		int64_t		clipRects;			///< Clip rectangles intersected by the primitives.
+		int			stateChanges;		///< Changes of canvas, clip list, tint color, blend mode or blit source.
+
+		void		clear();
+	};
+
 	//____ GfxDevice __________________________________________________________
 
 	class GfxDevice : public Object
@@ -79,6 +119,10 @@ namespace wg
 
 		virtual SurfaceFactory_p	surfaceFactory() = 0;
 
+		void				setStatsEnabled( bool bEnabled );
+		inline bool			isStatsEnabled() const { return m_pStats != nullptr; }
+		inline const GfxStats *	stats() const { return m_pStats; }		///< @brief Statistics since beginRender(), nullptr unless enabled.
+
 		//.____ Geometry _________________________________________________
 
 		virtual bool		setCanvas(Surface * pCanvas) = 0;
@@ -181,11 +225,56 @@ namespace wg
 		GfxDevice( Size canvasSize );
 		virtual ~GfxDevice();
 
+		// Collects statistics for a primitive from construction to destruction if stats are enabled.
+		// Primitives called by other primitives are only counted by the outermost scope.
+		// Also includes the current clip bounds in the area marked dirty on the canvas.
+
+		class StatsScope
+		{
+		public:
+			inline StatsScope( GfxDevice * pDevice, GfxStats::Primitive primitive, const Rect& dest ) : m_pDevice(pDevice), m_startTime(-1)
+			{
+				pDevice->_markClipRendered();
+				if( pDevice->m_pStats )
+					pDevice->_beginStats( primitive, dest, m_startTime );
+			}
+
+			inline StatsScope( GfxDevice * pDevice, GfxStats::Primitive primitive, int64_t pixels ) : m_pDevice(pDevice), m_startTime(-1)
+			{
+				pDevice->_markClipRendered();
+				if( pDevice->m_pStats )
+					pDevice->_beginStats( primitive, pixels, m_startTime );
+			}
+
+			inline ~StatsScope()
+			{
+				if( m_startTime >= 0 )
+					m_pDevice->_endStats( m_startTime );
+			}
+
+		private:
+			GfxDevice *	m_pDevice;
+			int64_t		m_startTime;
+		};
+
+		inline void		_countStateChange() { if( m_pStats ) m_pStats->stateChanges++; }
+
+		void	_beginStats( GfxStats::Primitive primitive, const Rect& dest, int64_t& startTime );
+		void	_beginStats( GfxStats::Primitive primitive, int64_t pixels, int64_t& startTime );
+		void	_endStats( int64_t startTime );
+
 		// Static, shared data
 
 		static	int		s_gfxDeviceCount;				// Number of existing gfxDevices. Ref count for shared data.
 
+		virtual void	_blitNinePatchSection(const Rect& dst, const Rect& src);
+
 		void	_genCurveTab();
+		inline void	_markClipRendered() { if( !m_bClipRendered ) _growRenderBounds(); }
+		inline void	_clearRenderBounds() { m_renderBounds = Rect(); m_bClipRendered = false; }
+		void	_growRenderBounds();
+		void	_markCanvasDirty();
+
 		void	_traceLine(int * pDest, int nPoints, const WaveLine * pWave, int offset);
 
 		const static int c_nCurveTabEntries = 1024;
@@ -202,12 +291,18 @@ namespace wg
 		int			m_nClipRects;
 		Rect		m_clipBounds;
 		Rect		m_clipCanvas;		// Default clip rect for the canvas.
+		Rect		m_renderBounds;		// Union of clip bounds drawn through since beginRender() or setCanvas().
+		bool		m_bClipRendered = false;	// Set when current clip bounds are included in m_renderBounds.
 
 		Color		m_tintColor;		// Current Tint color.
 		BlendMode	m_blendMode;		// Current BlendMode.
 		uint32_t	m_renderFlags;		// Current flags.
 
 		Size		m_canvasSize;
+
+		GfxStats *	m_pStats = nullptr;		// Only set when stats are enabled.
+		bool		m_bInStatsScope = false;
+		GfxStats::Primitive	m_statsPrimitive = GfxStats::Fill;
 	};
 
 } // namespace wg
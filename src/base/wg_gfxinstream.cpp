@@ -132,6 +132,15 @@ namespace wg
 		return *this;
 	}
 
+	GfxInStream& GfxInStream::operator>> (Border& border)
+	{
+		border.top = m_pHolder->_pullShort();
+		border.right = m_pHolder->_pullShort();
+		border.bottom = m_pHolder->_pullShort();
+		border.left = m_pHolder->_pullShort();
+		return *this;
+	}
+
 	GfxInStream& GfxInStream::operator>> (Color& color)
 	{
 		color.argb = m_pHolder->_pullInt();
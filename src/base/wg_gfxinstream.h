@@ -95,6 +95,7 @@ namespace wg
 		GfxInStream& operator>> (SizeF&);
 		GfxInStream& operator>> (Rect&);
 		GfxInStream& operator>> (RectF&);
+		GfxInStream& operator>> (Border&);
 		GfxInStream& operator>> (Color&);
 		GfxInStream& operator>> (Direction&);
 		GfxInStream& operator>> (BlendMode&);
@@ -118,6 +118,15 @@ namespace wg
 		return *this;
 	}
 
+	GfxOutStream&  GfxOutStream::operator<< (const Border& border)
+	{
+		m_pHolder->_pushShort(border.top);
+		m_pHolder->_pushShort(border.right);
+		m_pHolder->_pushShort(border.bottom);
+		m_pHolder->_pushShort(border.left);
+		return *this;
+	}
+
 	GfxOutStream&  GfxOutStream::operator<< (Direction d)
 	{
 		m_pHolder->_pushShort((short)d);
@@ -195,7 +204,7 @@ namespace wg
 	{
 		if (m_freeIdStackSize == m_freeIdStackCapacity)
 		{
-			int capacity = min(16, m_freeIdStackCapacity * 2);
+			int capacity = max(16, m_freeIdStackCapacity * 2);
 			short * pBuffer = new short[capacity];
 
 			for (int i = 0; i < m_freeIdStackSize; i++)
@@ -210,6 +219,55 @@ namespace wg
 		m_pFreeIdStack[m_freeIdStackSize++] = id;
 	}
 
+	//____ retainPalette() ____________________________________________________
+	/**
+	 * @brief Get id of palette in stream, streaming it if not already there.
+	 *
+	 * Each palette is only streamed once, no matter how many surfaces use it.
+	 * Every call must be matched by a call to releasePalette().
+	 */
+
+	short GfxOutStream::retainPalette(Palette * pPalette)
+	{
+		auto it = m_palettes.find(pPalette);
+		if (it != m_palettes.end())
+		{
+			it->second.refCount++;
+			return it->second.id;
+		}
+
+		short id = allocObjectId();
+		m_palettes[pPalette] = { pPalette, id, 1 };
+
+		int bytes = Palette::c_nbColors * sizeof(Color);
 
+		*this << GfxStream::Header{ GfxChunkId::CreatePalette, 2 + bytes };
+		*this << (uint16_t) id;
+		*this << GfxStream::DataChunk{ bytes, pPalette->colors() };
+
+		return id;
+	}
+
+	//____ releasePalette() ___________________________________________________
+	/**
+	 * @brief Release palette retained by retainPalette().
+	 *
+	 * The palette is deleted from the stream when no longer used.
+	 */
+
+	void GfxOutStream::releasePalette(Palette * pPalette)
+	{
+		auto it = m_palettes.find(pPalette);
+		if (it == m_palettes.end() || --it->second.refCount > 0)
+			return;
+
+		short id = it->second.id;
+		m_palettes.erase(it);
+
+		*this << GfxStream::Header{ GfxChunkId::DeletePalette, 2 };
+		*this << (uint16_t) id;
+
+		freeObjectId(id);
+	}
 
 } // namespace wg
@@ -30,6 +30,9 @@
 #include <wg_types.h>
 #include <wg_geo.h>
 #include <wg_color.h>
+#include <wg_palette.h>
+
+#include <unordered_map>
 
 
 namespace wg
@@ -92,6 +95,7 @@ namespace wg
 		GfxOutStream&	operator<< (const SizeF&);
 		GfxOutStream&	operator<< (const Rect&);
 		GfxOutStream&	operator<< (const RectF&);
+		GfxOutStream&	operator<< (const Border&);
 
 		GfxOutStream&	operator<< (Color);
 		GfxOutStream&	operator<< (Direction);
@@ -113,6 +117,9 @@ namespace wg
 		short			allocObjectId();
 		void			freeObjectId(short id);
 
+		short			retainPalette(Palette * pPalette);
+		void			releasePalette(Palette * pPalette);
+
 	protected:
 		Object *				_object() const { return m_pHolder->_object(); }
 
@@ -120,7 +127,16 @@ namespace wg
 
 		short *					m_pFreeIdStack;
 		int						m_freeIdStackCapacity;
-		uint8_t					m_freeIdStackSize;
+		int						m_freeIdStackSize;
+
+		struct StreamedPalette
+		{
+			Palette_p	pPalette;
+			short		id;
+			int			refCount;
+		};
+
+		std::unordered_map<Palette*,StreamedPalette>	m_palettes;		// Palettes alive in the stream.
 
 
 		GfxOutStreamHolder * 	m_pHolder;
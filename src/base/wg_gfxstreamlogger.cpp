@@ -340,6 +340,25 @@ namespace wg
 				break;
 			}
 
+			case GfxChunkId::BlitNinePatch:
+			{
+				Rect		dstRect;
+				Border		dstFrame;
+				Rect		srcRect;
+				Border		srcFrame;
+
+				*m_pGfxStream >> dstRect;
+				*m_pGfxStream >> dstFrame;
+				*m_pGfxStream >> srcRect;
+				*m_pGfxStream >> srcFrame;
+
+				m_charStream << "    dstRect     = " << dstRect.x << ", " << dstRect.y << ", " << dstRect.w << ", " << dstRect.h << std::endl;
+				m_charStream << "    dstFrame    = " << dstFrame.top << ", " << dstFrame.right << ", " << dstFrame.bottom << ", " << dstFrame.left << std::endl;
+				m_charStream << "    srcRect     = " << srcRect.x << ", " << srcRect.y << ", " << srcRect.w << ", " << srcRect.h << std::endl;
+				m_charStream << "    srcFrame    = " << srcFrame.top << ", " << srcFrame.right << ", " << srcFrame.bottom << ", " << srcFrame.left << std::endl;
+				break;
+			}
+
 			case GfxChunkId::EdgeSamples:
 			{
 				m_pGfxStream->skip(header.size);
@@ -353,17 +372,39 @@ namespace wg
 				PixelFormat	type;
 				Size		size;
 				uint16_t	flags;
+				uint16_t	paletteId;
 
 				*m_pGfxStream >> surfaceId;
 				*m_pGfxStream >> type;
 				*m_pGfxStream >> size;
 				*m_pGfxStream >> flags;
+				*m_pGfxStream >> paletteId;
 
 
 				m_charStream << "    surfaceId   = " << surfaceId << std::endl;
 				m_charStream << "    type        = " << toString(type) << std::endl;
 				m_charStream << "    size        = " << size.w << ", " << size.h << std::endl;
 				m_charStream << "    flags       = " << flags << std::endl;
+				m_charStream << "    paletteId   = " << paletteId << std::endl;
+				break;
+			}
+
+			case GfxChunkId::CreatePalette:
+			{
+				uint16_t	paletteId;
+				*m_pGfxStream >> paletteId;
+				m_pGfxStream->skip(header.size - 2);
+
+				m_charStream << "    paletteId   = " << paletteId << std::endl;
+				break;
+			}
+
+			case GfxChunkId::DeletePalette:
+			{
+				uint16_t	paletteId;
+				*m_pGfxStream >> paletteId;
+
+				m_charStream << "    paletteId   = " << paletteId << std::endl;
 				break;
 			}
 
@@ -283,6 +283,22 @@ namespace wg
 			break;
 		}
 
+		case GfxChunkId::BlitNinePatch:
+		{
+			Rect		dstRect;
+			Border		dstFrame;
+			Rect		srcRect;
+			Border		srcFrame;
+
+			*m_pStream >> dstRect;
+			*m_pStream >> dstFrame;
+			*m_pStream >> srcRect;
+			*m_pStream >> srcFrame;
+
+			m_pDevice->blitNinePatch(dstRect, dstFrame, srcRect, srcFrame);
+			break;
+		}
+
 		case GfxChunkId::SimpleTransformBlit:
 		{
 			Rect dest;
@@ -370,29 +386,51 @@ namespace wg
 			PixelFormat	type;
 			Size		size;
 			uint16_t	flags;
+			uint16_t	paletteId;
 
 			*m_pStream >> surfaceId;
 			*m_pStream >> type;
 			*m_pStream >> size;
 			*m_pStream >> flags;
+			*m_pStream >> paletteId;
 
-
-			Color * pClut = nullptr;
-
-			if (header.size > 4096)
-			{
-				pClut = (Color*) Base::memStackAlloc(4096);
-				*m_pStream >> GfxStream::DataChunk{ 4096, pClut };
-			}
+			const Color * pClut = nullptr;
+			if (paletteId > 0 && paletteId < m_vPalettes.size() && m_vPalettes[paletteId])
+				pClut = m_vPalettes[paletteId]->colors();
 
 			if (m_vSurfaces.size() <= surfaceId)
 				m_vSurfaces.resize(surfaceId + 1, nullptr);
 
 			m_vSurfaces[surfaceId] = m_pSurfaceFactory->createSurface(size, type, flags | SurfaceFlag::WriteOnly, pClut);
+			break;
+		}
+
+		case GfxChunkId::CreatePalette:
+		{
+			uint16_t	paletteId;
+			Color		colors[Palette::c_nbColors];
+
+			*m_pStream >> paletteId;
+			*m_pStream >> GfxStream::DataChunk{ (int) sizeof(colors), colors };
+
+			// Palettes are pooled by content, so identical palettes from different
+			// streams, or resent ones, end up as the same object.
+
+			if (m_vPalettes.size() <= paletteId)
+				m_vPalettes.resize(paletteId + 1, nullptr);
+
+			m_vPalettes[paletteId] = Palette::create(colors);
+			break;
+		}
+
+		case GfxChunkId::DeletePalette:
+		{
+			uint16_t	paletteId;
 
-			if (pClut)
-				Base::memStackRelease(4096);
+			*m_pStream >> paletteId;
 
+			if (paletteId < m_vPalettes.size())
+				m_vPalettes[paletteId] = nullptr;
 			break;
 		}
 
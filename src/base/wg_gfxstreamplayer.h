@@ -72,6 +72,7 @@ namespace wg
 		SurfaceFactory_p	m_pSurfaceFactory;
 
 		std::vector<Surface_p>	m_vSurfaces;
+		std::vector<Palette_p>	m_vPalettes;
 
 		Surface_p			m_pUpdatingSurface;
 		uint8_t *			m_pWritePixels;
@@ -21,8 +21,10 @@
 =========================================================================*/
 #include <wg_inputhandler.h>
 #include <wg_base.h>
+#include <wg_scheduler.h>
 #include <wg_rootpanel.h>
 #include <wg_container.h>
+#include <wg_trace.h>
 
 namespace wg
 {
@@ -35,7 +37,7 @@ namespace wg
 	{
 		m_inputId 		= 1;	//TODO: Make unique between input handlers.
 
-		m_tickRoute 	= Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_repeatTask 	= Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onRepeatTick(timestamp); }, -1 );
 		m_timeStamp 	= 0;
 		m_pointerStyle 	= PointerStyle::Default;
 		m_modKeys 		= MODKEY_NONE;
@@ -62,7 +64,7 @@ namespace wg
 
 	InputHandler::~InputHandler()
 	{
-		Base::msgRouter()->deleteRoute(m_tickRoute);
+		Base::scheduler()->removeTask(m_repeatTask);
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -113,6 +115,7 @@ namespace wg
 
 		m_buttonRepeatDelay	= delay;
 		m_buttonRepeatRate	= rate;
+		Base::scheduler()->wakeTask( m_repeatTask );
 		return true;
 	}
 
@@ -125,6 +128,7 @@ namespace wg
 
 		m_keyRepeatDelay	= delay;
 		m_keyRepeatRate		= rate;
+		Base::scheduler()->wakeTask( m_repeatTask );
 		return true;
 	}
 
@@ -249,9 +253,11 @@ namespace wg
 
 	void InputHandler::setPointer( RootPanel * pRoot, Coord pos, int64_t timestamp )
 	{
+		WG_TRACE_SCOPE("InputHandler::setPointer");
+
 		Coord	prevPointerPos = m_pointerPos;
 		if( timestamp == 0 )
-			timestamp = m_timeStamp;
+			timestamp = Base::scheduler()->time();
 
 		m_pointerPos = pos;
 		m_pMarkedRoot = 0;
@@ -392,6 +398,8 @@ namespace wg
 
 	void InputHandler::setButton( MouseButton button, bool bPressed, int64_t timestamp )
 	{
+		WG_TRACE_SCOPE("InputHandler::setButton");
+
 		// Sanity checks
 
 		if( m_bButtonPressed[(int)button] == bPressed )
@@ -414,7 +422,7 @@ namespace wg
 	void InputHandler::_processButtonPress( MouseButton button, int64_t timestamp )
 	{
 		if( timestamp == 0 )
-			timestamp = m_timeStamp;
+			timestamp = Base::scheduler()->time();
 
 		// Post BUTTON_PRESS events for marked widgets and remember which one we have posted it for
 
@@ -456,6 +464,8 @@ namespace wg
 		m_latestPressTimestamps[(int)button] 	= timestamp;
 		m_latestPressPosition[(int)button] 		= m_pointerPos;
 		m_latestPressDoubleClick[(int)button] 	= doubleClick;
+
+		Base::scheduler()->wakeTask( m_repeatTask );
 	}
 
 
@@ -465,7 +475,7 @@ namespace wg
 	void InputHandler::_processButtonRelease( MouseButton button, int64_t timestamp )
 	{
 		if( timestamp == 0 )
-			timestamp = m_timeStamp;
+			timestamp = Base::scheduler()->time();
 
 
 		// Post BUTTON_RELEASE events for widget that was pressed
@@ -568,7 +578,7 @@ namespace wg
 
 	void InputHandler::_setFocused( Widget * pWidget )
 	{
-		FocusGainedMsg_p pMsg = new FocusGainedMsg( m_inputId, pWidget, m_modKeys, m_pointerPos, m_timeStamp );
+		FocusGainedMsg_p pMsg = new FocusGainedMsg( m_inputId, pWidget, m_modKeys, m_pointerPos, Base::scheduler()->time() );
 		Base::msgRouter()->post( pMsg );
 	}
 
@@ -576,7 +586,7 @@ namespace wg
 
 	void InputHandler::_setUnfocused( Widget * pWidget )
 	{
-		FocusLostMsg_p pMsg = new FocusLostMsg( m_inputId, pWidget, m_modKeys, m_pointerPos, m_timeStamp );
+		FocusLostMsg_p pMsg = new FocusLostMsg( m_inputId, pWidget, m_modKeys, m_pointerPos, Base::scheduler()->time() );
 		Base::msgRouter()->post( pMsg );
 	}
 
@@ -594,7 +604,7 @@ namespace wg
 	void InputHandler::setKey( int nativeKeyCode, bool bPressed, int64_t timestamp )
 	{
 		if( timestamp == 0 )
-			timestamp = m_timeStamp;
+			timestamp = Base::scheduler()->time();
 
 		if( bPressed )
 			_processKeyPress( nativeKeyCode, timestamp );
@@ -628,6 +638,7 @@ namespace wg
 		info.pWidget = _focusedWidget();
 
 		m_keysDown.push_back( info );
+		Base::scheduler()->wakeTask( m_repeatTask );
 
 		// Post KEY_PRESS message
 
@@ -713,10 +724,12 @@ namespace wg
 
 	void InputHandler::setWheelRoll( int wheel, Coord distance, int64_t timestamp )
 	{
+		WG_TRACE_SCOPE("InputHandler::setWheelRoll");
+
 		if( m_pMarkedWidget )
 		{
 			if( timestamp == 0 )
-				timestamp = m_timeStamp;
+				timestamp = Base::scheduler()->time();
 			Base::msgRouter()->post( new WheelRollMsg( m_inputId, wheel, distance, m_pMarkedWidget.rawPtr(), m_modKeys, m_pointerPos, timestamp ) );
 		}
 	}
@@ -736,22 +749,29 @@ namespace wg
 
 	void InputHandler::receive( Msg * pMsg )
 	{
+	}
 
-		if( pMsg->type() == MsgType::Tick ) {
+	//____ _onRepeatTick() ___________________________________________________________
+	// Scheduler task posting button and key repeats. Sleeps until next repeat is due
+	// and is woken when a button or key is pressed.
 
-			int64_t timestamp = TickMsg::cast(pMsg)->timestamp();
+	int InputHandler::_onRepeatTick( int64_t timestamp )
+	{
+		int64_t nextButtonRepeat = _handleButtonRepeats( timestamp );
+		int64_t nextKeyRepeat = _handleKeyRepeats( timestamp );
 
-			_handleButtonRepeats( timestamp );
-			_handleKeyRepeats( timestamp );
+		m_timeStamp = timestamp;
 
-			m_timeStamp = timestamp;
-		}
+		int64_t next = nextButtonRepeat < 0 ? nextKeyRepeat : nextKeyRepeat < 0 ? nextButtonRepeat : std::min( nextButtonRepeat, nextKeyRepeat );
+		return next < 0 ? -1 : int(next - timestamp);
 	}
 
 	//____ _handleButtonRepeats() _________________________________________
 
-	void InputHandler::_handleButtonRepeats( int64_t timestamp )
+	int64_t InputHandler::_handleButtonRepeats( int64_t timestamp )
 	{
+		int64_t next = -1;
+
 		for( int button = 0 ; button < MouseButton_size ; button++ )
 		{
 			if( m_bButtonPressed[button] )
@@ -768,17 +788,23 @@ namespace wg
 				{
 					auto p = MouseRepeatMsg::create(m_inputId, (MouseButton)button, m_latestPressWidgets[button].rawPtr(), m_modKeys, m_pointerPos, repeatPos);
 					Base::msgRouter()->post(p);
-					repeatPos += m_keyRepeatRate;
+					repeatPos += m_buttonRepeatRate;
 				}
+
+				if( next < 0 || repeatPos < next )
+					next = repeatPos;
 			}
 		}
+		return next;
 	}
 
 
 	//____ _handleKeyRepeats() _________________________________________
 
-	void InputHandler::_handleKeyRepeats( int64_t timestamp )
+	int64_t InputHandler::_handleKeyRepeats( int64_t timestamp )
 	{
+		int64_t next = -1;
+
 		for( auto key : m_keysDown )
 		{
 			int64_t firstRepeat = key.pressTimestamp + m_keyRepeatDelay;
@@ -799,7 +825,11 @@ namespace wg
 
 				repeatPos += m_keyRepeatRate;
 			}
+
+			if( next < 0 || repeatPos < next )
+				next = repeatPos;
 		}
+		return next;
 	}
 
 
@@ -132,11 +132,13 @@ namespace wg
 
 		void		_processButtonPress( MouseButton button, int64_t timestamp );
 		void		_processButtonRelease( MouseButton button, int64_t timestamp );
-		void		_handleButtonRepeats( int64_t timestamp );
+		int64_t		_handleButtonRepeats( int64_t timestamp );
 
 		void 		_processKeyPress( int nativeKeyCode, int64_t timestamp );
 		void 		_processKeyRelease( int nativeKeyCode, int64_t timestamp );
-		void		_handleKeyRepeats( int64_t timestamp );
+		int64_t		_handleKeyRepeats( int64_t timestamp );
+
+		int			_onRepeatTick( int64_t timestamp );
 
 
 		bool		_focusChanged( RootPanel * pRoot, Widget * pOldFocused, Widget * pNewFocused );
@@ -153,8 +155,8 @@ namespace wg
 
 
 		char			m_inputId;
-		RouteId			m_tickRoute;
-		int64_t			m_timeStamp;
+		TaskId			m_repeatTask;
+		int64_t			m_timeStamp;		// Time of latest check for repeats.
 
 		Coord			m_pointerPos;
 
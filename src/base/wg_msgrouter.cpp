@@ -26,6 +26,7 @@
 #include <wg_base.h>
 #include <wg_rootpanel.h>
 #include <wg_panel.h>
+#include <wg_trace.h>
 
 namespace wg
 {
@@ -404,6 +405,8 @@ namespace wg
 
 	void MsgRouter::dispatch()
 	{
+		WG_TRACE_SCOPE("MsgRouter::dispatch");
+
 		m_bIsProcessing = true;
 
 		m_insertPos = m_msgQueue.begin();	// Insert any POINTER_ENTER/EXIT right at beginning.
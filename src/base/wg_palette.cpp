@@ -0,0 +1,165 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_palette.h>
+
+#include <cstring>
+#include <cassert>
+#include <thread>
+#include <unordered_map>
+
+namespace wg
+{
+	namespace
+	{
+		// Palettes alive, by content hash. Never destroyed since palettes
+		// kept by static objects can outlive other statics.
+
+		std::unordered_multimap<uint64_t, Palette*>& palettes()
+		{
+			static auto * pPalettes = new std::unordered_multimap<uint64_t, Palette*>();
+			return *pPalettes;
+		}
+
+		// Thread the palettes belong to. Taken over by whichever thread
+		// creates a palette while the pool is empty.
+
+		std::thread::id	s_ownerThread;
+	}
+
+	const char Palette::CLASSNAME[] = {"Palette"};
+
+	//____ create() _______________________________________________________________
+	/**
+	 * @brief Get palette with specified colors.
+	 *
+	 * @param pColors	Pointer at 256 colors.
+	 *
+	 * @return Already existing palette with identical colors if there is one,
+	 *		   otherwise a new palette. Nullptr if pColors is null.
+	 *
+	 * Must only be called from the thread using the surfaces, since the palette
+	 * returned might be shared with any other surface. Calls from any other thread
+	 * than the one owning the palettes alive are asserted.
+	 */
+
+	Palette_p Palette::create( const Color * pColors )
+	{
+		if( !pColors )
+			return nullptr;
+
+		if( palettes().empty() )
+			s_ownerThread = std::this_thread::get_id();
+
+		assert( std::this_thread::get_id() == s_ownerThread );
+
+		uint64_t hash = _hash( pColors );
+
+		auto range = palettes().equal_range( hash );
+		for( auto it = range.first ; it != range.second ; ++it )
+		{
+			if( std::memcmp( it->second->m_colors, pColors, sizeof(m_colors) ) == 0 )
+				return Palette_p( it->second );
+		}
+
+		return Palette_p( new Palette( pColors, hash ) );
+	}
+
+	//____ Constructor ____________________________________________________________
+
+	Palette::Palette( const Color * pColors, uint64_t hash ) : m_hash(hash)
+	{
+		std::memcpy( m_colors, pColors, sizeof(m_colors) );
+		palettes().emplace( hash, this );
+	}
+
+	//____ Destructor _____________________________________________________________
+
+	Palette::~Palette()
+	{
+		assert( std::this_thread::get_id() == s_ownerThread );
+
+		auto range = palettes().equal_range( m_hash );
+		for( auto it = range.first ; it != range.second ; ++it )
+		{
+			if( it->second == this )
+			{
+				palettes().erase( it );
+				break;
+			}
+		}
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool Palette::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * Palette::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	Palette_p Palette::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return Palette_p( static_cast<Palette*>(pObject) );
+
+		return 0;
+	}
+
+	//____ nbPalettes() ___________________________________________________________
+	/**
+	 * @brief Get number of palettes currently alive.
+	 */
+
+	int Palette::nbPalettes()
+	{
+		return (int) palettes().size();
+	}
+
+	//____ _hash() ________________________________________________________________
+	// FNV-1a over the raw color data.
+
+	uint64_t Palette::_hash( const Color * pColors )
+	{
+		const uint8_t * p = reinterpret_cast<const uint8_t*>(pColors);
+
+		uint64_t hash = 14695981039346656037ULL;
+		for( size_t i = 0 ; i < sizeof(Color)*c_nbColors ; i++ )
+		{
+			hash ^= p[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+} // namespace wg
@@ -0,0 +1,89 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef	WG_PALETTE_DOT_H
+#define	WG_PALETTE_DOT_H
+#pragma once
+
+#include <wg_pointers.h>
+#include <wg_color.h>
+
+namespace wg
+{
+
+	class Palette;
+	typedef	StrongPtr<Palette>	Palette_p;
+	typedef	WeakPtr<Palette>	Palette_wp;
+
+
+	/**
+	 * @brief Reference counted, shared color lookup table of indexed surfaces.
+	 *
+	 * A Palette holds the 256 colors of the CLUT used by indexed surfaces. Palettes
+	 * are immutable and pooled by content, so creating a Palette with the same colors
+	 * as one that already exists returns the existing one. Surfaces created with
+	 * identical CLUTs therefore share a single Palette instead of keeping a copy each.
+	 *
+	 * The pool is not guarded by any lock and, like all objects, palettes are reference
+	 * counted without atomic operations. Palettes, and therefore indexed surfaces,
+	 * may only be created and released on the thread that uses the surfaces, which is
+	 * asserted.
+	 */
+
+	class Palette : public Object
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		static Palette_p	create( const Color * pColors );
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static Palette_p	cast( Object * pObject );
+
+		//.____ Content _______________________________________________________
+
+		inline const Color *	colors() const { return m_colors; }		///< @brief Get pointer to the 256 colors of the palette.
+		inline Color			color( int index ) const { return m_colors[index & 0xFF]; }
+		inline uint64_t			hash() const { return m_hash; }
+
+		//.____ Misc __________________________________________________________
+
+		static int			nbPalettes();
+
+		const static int	c_nbColors = 256;
+
+	protected:
+		Palette( const Color * pColors, uint64_t hash );
+		virtual ~Palette();
+
+		static uint64_t		_hash( const Color * pColors );
+
+		Color		m_colors[c_nbColors];
+		uint64_t	m_hash;
+	};
+
+
+} // namespace wg
+#endif //WG_PALETTE_DOT_H
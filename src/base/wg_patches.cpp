@@ -20,7 +20,9 @@
 
 =========================================================================*/
 #include <memory.h>
+#include <algorithm>
 #include <wg_patches.h>
+#include <wg_bandedpatches.h>
 
 namespace wg
 {
@@ -78,6 +80,15 @@ namespace wg
 		}
 	}
 
+	Patches::Patches(const BandedPatches& source, const Rect& trim)
+	{
+		m_pFirst = 0;
+		m_size = 0;
+		m_capacity = 0;
+		m_bOwnsArray = true;
+
+		trimPush(source, trim);
+	}
 
 
 	//____ Destructor ______________________________________________________________
@@ -408,6 +419,28 @@ namespace wg
 
 
 
+	void Patches::trimPush(const BandedPatches& source, const Rect& trim)
+	{
+		int x1 = trim.x;
+		int x2 = trim.x + trim.w;
+		int y2 = trim.y + trim.h;
+
+		auto& bands = source.m_bands;
+
+		for (int i = source._firstBand(trim.y); i < (int) bands.size() && bands[i].y1 < y2; i++)
+		{
+			auto& band = bands[i];
+			int top = std::max(band.y1, trim.y);
+			int height = std::min(band.y2, y2) - top;
+
+			for (int s = BandedPatches::_firstSpan(band.spans, x1); s < (int) band.spans.size() && band.spans[s].x1 < x2; s++)
+			{
+				int left = std::max(band.spans[s].x1, x1);
+				push(Rect(left, top, std::min(band.spans[s].x2, x2) - left, height));
+			}
+		}
+	}
+
 	//____ remove() ________________________________________________________________
 
 	void  Patches::remove( int ofs )
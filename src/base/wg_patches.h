@@ -29,6 +29,7 @@
 
 namespace wg
 {
+	class BandedPatches;
 
 	class Patches
 	{
@@ -41,6 +42,7 @@ namespace wg
 		Patches( Rect * pArray, int capacity );
 		Patches(const Patches& source);
 		Patches(const Patches& source, const Rect& trim);
+		Patches(const BandedPatches& source, const Rect& trim);
 		~Patches();
 
 		//.____ Control ________________________________________________________
@@ -60,6 +62,7 @@ namespace wg
 		inline Rect		pop();																// Pops last rect from the patches.
 
 		void			trimPush(const Patches& source, const Rect& trim);					// Adds the rect (no optimizations, overlap may occur).
+		void			trimPush(const BandedPatches& source, const Rect& trim);			// Only visits bands and spans within trim.
 
 		void			remove( int ofs );													// Deletes specific rect from the patches.
 		int				remove( int ofs, int len );											// Deletes range of rects from the patches.
@@ -0,0 +1,577 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_resbundle.h>
+#include <wg_resdb.h>
+#include <wg_bitmapfont.h>
+#include <wg_util.h>
+#include <wg_enumextras.h>
+
+#include <string.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace wg
+{
+
+	const char ResBundle::CLASSNAME[] = {"ResBundle"};
+
+	//____ open() _________________________________________________________________
+	/**
+	 * @brief Open a bundle file.
+	 *
+	 * The file is memory mapped where supported, otherwise read into memory.
+	 *
+	 * @return The bundle or nullptr if the file could not be opened or is not
+	 * a valid bundle.
+	 */
+
+	ResBundle_p ResBundle::open( const char * pPath )
+	{
+		Blob_p pData;
+
+#ifdef _WIN32
+		FILE * fp = fopen( pPath, "rb" );
+		if( !fp )
+			return nullptr;
+
+		fseek( fp, 0, SEEK_END );
+		long size = ftell( fp );
+		fseek( fp, 0, SEEK_SET );
+
+		pData = Blob::create( (int) size );
+		size_t nRead = fread( pData->data(), 1, size, fp );
+		fclose( fp );
+
+		if( nRead != (size_t) size )
+			return nullptr;
+#else
+		int fd = ::open( pPath, O_RDONLY );
+		if( fd < 0 )
+			return nullptr;
+
+		struct stat info;
+		if( fstat( fd, &info ) != 0 || info.st_size < (off_t) sizeof(Header) || info.st_size > 0x7FFFFFFF )
+		{
+			close( fd );
+			return nullptr;
+		}
+
+		size_t size = (size_t) info.st_size;
+
+		// Private mapping, so that writes to surfaces never reach the file.
+
+		void * pMem = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+		close( fd );
+
+		if( pMem == MAP_FAILED )
+			return nullptr;
+
+		pData = Blob::create( pMem, (int) size, [pMem,size]() { munmap( pMem, size ); } );
+#endif
+
+		return create( pData );
+	}
+
+	//____ create() _______________________________________________________________
+	/**
+	 * @brief Create bundle from data already in memory.
+	 *
+	 * The data must stay unmodified while the bundle or any surface created from it is alive.
+	 *
+	 * @return The bundle or nullptr if the data is not a valid bundle.
+	 */
+
+	ResBundle_p ResBundle::create( Blob * pData )
+	{
+		if( !pData || pData->size() < (int) sizeof(Header) )
+			return nullptr;
+
+		ResBundle_p p( new ResBundle( pData ) );
+		if( !p->_validate() )
+			return nullptr;
+
+		return p;
+	}
+
+	//____ Constructor ____________________________________________________________
+
+	ResBundle::ResBundle( Blob * pData ) : m_pData(pData)
+	{
+		m_pBase = (const uint8_t*) pData->data();
+		m_size = (uint32_t) pData->size();
+		m_nEntries = (int) ((const Header*) m_pBase)->nEntries;
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool ResBundle::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * ResBundle::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	ResBundle_p ResBundle::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return ResBundle_p( static_cast<ResBundle*>(pObject) );
+
+		return 0;
+	}
+
+	//____ entryType() ____________________________________________________________
+
+	ResBundle::EntryType ResBundle::entryType( int index ) const
+	{
+		return (EntryType) _entry(index)->type;
+	}
+
+	//____ entryId() ______________________________________________________________
+
+	const char * ResBundle::entryId( int index ) const
+	{
+		return _string( _entry(index)->idOffset );
+	}
+
+	//____ findEntry() ____________________________________________________________
+	/**
+	 * @brief Find index of entry with given type and id.
+	 *
+	 * @return Index of entry or -1 if not found.
+	 */
+
+	int ResBundle::findEntry( EntryType type, const char * pId ) const
+	{
+		for( int i = 0 ; i < m_nEntries ; i++ )
+		{
+			const Entry * pEntry = _entry(i);
+			if( pEntry->type == (uint32_t) type && strcmp( _string(pEntry->idOffset), pId ) == 0 )
+				return i;
+		}
+		return -1;
+	}
+
+	//____ createSurface() ________________________________________________________
+	/**
+	 * @brief Create surface from a surface entry.
+	 *
+	 * The surface is created through the Blob path of the factory on top of the bundle
+	 * data. Factories that use the Blob as it is, like SoftSurfaceFactory, neither decode
+	 * nor copy any pixels.
+	 */
+
+	Surface_p ResBundle::createSurface( int index, SurfaceFactory * pFactory, int flags ) const
+	{
+		if( index < 0 || index >= m_nEntries || !pFactory )
+			return nullptr;
+
+		const Entry * pEntry = _entry(index);
+		if( pEntry->type != (uint32_t) EntryType::Surface )
+			return nullptr;
+
+		const SurfaceData * pSurf = (const SurfaceData*) (m_pBase + pEntry->dataOffset);
+
+		// Sub-blob keeping the whole bundle alive for as long as the surface needs its pixels.
+
+		Blob_p pBundleData = m_pData;
+		Blob_p pPixels = Blob::create( (void*) (m_pBase + pSurf->pixelOffset), (int) (pSurf->pitch * pSurf->height), [pBundleData]() {} );
+
+		const Color * pClut = pSurf->clutOffset ? (const Color*) (m_pBase + pSurf->clutOffset) : nullptr;
+
+		return pFactory->createSurface( Size(pSurf->width, pSurf->height), (PixelFormat) pSurf->format, pPixels, (int) pSurf->pitch, flags, pClut );
+	}
+
+	//____ color() ________________________________________________________________
+
+	Color ResBundle::color( int index ) const
+	{
+		if( index < 0 || index >= m_nEntries )
+			return Color::Black;
+
+		const Entry * pEntry = _entry(index);
+		if( pEntry->type != (uint32_t) EntryType::Color )
+			return Color::Black;
+
+		return Color( *(const uint32_t*) (m_pBase + pEntry->dataOffset) );
+	}
+
+	//____ addToResDb() ___________________________________________________________
+	/**
+	 * @brief Add all resources of the bundle to a ResDB.
+	 *
+	 * Fonts are created from the surfaces of this bundle, never from surfaces
+	 * with the same id already in the ResDB.
+	 *
+	 * @return False if any resource could not be created or added.
+	 */
+
+	bool ResBundle::addToResDb( ResDB * pDB, SurfaceFactory * pFactory ) const
+	{
+		if( !pDB || !pFactory )
+			return false;
+
+		bool bOk = true;
+		std::vector<Surface_p>	surfaces( m_nEntries );
+
+		for( int i = 0 ; i < m_nEntries ; i++ )
+		{
+			switch( entryType(i) )
+			{
+				case EntryType::Surface:
+					surfaces[i] = createSurface( i, pFactory );
+					bOk &= surfaces[i] && pDB->addSurface( entryId(i), surfaces[i], "" );
+					break;
+				case EntryType::Color:
+					bOk &= pDB->addColor( entryId(i), color(i) );
+					break;
+				default:
+					break;
+			}
+		}
+
+		for( int i = 0 ; i < m_nEntries ; i++ )
+		{
+			if( entryType(i) != EntryType::BitmapFont )
+				continue;
+
+			const FontData * pFont = (const FontData*) (m_pBase + _entry(i)->dataOffset);
+
+			int surfIndex = findEntry( EntryType::Surface, _string(pFont->surfaceIdOffset) );
+			if( surfIndex < 0 || !surfaces[surfIndex] )
+			{
+				bOk = false;
+				continue;
+			}
+
+			// BitmapFont wants a writable spec.
+
+			const char * pSpec = _string(pFont->specOffset);
+			std::vector<char> spec( pSpec, pSpec + strlen(pSpec) + 1 );
+
+			bOk &= pDB->addFont( entryId(i), BitmapFont::create( surfaces[surfIndex], spec.data() ) );
+		}
+
+		return bOk;
+	}
+
+	//____ _entry() _______________________________________________________________
+
+	const ResBundle::Entry * ResBundle::_entry( int index ) const
+	{
+		const Header * pHeader = (const Header*) m_pBase;
+		return ((const Entry*) (m_pBase + pHeader->entryOffset)) + index;
+	}
+
+	//____ _string() ______________________________________________________________
+
+	const char * ResBundle::_string( uint32_t offset ) const
+	{
+		return (const char*) (m_pBase + offset);
+	}
+
+	//____ _validate() ____________________________________________________________
+	// Checks that everything we access later on stays inside the data.
+
+	bool ResBundle::_validate() const
+	{
+		const Header * pHeader = (const Header*) m_pBase;
+
+		if( memcmp( pHeader->magic, "WGRB", 4 ) != 0 || pHeader->version != c_version )
+			return false;
+
+		if( pHeader->entryOffset % 4 != 0 || pHeader->entryOffset > m_size ||
+			pHeader->nEntries > (m_size - pHeader->entryOffset) / sizeof(Entry) )
+			return false;
+
+		auto isString = [this]( uint32_t offset ) { return offset < m_size && memchr( m_pBase + offset, 0, m_size - offset ) != nullptr; };
+		auto isInside = [this]( uint64_t offset, uint64_t size ) { return offset + size <= m_size; };
+
+		for( int i = 0 ; i < m_nEntries ; i++ )
+		{
+			const Entry * pEntry = _entry(i);
+
+			if( !isString( pEntry->idOffset ) || pEntry->dataOffset % 4 != 0 || !isInside( pEntry->dataOffset, pEntry->dataSize ) )
+				return false;
+
+			switch( (EntryType) pEntry->type )
+			{
+				case EntryType::Surface:
+				{
+					if( pEntry->dataSize < sizeof(SurfaceData) )
+						return false;
+
+					const SurfaceData * pSurf = (const SurfaceData*) (m_pBase + pEntry->dataOffset);
+
+					PixelFormat format = (PixelFormat) pSurf->format;
+					if( format <= PixelFormat::Custom || format > PixelFormat_max )
+						return false;
+
+					PixelDescription desc;
+					Util::pixelFormatToDescription( format, desc );
+
+					if( pSurf->width <= 0 || pSurf->height <= 0 || pSurf->pitch % 4 != 0 ||
+						(uint64_t) pSurf->pitch < (uint64_t) pSurf->width * desc.bits / 8 ||
+						pSurf->pixelOffset % 16 != 0 || !isInside( pSurf->pixelOffset, (uint64_t) pSurf->pitch * pSurf->height ) )
+						return false;
+
+					if( pSurf->clutOffset == 0 ? desc.bIndexed : (pSurf->clutOffset % 4 != 0 || !isInside( pSurf->clutOffset, 256 * sizeof(Color) )) )
+						return false;
+					break;
+				}
+
+				case EntryType::Color:
+					if( pEntry->dataSize != sizeof(uint32_t) )
+						return false;
+					break;
+
+				case EntryType::BitmapFont:
+				{
+					if( pEntry->dataSize < sizeof(FontData) )
+						return false;
+
+					const FontData * pFont = (const FontData*) (m_pBase + pEntry->dataOffset);
+					if( !isString( pFont->surfaceIdOffset ) || !isString( pFont->specOffset ) )
+						return false;
+					break;
+				}
+
+				default:
+					return false;
+			}
+		}
+		return true;
+	}
+
+	//____ ResBundleWriter::addSurface() __________________________________________
+	/**
+	 * @brief Add a copy of the content of a surface.
+	 *
+	 * @return False if id already is taken by another surface or the surface could not be read.
+	 */
+
+	bool ResBundleWriter::addSurface( const std::string& id, Surface * pSurface )
+	{
+		if( !pSurface || _hasId( ResBundle::EntryType::Surface, id ) )
+			return false;
+
+		PixelFormat format = pSurface->pixelFormat();
+		if( format == PixelFormat::Unknown || format == PixelFormat::Custom )
+			return false;
+
+		const PixelDescription * pDesc = pSurface->pixelDescription();
+		Size size = pSurface->size();
+
+		int lineBytes = size.w * pDesc->bits / 8;
+		int pitch = (lineBytes + 3) & ~3;
+
+		const uint8_t * pPixels = pSurface->lock( AccessMode::ReadOnly );
+		if( !pPixels )
+			return false;
+
+		Item item;
+		item.type = ResBundle::EntryType::Surface;
+		item.id = id;
+		item.surface.width = size.w;
+		item.surface.height = size.h;
+		item.surface.format = (uint32_t) format;
+		item.surface.pitch = pitch;
+		item.surface.pixelOffset = 0;
+		item.surface.clutOffset = 0;
+		item.pixels.resize( pitch * size.h, 0 );
+
+		for( int y = 0 ; y < size.h ; y++ )
+			memcpy( item.pixels.data() + y * pitch, pPixels + y * pSurface->pitch(), lineBytes );
+
+		pSurface->unlock();
+
+		if( pSurface->clut() )
+			item.clut.assign( pSurface->clut(), pSurface->clut() + 256 );
+		else if( pDesc->bIndexed )
+			return false;
+
+		m_entries.push_back( std::move(item) );
+		return true;
+	}
+
+	//____ ResBundleWriter::addColor() ____________________________________________
+
+	bool ResBundleWriter::addColor( const std::string& id, Color color )
+	{
+		if( _hasId( ResBundle::EntryType::Color, id ) )
+			return false;
+
+		Item item;
+		item.type = ResBundle::EntryType::Color;
+		item.id = id;
+		item.color = color;
+		m_entries.push_back( std::move(item) );
+		return true;
+	}
+
+	//____ ResBundleWriter::addBitmapFont() _______________________________________
+	/**
+	 * @brief Add a bitmap font using a surface of the same bundle.
+	 *
+	 * The surface may be added before or after the font.
+	 */
+
+	bool ResBundleWriter::addBitmapFont( const std::string& id, const std::string& surfaceId, const std::string& glyphSpec )
+	{
+		if( _hasId( ResBundle::EntryType::BitmapFont, id ) )
+			return false;
+
+		Item item;
+		item.type = ResBundle::EntryType::BitmapFont;
+		item.id = id;
+		item.surfaceId = surfaceId;
+		item.glyphSpec = glyphSpec;
+		m_entries.push_back( std::move(item) );
+		return true;
+	}
+
+	//____ ResBundleWriter::clear() _______________________________________________
+
+	void ResBundleWriter::clear()
+	{
+		m_entries.clear();
+	}
+
+	//____ ResBundleWriter::build() _______________________________________________
+
+	Blob_p ResBundleWriter::build() const
+	{
+		std::vector<uint8_t>	data;
+
+		auto append = [&data]( const void * pData, size_t size, size_t align ) -> uint32_t
+		{
+			size_t offset = (data.size() + align - 1) / align * align;
+			data.resize( offset + size, 0 );
+			if( size )
+				memcpy( data.data() + offset, pData, size );
+			return (uint32_t) offset;
+		};
+
+		auto appendString = [&append]( const std::string& str ) -> uint32_t
+		{
+			return append( str.c_str(), str.length() + 1, 1 );
+		};
+
+		ResBundle::Header header;
+		memcpy( header.magic, "WGRB", 4 );
+		header.version = ResBundle::c_version;
+		header.nEntries = (uint32_t) m_entries.size();
+		header.entryOffset = sizeof(header);
+
+		append( &header, sizeof(header), 4 );
+
+		std::vector<ResBundle::Entry> entries( m_entries.size() );
+		append( entries.data(), entries.size() * sizeof(ResBundle::Entry), 4 );
+
+		for( size_t i = 0 ; i < m_entries.size() ; i++ )
+		{
+			const Item& item = m_entries[i];
+			ResBundle::Entry& entry = entries[i];
+
+			entry.type = (uint32_t) item.type;
+			entry.idOffset = appendString( item.id );
+
+			switch( item.type )
+			{
+				case ResBundle::EntryType::Surface:
+				{
+					ResBundle::SurfaceData surf = item.surface;
+					surf.pixelOffset = append( item.pixels.data(), item.pixels.size(), 16 );
+					surf.clutOffset = item.clut.empty() ? 0 : append( item.clut.data(), item.clut.size() * sizeof(Color), 4 );
+					entry.dataOffset = append( &surf, sizeof(surf), 4 );
+					entry.dataSize = sizeof(surf);
+					break;
+				}
+				case ResBundle::EntryType::Color:
+				{
+					uint32_t argb = item.color.argb;
+					entry.dataOffset = append( &argb, sizeof(argb), 4 );
+					entry.dataSize = sizeof(argb);
+					break;
+				}
+				case ResBundle::EntryType::BitmapFont:
+				{
+					ResBundle::FontData font;
+					font.surfaceIdOffset = appendString( item.surfaceId );
+					font.specOffset = appendString( item.glyphSpec );
+					entry.dataOffset = append( &font, sizeof(font), 4 );
+					entry.dataSize = sizeof(font);
+					break;
+				}
+			}
+		}
+
+		memcpy( data.data() + header.entryOffset, entries.data(), entries.size() * sizeof(ResBundle::Entry) );
+
+		Blob_p pBlob = Blob::create( (int) data.size() );
+		memcpy( pBlob->data(), data.data(), data.size() );
+		return pBlob;
+	}
+
+	//____ ResBundleWriter::save() ________________________________________________
+
+	bool ResBundleWriter::save( const char * pPath ) const
+	{
+		Blob_p pBlob = build();
+
+		FILE * fp = fopen( pPath, "wb" );
+		if( !fp )
+			return false;
+
+		size_t written = fwrite( pBlob->data(), 1, pBlob->size(), fp );
+		fclose( fp );
+
+		return written == (size_t) pBlob->size();
+	}
+
+	//____ ResBundleWriter::_hasId() ______________________________________________
+
+	bool ResBundleWriter::_hasId( ResBundle::EntryType type, const std::string& id ) const
+	{
+		for( auto& item : m_entries )
+			if( item.type == type && item.id == id )
+				return true;
+		return false;
+	}
+
+} // namespace wg
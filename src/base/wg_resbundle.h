@@ -0,0 +1,190 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_RESBUNDLE_DOT_H
+#define WG_RESBUNDLE_DOT_H
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <wg_pointers.h>
+#include <wg_blob.h>
+#include <wg_surface.h>
+#include <wg_surfacefactory.h>
+#include <wg_color.h>
+
+namespace wg
+{
+	class ResDB;
+
+	class ResBundle;
+	typedef	StrongPtr<ResBundle>	ResBundle_p;
+	typedef	WeakPtr<ResBundle>		ResBundle_wp;
+
+	//____ ResBundle __________________________________________________________
+	/**
+	 * @brief Packed binary bundle of resources, ready to use without decoding.
+	 *
+	 * A bundle holds surfaces, colors and bitmap fonts under string ids. Surfaces are
+	 * stored in the PixelFormat they are going to be used in, along with their CLUT, so
+	 * they can be created directly on top of the bundle data through the Blob path of
+	 * SurfaceFactory::createSurface(). For SoftSurfaces this means the pixels are used in
+	 * place with nothing decoded or copied.
+	 *
+	 * open() maps the bundle file into memory (copy-on-write, so surfaces can still be
+	 * written to). Surfaces created from the bundle keep the mapping alive.
+	 *
+	 * Bundles are created with ResBundleWriter. Pixel formats are stored by their
+	 * enum value, so bundles need to be rebuilt if PixelFormat changes.
+	 */
+
+	class ResBundle : public Object
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		static ResBundle_p	open( const char * pPath );
+		static ResBundle_p	create( Blob * pData );
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static ResBundle_p	cast( Object * pObject );
+
+		//.____ Content _______________________________________________
+
+		enum class EntryType : uint32_t
+		{
+			Surface = 1,
+			Color = 2,
+			BitmapFont = 3
+		};
+
+		inline int			nbEntries() const { return m_nEntries; }
+		EntryType			entryType( int index ) const;
+		const char *		entryId( int index ) const;
+		int					findEntry( EntryType type, const char * pId ) const;
+
+		Surface_p			createSurface( int index, SurfaceFactory * pFactory, int flags = SurfaceFlag::Static ) const;
+		Color				color( int index ) const;
+
+		//.____ Misc __________________________________________________
+
+		bool				addToResDb( ResDB * pDB, SurfaceFactory * pFactory ) const;
+
+		//.____ Internal ______________________________________________
+
+		static const uint32_t	c_version = 1;
+
+		struct Header				/** @private */
+		{
+			char		magic[4];			// "WGRB"
+			uint32_t	version;
+			uint32_t	nEntries;
+			uint32_t	entryOffset;
+		};
+
+		struct Entry				/** @private */
+		{
+			uint32_t	type;
+			uint32_t	idOffset;			// Zero-terminated id.
+			uint32_t	dataOffset;
+			uint32_t	dataSize;
+		};
+
+		struct SurfaceData			/** @private */
+		{
+			int32_t		width;
+			int32_t		height;
+			uint32_t	format;
+			uint32_t	pitch;				// Always a multiple of 4.
+			uint32_t	pixelOffset;		// 16-byte aligned.
+			uint32_t	clutOffset;			// 256 colors, or 0 if none.
+		};
+
+		struct FontData				/** @private */
+		{
+			uint32_t	surfaceIdOffset;	// Id of surface entry in same bundle.
+			uint32_t	specOffset;			// Zero-terminated glyph specification.
+		};
+
+	protected:
+		ResBundle( Blob * pData );
+		virtual ~ResBundle() {}
+
+		bool				_validate() const;
+		const char *		_string( uint32_t offset ) const;
+		const Entry *		_entry( int index ) const;
+
+		Blob_p				m_pData;
+		const uint8_t *		m_pBase;
+		uint32_t			m_size;
+		int					m_nEntries;
+	};
+
+	//____ ResBundleWriter ____________________________________________________
+	/**
+	 * @brief Builds a ResBundle.
+	 *
+	 * Surfaces are stored in their current PixelFormat. Convert them to the format
+	 * they should be used in before adding them.
+	 */
+
+	class ResBundleWriter
+	{
+	public:
+		//.____ Content _______________________________________________
+
+		bool				addSurface( const std::string& id, Surface * pSurface );
+		bool				addColor( const std::string& id, Color color );
+		bool				addBitmapFont( const std::string& id, const std::string& surfaceId, const std::string& glyphSpec );
+
+		inline int			nbEntries() const { return (int) m_entries.size(); }
+		void				clear();
+
+		//.____ Misc __________________________________________________
+
+		Blob_p				build() const;
+		bool				save( const char * pPath ) const;
+
+	private:
+		struct Item
+		{
+			ResBundle::EntryType	type;
+			std::string				id;
+			std::vector<uint8_t>	pixels;		// Surface rows, already padded to pitch.
+			std::vector<Color>		clut;
+			ResBundle::SurfaceData	surface;
+			Color					color;
+			std::string				surfaceId;
+			std::string				glyphSpec;
+		};
+
+		bool				_hasId( ResBundle::EntryType type, const std::string& id ) const;
+
+		std::vector<Item>	m_entries;
+	};
+
+} // namespace wg
+#endif //WG_RESBUNDLE_DOT_H
@@ -24,20 +24,132 @@
 #include <wg_resdb.h>
 //#include <wg_resources_xml.h>
 #include <wg_resloader.h>
+#include <wg_resbundle.h>
 #include <assert.h>
 #include <wg_font.h>
 #include <wg_surface.h>
 
+#include <wg_base.h>
+#include <wg_scheduler.h>
+#include <wg_util.h>
+
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
 namespace wg
 {
 
 	const char ResDB::CLASSNAME[] = {"ResDB"};
 
+	namespace
+	{
+		// Worker threads shared by all ResDBs for asynchronous loading. Threads are
+		// started on first use. Jobs still queued when the program ends are dropped.
+
+		class LoadPool
+		{
+		public:
+			LoadPool() : m_bStop(false) {}
+
+			~LoadPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_bStop = true;
+				}
+				m_cond.notify_all();
+
+				for( auto& thread : m_threads )
+					thread.join();
+			}
+
+			void post( std::function<void()> job )
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+
+					if( m_threads.empty() )
+					{
+						int nThreads = std::max( 1, (int) std::thread::hardware_concurrency() );
+						for( int i = 0 ; i < nThreads ; i++ )
+							m_threads.emplace_back( [this]() { _run(); } );
+					}
+
+					m_jobs.push_back( std::move(job) );
+				}
+				m_cond.notify_one();
+			}
+
+		private:
+			void _run()
+			{
+				while( true )
+				{
+					std::function<void()> job;
+					{
+						std::unique_lock<std::mutex> lock(m_mutex);
+						m_cond.wait( lock, [this]() { return m_bStop || !m_jobs.empty(); } );
+						if( m_bStop )
+							return;
+
+						job = std::move( m_jobs.front() );
+						m_jobs.pop_front();
+					}
+					job();
+				}
+			}
+
+			std::mutex							m_mutex;
+			std::condition_variable				m_cond;
+			std::deque<std::function<void()>>	m_jobs;
+			std::vector<std::thread>			m_threads;
+			bool								m_bStop;
+		};
+
+		LoadPool	s_loadPool;
+	}
+
+	//____ LoadJob ________________________________________________________________
+	// Everything but pRes is only touched by the worker until the job is finished.
+
+	struct ResDB::LoadJob
+	{
+		ResType			type;
+		Resource *		pRes;				// Placeholder to finalize. Cleared if removed before that.
+		std::string		file;
+		bool			bRequired;
+		ResLoader *		pLoader;
+
+		ResLoader::SurfaceData	surfaceData;
+		bool					bDecoded;
+		ResDB_p					pDb;
+	};
+
+	//____ LoadState ______________________________________________________________
+
+	struct ResDB::LoadState
+	{
+		std::mutex								mutex;
+		std::condition_variable					cond;
+		std::vector<std::shared_ptr<LoadJob>>	finished;
+		int										nRunning = 0;
+		bool									bCancelled = false;
+	};
+
 
 	//____ () _________________________________________________________
 
 	ResDB::ResDB() :
-		m_pResLoader(0)
+		m_pResLoader(0),
+		m_bIndexValid(false),
+		m_loadTask(0),
+		m_nLoadsTotal(0),
+		m_nLoadsDone(0),
+		m_nLoadsFailed(0)
 	{
 	}
 
@@ -46,6 +158,7 @@ namespace wg
 	ResDB::~ResDB()
 	{
 		clear();
+		_cancelLoading();
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -76,10 +189,48 @@ namespace wg
 	}
 
 
+	//____ Key::Key() ___________________________________________________________
+
+	ResDB::Key::Key( const char * pId ) :
+		m_pChars(pId),
+		m_length(strlen(pId)),
+		m_hash(hash(pId, m_length))
+	{
+	}
+
+	ResDB::Key::Key( const char * pId, size_t length ) :
+		m_pChars(pId),
+		m_length(length),
+		m_hash(hash(pId, length))
+	{
+	}
+
+	//____ Key::hash() ____________________________________________________________
+	/**
+	 * FNV-1a hash of the id, as used by the index.
+	 */
+
+	uint64_t ResDB::Key::hash( const char * pChars, size_t length )
+	{
+		uint64_t h = 14695981039346656037ULL;
+		for( size_t i = 0 ; i < length ; i++ )
+		{
+			h ^= (uint8_t) pChars[i];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
 	//____ () _________________________________________________________
 
 	void ResDB::clear()
 	{
+		for( ResDBRes * pRes = getFirstResDbRes() ; pRes ; pRes = pRes->next() )
+			_detach( pRes->res.rawPtr() );
+
+		for( auto& pJob : m_loadJobs )
+			pJob->pRes = 0;
+
 		// Clear the quick-reference maps
 
 		m_mapColors.clear();
@@ -113,18 +264,26 @@ namespace wg
 		m_connects.clear();
 		m_resDbs.clear();
 		m_dataSets.clear();
+
+		_invalidateIndex();
 	}
 
 	void ResDB::clearSurfaces()
 	{
+		for( auto& pJob : m_loadJobs )
+			if( pJob->type == ResType::Surface )
+				pJob->pRes = 0;
+
 		m_mapSurfaces.clear();
 		m_surfaces.clear();
+		_invalidateIndex();
 	}
 
 	void ResDB::clearWidgets()
 	{
 		m_mapWidgets.clear();
 		m_widgets.clear();
+		_invalidateIndex();
 	}
 
 	//____ () _________________________________________________________
@@ -202,6 +361,9 @@ namespace wg
 			ResDBRes* p = new ResDBRes(file, pDb, file, pMetaData);
 			m_resDbs.pushBack(p);
 			m_mapResDBs[file] = p;
+			if( p->res )
+				p->res->m_parents.push_back(this);
+			_invalidateIndex();
 			return true;
 		}
 		return false;
@@ -220,11 +382,174 @@ namespace wg
 			m_resDbs.pushBack(p);
 			if(file.size())
 				m_mapResDBs[file] = p;
+			if( p->res )
+				p->res->m_parents.push_back(this);
+			_invalidateIndex();
+			return true;
+		}
+		return false;
+	}
+
+	//____ addBundle() __________________________________________________________
+	/**
+	 * @brief Add all resources of a ResBundle file.
+	 *
+	 * The bundle is memory mapped and its surfaces created on top of the mapped
+	 * data through pFactory, see ResBundle.
+	 */
+
+	bool ResDB::addBundle( const std::string& file, SurfaceFactory * pFactory )
+	{
+		ResBundle_p pBundle = ResBundle::open( file.c_str() );
+		if( !pBundle )
+			return false;
+
+		return pBundle->addToResDb( this, pFactory );
+	}
+
+	//____ addResDbAsync() ______________________________________________________
+	/**
+	 * @brief Add a sub-database, parsed by the ResLoader on a worker thread.
+	 *
+	 * The entry for the database is added immediately, but its ResDB is set first
+	 * when the load is finalized by updateLoading(). Since the database is parsed
+	 * while we might be modified, it is parsed without access to our resources and
+	 * can not depend on them. Use addResDb() for databases that do.
+	 *
+	 * The database must not contain any indexed surfaces, see ResLoader.
+	 *
+	 * As with addResDb(), the entry is kept even if loading fails.
+	 */
+
+	bool ResDB::addResDbAsync( const std::string& file, MetaData * pMetaData )
+	{
+		if(getResDbRes(file) == 0 && m_pResLoader)
+		{
+			ResDBRes* p = new ResDBRes(file, ResDB_p(), file, pMetaData);
+			m_resDbs.pushBack(p);
+			m_mapResDBs[file] = p;
+			_invalidateIndex();
+			_startLoad( ResType::ResDb, p, file, false );
+			return true;
+		}
+		return false;
+	}
+
+	//____ addSurfaceAsync() ______________________________________________________
+	/**
+	 * @brief Add a surface, decoded by the ResLoader on a worker thread.
+	 *
+	 * The SurfaceRes is added immediately as a placeholder with no surface, so it can
+	 * be looked up and referenced right away. The surface itself is created through the
+	 * SurfaceFactory of the ResLoader when the load is finalized by updateLoading(), on
+	 * the thread owning this ResDB. If loading fails the placeholder is removed.
+	 */
+
+	bool ResDB::addSurfaceAsync( const std::string& id, const std::string& file, MetaData * pMetaData, bool bRequired )
+	{
+		assert(m_mapSurfaces.find(id) == m_mapSurfaces.end());
+
+		if(m_mapSurfaces.find(id) == m_mapSurfaces.end() && m_pResLoader)
+		{
+			SurfaceRes* p = new SurfaceRes(id, Surface_p(), file, pMetaData);
+			m_surfaces.pushBack(p);
+			if(id.size())
+				m_mapSurfaces[id] = p;
+			_added( ResType::Surface, p, 0 );
+			_startLoad( ResType::Surface, p, file, bRequired );
 			return true;
 		}
 		return false;
 	}
 
+	//____ updateLoading() ________________________________________________________
+	/**
+	 * @brief Finalize asynchronous loads that the workers are done with.
+	 *
+	 * Called automatically on each tick of the Scheduler while loads are pending,
+	 * but can be called directly for faster response. Calls the load callback if
+	 * anything was finalized.
+	 *
+	 * @return Number of loads still pending.
+	 */
+
+	int ResDB::updateLoading()
+	{
+		if( !m_pLoadState )
+			return 0;
+
+		std::vector<std::shared_ptr<LoadJob>> finished;
+		{
+			std::lock_guard<std::mutex> lock(m_pLoadState->mutex);
+			finished.swap( m_pLoadState->finished );
+		}
+
+		if( finished.empty() )
+			return (int) m_loadJobs.size();
+
+		for( auto& pJob : finished )
+		{
+			_finalizeLoad( pJob.get() );
+			m_loadJobs.erase( std::find( m_loadJobs.begin(), m_loadJobs.end(), pJob ) );
+			m_nLoadsDone++;
+		}
+
+		int nPending = (int) m_loadJobs.size();
+		int done = m_nLoadsDone;
+		int total = m_nLoadsTotal;
+
+		if( nPending == 0 )
+		{
+			m_nLoadsDone = 0;
+			m_nLoadsTotal = 0;
+			Base::scheduler()->removeTask( m_loadTask );
+			m_loadTask = 0;
+		}
+
+		// Callback last, it might release us.
+
+		if( m_loadCallback )
+		{
+			std::function<void(int,int)> callback = m_loadCallback;
+			callback( done, total );
+		}
+
+		return nPending;
+	}
+
+	//____ finishLoading() ________________________________________________________
+	/**
+	 * @brief Block until all asynchronous loads are done and finalized.
+	 *
+	 * The load callback must not release the ResDB while we are waiting.
+	 */
+
+	void ResDB::finishLoading()
+	{
+		while( !m_loadJobs.empty() )
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_pLoadState->mutex);
+				m_pLoadState->cond.wait( lock, [this]() { return !m_pLoadState->finished.empty(); } );
+			}
+			updateLoading();
+		}
+	}
+
+	//____ setLoadCallback() ______________________________________________________
+	/**
+	 * @brief Set callback reporting progress of asynchronous loads.
+	 *
+	 * The callback is called from updateLoading() with the number of loads done and the
+	 * total number of loads started since we last were idle. All loads are done when the
+	 * two are equal. Loads that failed count as done, see loadsFailed().
+	 */
+
+	void ResDB::setLoadCallback( std::function<void(int done, int total)> callback )
+	{
+		m_loadCallback = callback;
+	}
+
 	bool ResDB::addSurface( const std::string& id, const std::string& file, MetaData * pMetaData, bool bRequired )
 	{
 		assert(m_mapSurfaces.find(id) == m_mapSurfaces.end());
@@ -239,6 +564,7 @@ namespace wg
 			m_surfaces.pushBack(p);
 			if(id.size())
 				m_mapSurfaces[id] = p;
+			_added( ResType::Surface, p, pSurface.rawPtr() );
 			return true;
 		}
 		return false;
@@ -255,6 +581,7 @@ namespace wg
 			m_surfaces.pushBack(p);
 			if(id.size())
 				m_mapSurfaces[id] = p;
+			_added( ResType::Surface, p, pSurface );
 			return true;
 		}
 		return false;
@@ -273,6 +600,7 @@ namespace wg
 			m_fonts.pushBack(p);
 			if(id.size())
 				m_mapFonts[id] = p;
+			_added( ResType::Font, p, pFont );
 			return true;
 		}
 		return false;
@@ -289,6 +617,7 @@ namespace wg
 			m_gfxAnims.pushBack(p);
 			if(id.size())
 				m_mapGfxAnims[id] = p;
+			_added( ResType::GfxAnim, p, pAnim );
 			return true;
 		}
 		return false;
@@ -305,6 +634,7 @@ namespace wg
 			m_carets.pushBack(p);
 			if(id.size())
 				m_mapCarets[id] = p;
+			_added( ResType::Caret, p, pCaret );
 			return true;
 		}
 		return false;
@@ -321,6 +651,7 @@ namespace wg
 			m_textProps.pushBack(p);
 			if(id.size())
 				m_mapTextStyles[id] = p;
+			_added( ResType::TextStyle, p, pProp );
 			return true;
 		}
 		return false;
@@ -337,6 +668,7 @@ namespace wg
 			m_colors.pushBack(p);
 			if(id.size())
 				m_mapColors[id] = p;
+			_added( ResType::Color, p, 0 );
 			return true;
 		}
 		return false;
@@ -353,6 +685,7 @@ namespace wg
 			m_legos.pushBack(p);
 			if(id.size())
 				m_mapLegoSources[id] = p;
+			_added( ResType::LegoSource, p, 0 );
 			return true;
 		}
 		return false;
@@ -374,6 +707,7 @@ namespace wg
 			m_skins.pushBack(p);
 			if(id.size())
 				m_mapSkins[id] = p;
+			_added( ResType::Skin, p, pSkin );
 			return true;
 		}
 		return false;
@@ -390,6 +724,7 @@ namespace wg
 			m_dataSets.pushBack(p);
 			if(id.size())
 				m_mapDataSets[id] = p;
+			_added( ResType::DataSet, p, 0 );
 			return true;
 		}
 		return false;
@@ -407,6 +742,7 @@ namespace wg
 			m_widgets.pushBack(p);
 			if(id.size())
 				m_mapWidgets[id] = p;
+			_added( ResType::Widget, p, pWidget );
 			return true;
 		}
 		return false;
@@ -419,12 +755,13 @@ namespace wg
 	{
 		ConnectRes* p = new ConnectRes(pMetaData);
 		m_connects.pushBack(p);
+		_added( ResType::Connect, p, 0 );
 		return true;
 	}
 
 	//____ () _________________________________________________________
 
-	Surface_p ResDB::getSurface( const std::string& id ) const
+	Surface_p ResDB::getSurface( const Key& id ) const
 	{
 		SurfaceRes* surfRes = getResSurface(id);
 		return surfRes ? surfRes->res : Surface_p();
@@ -433,7 +770,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Font_p ResDB::getFont( const std::string& id ) const
+	Font_p ResDB::getFont( const Key& id ) const
 	{
 		FontRes* fontRes = getResFont(id);
 		return fontRes ? fontRes->res : Font_p();
@@ -441,7 +778,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	GfxAnim_p ResDB::getGfxAnim( const std::string& id ) const
+	GfxAnim_p ResDB::getGfxAnim( const Key& id ) const
 	{
 		GfxAnimRes* animRes = getResGfxAnim(id);
 		return animRes ? animRes->res : GfxAnim_p();
@@ -449,7 +786,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Caret_p ResDB::getCaret( const std::string& id ) const
+	Caret_p ResDB::getCaret( const Key& id ) const
 	{
 		CaretRes* caretRes = getResCaret(id);
 		return caretRes ? caretRes->res : Caret_p();
@@ -457,7 +794,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	TextStyle_p ResDB::getTextStyle( const std::string& id ) const
+	TextStyle_p ResDB::getTextStyle( const Key& id ) const
 	{
 		TextStyleRes* propRes = getResTextStyle(id);
 		return propRes ? propRes->res : TextStyle_p();
@@ -465,7 +802,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Color ResDB::getColor( const std::string& id ) const
+	Color ResDB::getColor( const Key& id ) const
 	{
 		ColorRes* colorRes = getResColor(id);
 		return colorRes ? colorRes->res : Color::Black;
@@ -473,7 +810,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Skin_p ResDB::getSkin( const std::string& id ) const
+	Skin_p ResDB::getSkin( const Key& id ) const
 	{
 		SkinRes* skinRes = getResSkin(id);
 		return skinRes ? skinRes->res : Skin_p();
@@ -481,7 +818,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	ResDB::MetaData * ResDB::getDataSet( const std::string& id ) const
+	ResDB::MetaData * ResDB::getDataSet( const Key& id ) const
 	{
 		DataSetRes* dataSetRes = getResDataSet(id);
 		return dataSetRes ? dataSetRes->meta : 0;
@@ -489,7 +826,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Widget_p ResDB::getWidget( const std::string& id ) const
+	Widget_p ResDB::getWidget( const Key& id ) const
 	{
 		WidgetRes* widgetRes = getResWidget(id);
 		return widgetRes ? widgetRes->res : Widget_p();
@@ -497,7 +834,7 @@ namespace wg
 
 	//____ () _________________________________________________________
 
-	Widget_p ResDB::cloneWidget( const std::string& id ) const
+	Widget_p ResDB::cloneWidget( const Key& id ) const
 	{
 		WidgetRes* widgetRes = getResWidget(id);
 
@@ -508,377 +845,161 @@ namespace wg
 		return pWidget->clone();
 	}
 
-	//____ () _________________________________________________________
+	//____ getResDbRes() __________________________________________________________
 
-	ResDB::ResDBRes * ResDB::getResDbRes( const std::string& id ) const
+	ResDB::ResDBRes * ResDB::getResDbRes( const Key& id ) const
 	{
-		for(ResDBRes* res = getFirstResDbRes(); res; res = res->next())
-		{
-			if(res->file == id)
-				return res;
-			if(res->res)
-			{
-				ResDB::ResDBRes * pDb = res->res->getResDbRes(id);
-				if(pDb)
-					return pDb;
-			}
-		}
-		return 0;
+		return static_cast<ResDBRes*>( _lookup( ResType::ResDb, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResSurface() ________________________________________________________
 
-	ResDB::SurfaceRes * ResDB::getResSurface( const std::string& id ) const
+	ResDB::SurfaceRes * ResDB::getResSurface( const Key& id ) const
 	{
-		SurfaceRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResSurface(id)))
-					return res;
-			}
-		}
-		SurfMap::const_iterator it = m_mapSurfaces.find(id);
-		return it == m_mapSurfaces.end() ? 0 : it->second;
+		return static_cast<SurfaceRes*>( _lookup( ResType::Surface, id ) );
 	}
 
+	//____ getResFont() ___________________________________________________________
 
-	//____ () _________________________________________________________
-
-	ResDB::FontRes * ResDB::getResFont( const std::string& id ) const
+	ResDB::FontRes * ResDB::getResFont( const Key& id ) const
 	{
-		FontRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResFont(id)))
-					return res;
-			}
-		}
-		FontMap::const_iterator it = m_mapFonts.find(id);
-		return it == m_mapFonts.end() ? 0 : it->second;
+		return static_cast<FontRes*>( _lookup( ResType::Font, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResGfxAnim() ________________________________________________________
 
-	ResDB::GfxAnimRes * ResDB::getResGfxAnim( const std::string& id ) const
+	ResDB::GfxAnimRes * ResDB::getResGfxAnim( const Key& id ) const
 	{
-		GfxAnimRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResGfxAnim(id)))
-					return res;
-			}
-		}
-		GfxAnimMap::const_iterator it = m_mapGfxAnims.find(id);
-		return it == m_mapGfxAnims.end() ? 0 : it->second;
+		return static_cast<GfxAnimRes*>( _lookup( ResType::GfxAnim, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResCaret() __________________________________________________________
 
-	ResDB::CaretRes * ResDB::getResCaret( const std::string& id ) const
+	ResDB::CaretRes * ResDB::getResCaret( const Key& id ) const
 	{
-		CaretRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResCaret(id)))
-					return res;
-			}
-		}
-		CaretMap::const_iterator it = m_mapCarets.find(id);
-		return it == m_mapCarets.end() ? 0 : it->second;
+		return static_cast<CaretRes*>( _lookup( ResType::Caret, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResTextStyle() ______________________________________________________
 
-	ResDB::TextStyleRes * ResDB::getResTextStyle( const std::string& id ) const
+	ResDB::TextStyleRes * ResDB::getResTextStyle( const Key& id ) const
 	{
-		TextStyleRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResTextStyle(id)))
-					return res;
-			}
-		}
-		PropMap::const_iterator it = m_mapTextStyles.find(id);
-		return it == m_mapTextStyles.end() ? 0 : it->second;
+		return static_cast<TextStyleRes*>( _lookup( ResType::TextStyle, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResColor() __________________________________________________________
 
-	ResDB::ColorRes * ResDB::getResColor( const std::string& id ) const
+	ResDB::ColorRes * ResDB::getResColor( const Key& id ) const
 	{
-		ColorRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResColor(id)))
-					return res;
-			}
-		}
-		ColMap::const_iterator it = m_mapColors.find(id);
-		return it == m_mapColors.end() ? 0 : it->second;
+		return static_cast<ColorRes*>( _lookup( ResType::Color, id ) );
 	}
 
+	//____ getLegoSource() ________________________________________________________
 
-	//____ () _________________________________________________________
-
-	ResDB::LegoSource * ResDB::getLegoSource( const std::string& id ) const
+	ResDB::LegoSource * ResDB::getLegoSource( const Key& id ) const
 	{
-		LegoSource* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getLegoSource(id)))
-					return res;
-			}
-		}
-		LegoMap::const_iterator it = m_mapLegoSources.find(id);
-		return it == m_mapLegoSources.end() ? 0 : it->second;
+		return static_cast<LegoSource*>( _lookup( ResType::LegoSource, id ) );
 	}
 
-	ResDB::SkinRes * ResDB::getResSkin( const std::string& id ) const
+	//____ getResSkin() ___________________________________________________________
+
+	ResDB::SkinRes * ResDB::getResSkin( const Key& id ) const
 	{
-		SkinRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResSkin(id)))
-					return res;
-			}
-		}
-		SkinMap::const_iterator it = m_mapSkins.find(id);
-		return it == m_mapSkins.end() ? 0 : it->second;
+		return static_cast<SkinRes*>( _lookup( ResType::Skin, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResWidget() _________________________________________________________
 
-	ResDB::WidgetRes * ResDB::getResWidget( const std::string& id ) const
+	ResDB::WidgetRes * ResDB::getResWidget( const Key& id ) const
 	{
-		WidgetRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResWidget(id)))
-					return res;
-			}
-		}
-		WidgetMap::const_iterator it = m_mapWidgets.find(id);
-		return it == m_mapWidgets.end() ? 0 : it->second;
+		return static_cast<WidgetRes*>( _lookup( ResType::Widget, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResDataSet() ________________________________________________________
 
-	ResDB::DataSetRes * ResDB::getResDataSet( const std::string& id ) const
+	ResDB::DataSetRes * ResDB::getResDataSet( const Key& id ) const
 	{
-		DataSetRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResDataSet(id)))
-					return res;
-			}
-		}
-		DataSetMap::const_iterator it = m_mapDataSets.find(id);
-		return it == m_mapDataSets.end() ? 0 : it->second;
+		return static_cast<DataSetRes*>( _lookup( ResType::DataSet, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ getResConnect() ________________________________________________________
 
-	ResDB::ConnectRes * ResDB::getResConnect( const std::string& id ) const
+	ResDB::ConnectRes * ResDB::getResConnect( const Key& id ) const
 	{
-		ConnectRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->getResConnect(id)))
-					return res;
-			}
-		}
-		ConnectMap::const_iterator it = m_mapConnects.find(id);
-		return it == m_mapConnects.end() ? 0 : it->second;
+		return static_cast<ConnectRes*>( _lookup( ResType::Connect, id ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResDbRes() _________________________________________________________
 
 	ResDB::ResDBRes * ResDB::findResDbRes( ResDB * data ) const
 	{
-		for(ResDBRes* res = getFirstResDbRes(); res; res = res->next())
-		{
-			if(res->res.rawPtr() == data)
-				return res;
-			if(res->res)
-			{
-				ResDBRes* res2 = res->res->findResDbRes(data);
-				if(res2)
-					return res2;
-			}
-		}
-		return 0;
+		return static_cast<ResDBRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResSurface() _______________________________________________________
 
-	ResDB::SurfaceRes* ResDB::findResSurface( Surface * surf ) const
+	ResDB::SurfaceRes * ResDB::findResSurface( Surface * data ) const
 	{
-		SurfaceRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResSurface(surf)))
-					return res;
-			}
-		}
-		for(res = getFirstResSurface(); res; res = res->next())
-			if(res->res.rawPtr() == surf)
-				return res;
-		return 0;
+		return static_cast<SurfaceRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResFont() __________________________________________________________
 
-	ResDB::FontRes* ResDB::findResFont( Font * meta ) const
+	ResDB::FontRes * ResDB::findResFont( Font * data ) const
 	{
-		FontRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResFont(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResFont(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
-				return res;
-		return 0;
+		return static_cast<FontRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResGfxAnim() _______________________________________________________
 
-	ResDB::GfxAnimRes* ResDB::findResGfxAnim( GfxAnim * meta ) const
+	ResDB::GfxAnimRes * ResDB::findResGfxAnim( GfxAnim * data ) const
 	{
-		GfxAnimRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResGfxAnim(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResGfxAnim(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
-				return res;
-		return 0;
+		return static_cast<GfxAnimRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResCaret() _________________________________________________________
 
-	ResDB::CaretRes* ResDB::findResCaret( Caret * meta ) const
+	ResDB::CaretRes * ResDB::findResCaret( Caret * data ) const
 	{
-		CaretRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResCaret(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResCaret(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
-				return res;
-		return 0;
+		return static_cast<CaretRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResTextStyle() _____________________________________________________
 
-	ResDB::TextStyleRes* ResDB::findResTextStyle( TextStyle * meta ) const
+	ResDB::TextStyleRes * ResDB::findResTextStyle( TextStyle * data ) const
 	{
-		TextStyleRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResTextStyle(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResTextStyle(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
-				return res;
-		return 0;
+		return static_cast<TextStyleRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResSkin() __________________________________________________________
 
-	ResDB::ColorRes* ResDB::findResColor( const Color meta ) const
+	ResDB::SkinRes * ResDB::findResSkin( Skin * data ) const
 	{
-		ColorRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResColor(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResColor(); res; res = res->next())
-			if(res->res == meta)
-				return res;
-		return 0;
+		return static_cast<SkinRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResWidget() ________________________________________________________
 
-	ResDB::SkinRes* ResDB::findResSkin( Skin * meta ) const
+	ResDB::WidgetRes * ResDB::findResWidget( Widget * data ) const
 	{
-		SkinRes* res = 0;
-		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
-		{
-			if(db->res)
-			{
-				if((res = db->res->findResSkin(meta)))
-					return res;
-			}
-		}
-		for(res = getFirstResSkin(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
-				return res;
-		return 0;
+		return static_cast<WidgetRes*>( _find( data ) );
 	}
 
-	//____ () _________________________________________________________
+	//____ findResColor() _________________________________________________________
 
-	ResDB::WidgetRes* ResDB::findResWidget( Widget * meta ) const
+	ResDB::ColorRes* ResDB::findResColor( const Color meta ) const
 	{
-		WidgetRes* res = 0;
+		ColorRes* res = 0;
 		for(ResDBRes* db = getFirstResDbRes(); db; db = db->next())
 		{
 			if(db->res)
 			{
-				if((res = db->res->findResWidget(meta)))
+				if((res = db->res->findResColor(meta)))
 					return res;
 			}
 		}
-		for(res = getFirstResWidget(); res; res = res->next())
-			if(res->res.rawPtr() == meta)
+		for(res = getFirstResColor(); res; res = res->next())
+			if(res->res == meta)
 				return res;
 		return 0;
 	}
@@ -894,8 +1015,10 @@ namespace wg
 			return false;
 
 		SurfaceRes * pRes = it->second;
+		_forgetLoad( pRes );
 		m_mapSurfaces.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -905,6 +1028,8 @@ namespace wg
 		if( !pRes )
 			return false;
 
+		_forgetLoad( pRes );
+
 		if( pRes->id.length() > 0 )
 		{
 			SurfMap::iterator it = m_mapSurfaces.find( pRes->id );
@@ -912,6 +1037,7 @@ namespace wg
 			m_mapSurfaces.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -928,6 +1054,7 @@ namespace wg
 		FontRes * pRes = it->second;
 		m_mapFonts.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -944,6 +1071,7 @@ namespace wg
 			m_mapFonts.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -960,6 +1088,7 @@ namespace wg
 		GfxAnimRes * pRes = it->second;
 		m_mapGfxAnims.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -976,6 +1105,7 @@ namespace wg
 			m_mapGfxAnims.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -992,6 +1122,7 @@ namespace wg
 		CaretRes * pRes = it->second;
 		m_mapCarets.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1008,6 +1139,7 @@ namespace wg
 			m_mapCarets.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1024,6 +1156,7 @@ namespace wg
 		TextStyleRes * pRes = it->second;
 		m_mapTextStyles.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1040,6 +1173,7 @@ namespace wg
 			m_mapTextStyles.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1056,6 +1190,7 @@ namespace wg
 		ColorRes * pRes = it->second;
 		m_mapColors.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1072,6 +1207,7 @@ namespace wg
 			m_mapColors.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1089,6 +1225,7 @@ namespace wg
 		LegoSource * pRes = it->second;
 		m_mapLegoSources.erase(it);
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1104,6 +1241,7 @@ namespace wg
 			m_mapLegoSources.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1119,6 +1257,7 @@ namespace wg
 		SkinRes * pRes = it->second;
 		m_mapSkins.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1135,6 +1274,7 @@ namespace wg
 			m_mapSkins.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1150,6 +1290,7 @@ namespace wg
 		DataSetRes * pRes = it->second;
 		m_mapDataSets.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1166,6 +1307,7 @@ namespace wg
 			m_mapDataSets.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1182,6 +1324,7 @@ namespace wg
 		WidgetRes * pRes = it->second;
 		m_mapWidgets.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1198,6 +1341,7 @@ namespace wg
 			m_mapWidgets.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1214,6 +1358,7 @@ namespace wg
 		ConnectRes * pRes = it->second;
 		m_mapConnects.erase(it);
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1230,6 +1375,7 @@ namespace wg
 			m_mapConnects.erase(it);
 		}
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
@@ -1243,8 +1389,11 @@ namespace wg
 			return false;
 
 		ResDBRes * pRes = it->second;
+		_forgetLoad( pRes );
 		m_mapResDBs.erase(it);
+		_detach( pRes->res.rawPtr() );
 		delete pRes;
+		_invalidateIndex();
 
 		return true;
 	}
@@ -1254,14 +1403,306 @@ namespace wg
 		if( !pRes )
 			return false;
 
+		_forgetLoad( pRes );
+
 		if( pRes->id.length() > 0 )
 		{
 			ResDBMap::iterator it = m_mapResDBs.find( pRes->id );
 			assert( it != m_mapResDBs.end() );
 			m_mapResDBs.erase(it);
 		}
+		_detach( pRes->res.rawPtr() );
 		delete pRes;
+		_invalidateIndex();
 		return true;
 	}
 
+	//____ _lookup() ______________________________________________________________
+
+	ResDB::Resource * ResDB::_lookup( ResType type, const Key& id ) const
+	{
+		_updateIndex();
+
+		auto range = m_idIndex.equal_range( id.hash() ^ uint64_t(type) );
+		for( auto it = range.first ; it != range.second ; ++it )
+		{
+			const IndexEntry& entry = it->second;
+			if( entry.type == type && entry.pRes->id.length() == id.length() &&
+				memcmp( entry.pRes->id.data(), id.chars(), id.length() ) == 0 )
+				return entry.pRes;
+		}
+		return 0;
+	}
+
+	//____ _find() ________________________________________________________________
+
+	ResDB::Resource * ResDB::_find( const void * pData ) const
+	{
+		if( !pData )
+			return 0;
+
+		_updateIndex();
+
+		auto it = m_ptrIndex.find( pData );
+		return it == m_ptrIndex.end() ? 0 : it->second;
+	}
+
+	//____ _buildIndex() __________________________________________________________
+
+	void ResDB::_buildIndex() const
+	{
+		m_idIndex.clear();
+		m_ptrIndex.clear();
+		_collectIndex( m_idIndex, m_ptrIndex );
+		m_bIndexValid = true;
+	}
+
+	//____ _collectIndex() ________________________________________________________
+	// Adds the resources of our tree to the indexes in lookup order, nested
+	// databases first. Resources already indexed take precedence.
+
+	void ResDB::_collectIndex( IdIndex& ids, PtrIndex& ptrs ) const
+	{
+		for( ResDBRes * pRes = getFirstResDbRes() ; pRes ; pRes = pRes->next() )
+		{
+			_indexResource( ids, ptrs, ResType::ResDb, pRes->file, pRes, pRes->res.rawPtr() );
+			if( pRes->res )
+				pRes->res->_collectIndex( ids, ptrs );
+		}
+
+		for( SurfaceRes * p = getFirstResSurface() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Surface, p->id, p, p->res.rawPtr() );
+
+		for( FontRes * p = getFirstResFont() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Font, p->id, p, p->res.rawPtr() );
+
+		for( GfxAnimRes * p = getFirstResGfxAnim() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::GfxAnim, p->id, p, p->res.rawPtr() );
+
+		for( CaretRes * p = getFirstResCaret() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Caret, p->id, p, p->res.rawPtr() );
+
+		for( TextStyleRes * p = getFirstResTextStyle() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::TextStyle, p->id, p, p->res.rawPtr() );
+
+		for( ColorRes * p = getFirstResColor() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Color, p->id, p, 0 );
+
+		for( LegoSource * p = m_legos.first() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::LegoSource, p->id, p, 0 );
+
+		for( SkinRes * p = getFirstResSkin() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Skin, p->id, p, p->res.rawPtr() );
+
+		for( ConnectRes * p = getFirstResConnect() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Connect, p->id, p, 0 );
+
+		for( WidgetRes * p = getFirstResWidget() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::Widget, p->id, p, p->res.rawPtr() );
+
+		for( DataSetRes * p = getFirstResDataSet() ; p ; p = p->next() )
+			_indexResource( ids, ptrs, ResType::DataSet, p->id, p, 0 );
+	}
+
+	//____ _indexResource() _______________________________________________________
+
+	void ResDB::_indexResource( IdIndex& ids, PtrIndex& ptrs, ResType type, const std::string& id, Resource * pRes, const void * pData )
+	{
+		if( !id.empty() )
+		{
+			uint64_t key = Key::hash( id.data(), id.length() ) ^ uint64_t(type);
+
+			auto range = ids.equal_range( key );
+			auto it = range.first;
+			while( it != range.second && !(it->second.type == type && it->second.pRes->id == id) )
+				++it;
+
+			if( it == range.second )
+				ids.emplace( key, IndexEntry{ type, pRes } );
+		}
+
+		if( pData )
+			ptrs.emplace( pData, pRes );
+	}
+
+	//____ _added() _______________________________________________________________
+	// Our own resources come last in lookup order, so a new one can just be
+	// added to a valid index. Indexes of databases we are nested in are rebuilt
+	// since our resources have precedence over theirs.
+
+	void ResDB::_added( ResType type, Resource * pRes, const void * pData )
+	{
+		if( m_bIndexValid )
+			_indexResource( m_idIndex, m_ptrIndex, type, pRes->id, pRes, pData );
+
+		for( ResDB * pParent : m_parents )
+			pParent->_invalidateIndex();
+	}
+
+	//____ _startLoad() _________________________________________________________
+
+	void ResDB::_startLoad( ResType type, Resource * pRes, const std::string& file, bool bRequired )
+	{
+		if( !m_pLoadState )
+			m_pLoadState = std::make_shared<LoadState>();
+
+		std::shared_ptr<LoadJob> pJob = std::make_shared<LoadJob>();
+		pJob->type = type;
+		pJob->pRes = pRes;
+		pJob->file = file;
+		pJob->bRequired = bRequired;
+		pJob->pLoader = m_pResLoader;
+		pJob->bDecoded = false;
+
+		m_loadJobs.push_back( pJob );
+		m_nLoadsTotal++;
+
+		if( m_loadTask == 0 )
+			m_loadTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { updateLoading(); return 0; } );
+
+		std::shared_ptr<LoadState> pState = m_pLoadState;
+
+		s_loadPool.post( [pState,pJob]()
+		{
+			{
+				std::lock_guard<std::mutex> lock(pState->mutex);
+				if( pState->bCancelled )
+					return;
+				pState->nRunning++;
+			}
+
+			if( pJob->type == ResType::Surface )
+				pJob->bDecoded = pJob->pLoader->decodeSurface( pJob->file, pJob->bRequired, pJob->surfaceData );
+			else
+				pJob->pDb = pJob->pLoader->loadDb( pJob->file, 0 );
+
+			{
+				std::lock_guard<std::mutex> lock(pState->mutex);
+				pState->nRunning--;
+				pState->finished.push_back( pJob );
+			}
+			pState->cond.notify_all();
+		});
+	}
+
+	//____ _finalizeLoad() ________________________________________________________
+
+	void ResDB::_finalizeLoad( LoadJob * pJob )
+	{
+		if( pJob->type == ResType::Surface )
+		{
+			SurfaceRes * pRes = static_cast<SurfaceRes*>( pJob->pRes );
+			if( !pRes )
+				return;
+
+			Surface_p pSurface;
+			SurfaceFactory_p pFactory = pJob->bDecoded ? pJob->pLoader->surfaceFactory() : nullptr;
+
+			if( pFactory )
+			{
+				ResLoader::SurfaceData& data = pJob->surfaceData;
+
+				PixelDescription	desc;
+				Util::pixelFormatToDescription( data.format, desc );
+				pSurface = pFactory->createSurface( data.size, data.format, data.pixels.data(), data.pitch, &desc,
+													SurfaceFlag::Static, data.clut.empty() ? nullptr : data.clut.data() );
+			}
+			else
+				pSurface = pJob->pLoader->loadSurface( pJob->file, pJob->bRequired );
+
+			if( pSurface )
+			{
+				pRes->res = pSurface;
+				_added( ResType::Surface, pRes, pSurface.rawPtr() );
+			}
+			else
+			{
+				m_nLoadsFailed++;
+				removeSurface( pRes );
+			}
+		}
+		else
+		{
+			ResDBRes * pRes = static_cast<ResDBRes*>( pJob->pRes );
+			ResDB_p pDb = pJob->pDb;
+			pJob->pDb = 0;							// Make sure the worker never releases it.
+
+			if( !pRes )
+				return;
+
+			if( pDb )
+			{
+				pRes->res = pDb;
+				pDb->m_parents.push_back(this);
+				_invalidateIndex();
+			}
+			else
+				m_nLoadsFailed++;
+		}
+	}
+
+	//____ _forgetLoad() __________________________________________________________
+
+	void ResDB::_forgetLoad( Resource * pRes )
+	{
+		for( auto& pJob : m_loadJobs )
+			if( pJob->pRes == pRes )
+				pJob->pRes = 0;
+	}
+
+	//____ _cancelLoading() _______________________________________________________
+	// Skips jobs not yet started and waits for the running ones, which might use
+	// a ResLoader that goes away with us.
+	//
+	// Workers can hold on to their jobs a little longer than that, so we release
+	// everything loaded ourselves instead of leaving it to whoever drops the job last.
+
+	void ResDB::_cancelLoading()
+	{
+		if( !m_pLoadState )
+			return;
+
+		std::vector<std::shared_ptr<LoadJob>> finished;
+		{
+			std::unique_lock<std::mutex> lock(m_pLoadState->mutex);
+			m_pLoadState->bCancelled = true;
+			m_pLoadState->cond.wait( lock, [this]() { return m_pLoadState->nRunning == 0; } );
+			finished.swap( m_pLoadState->finished );
+		}
+
+		for( auto& pJob : m_loadJobs )
+			pJob->pDb = nullptr;
+
+		finished.clear();
+		m_loadJobs.clear();
+
+		if( m_loadTask )
+		{
+			Base::scheduler()->removeTask( m_loadTask );
+			m_loadTask = 0;
+		}
+	}
+
+	//____ _invalidateIndex() _____________________________________________________
+
+	void ResDB::_invalidateIndex()
+	{
+		m_bIndexValid = false;
+
+		for( ResDB * pParent : m_parents )
+			pParent->_invalidateIndex();
+	}
+
+	//____ _detach() ______________________________________________________________
+
+	void ResDB::_detach( ResDB * pChild )
+	{
+		if( !pChild )
+			return;
+
+		auto it = std::find( pChild->m_parents.begin(), pChild->m_parents.end(), this );
+		if( it != pChild->m_parents.end() )
+			pChild->m_parents.erase(it);
+	}
+
 } // namespace wg
@@ -27,6 +27,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <functional>
+#include <memory>
 
 
 #include <wg_object.h>
@@ -42,12 +45,30 @@ namespace wg
 
 	class Font;
 	class ResLoader;
+	class SurfaceFactory;
 
 
 	class ResDB;
 	typedef	StrongPtr<ResDB>	ResDB_p;
 	typedef	WeakPtr<ResDB>	ResDB_wp;
 
+	/**
+	 * @brief Database of named resources, optionally nesting other databases.
+	 *
+	 * Lookups by id or by resource search nested databases before our own resources,
+	 * in the order they were added. To avoid walking the tree on every lookup, each
+	 * ResDB keeps a flattened index of its whole tree, built on the first lookup
+	 * and kept up to date as resources and databases are added and removed.
+	 *
+	 * The index is built lazily from const methods, so a ResDB that is modified
+	 * must not be accessed from several threads at once.
+	 *
+	 * Surfaces and sub-databases can also be loaded asynchronously, see addSurfaceAsync()
+	 * and addResDbAsync(). Their files are decoded and parsed by a pool of worker threads
+	 * while placeholders are added right away. The loads are finalized on the thread
+	 * ticking the Scheduler, which needs to be the thread owning the ResDB.
+	 */
+
 	class ResDB : public Object
 	{
 	public:
@@ -58,6 +79,39 @@ namespace wg
 		static const char	CLASSNAME[];
 		static ResDB_p	cast( Object * pObject );
 
+		//____ Key ____________________________________________________________
+		/**
+		 * @brief Pre-hashed id for resource lookups.
+		 *
+		 * Lookups accept a Key, which is implicitly created from a string literal or a
+		 * std::string, so no string temporaries are built. Hot lookups can keep a Key
+		 * around to skip hashing as well:
+		 *
+		 *		static const ResDB::Key	buttonSkin("button_skin");
+		 *		Skin_p pSkin = pDB->getSkin(buttonSkin);
+		 *
+		 * A Key only refers to the characters it is created from and must not outlive them.
+		 */
+
+		class Key
+		{
+		public:
+			Key( const char * pId );
+			Key( const char * pId, size_t length );
+			Key( const std::string& id ) : Key( id.data(), id.length() ) {}
+
+			inline uint64_t		hash() const { return m_hash; }
+			inline const char *	chars() const { return m_pChars; }
+			inline size_t		length() const { return m_length; }
+
+			static uint64_t		hash( const char * pChars, size_t length );
+
+		private:
+			const char *	m_pChars;
+			size_t			m_length;
+			uint64_t		m_hash;
+		};
+
 
 		class MetaData
 		{
@@ -98,6 +152,7 @@ namespace wg
 
 		struct LegoSource : public Resource
 		{
+			LINK_METHODS( LegoSource );
 			LegoSource(const std::string& id, const std::string& surface, Rect rect, uint32_t nStates, MetaData* meta) : Resource(id, meta), surface(surface), rect(rect), nStates(nStates) { }
 			std::string surface;
 			Rect rect;
@@ -144,9 +199,19 @@ namespace wg
 
 		bool				addResDb( const std::string& file, MetaData * pMetaData = 0 );
 		bool				addResDb( ResDB * db, const std::string& file, MetaData * pMetaData = 0 );
+		bool				addResDbAsync( const std::string& file, MetaData * pMetaData = 0 );
+		bool				addBundle( const std::string& file, SurfaceFactory * pFactory );
 
 		bool				addSurface( const std::string& id, const std::string& file, MetaData * pMetaData, bool bRequired );
 		bool				addSurface( const std::string& id, Surface * pSurf, const std::string& filename, MetaData * pMetaData = 0 );
+		bool				addSurfaceAsync( const std::string& id, const std::string& file, MetaData * pMetaData, bool bRequired );
+
+		int					updateLoading();
+		void				finishLoading();
+		inline bool			isLoading() const { return !m_loadJobs.empty(); }
+		inline int			loadsPending() const { return (int) m_loadJobs.size(); }
+		inline int			loadsFailed() const { return m_nLoadsFailed; }
+		void				setLoadCallback( std::function<void(int done, int total)> callback );
 
 		bool				addFont( const std::string& id, Font * pFont, MetaData * pMetaData = 0 );
 		bool				addGfxAnim( const std::string& id, GfxAnim * pAnim, MetaData * pMetaData = 0 );
@@ -187,30 +252,30 @@ namespace wg
 
 
 
-		Surface_p		getSurface( const std::string& id ) const;
-		Font_p			getFont( const std::string& id ) const;
-		GfxAnim_p		getGfxAnim( const std::string& id ) const;
-		Caret_p			getCaret( const std::string& id ) const;
-		TextStyle_p		getTextStyle( const std::string& id ) const;
-		Color				getColor( const std::string& id ) const;
-		Skin_p			getSkin( const std::string& id ) const;
-		Widget_p			getWidget( const std::string& id ) const;
-		MetaData*			getDataSet( const std::string& id ) const;
-		Widget_p			cloneWidget( const std::string& id ) const;
-
-
-		ResDBRes *			getResDbRes( const std::string& id ) const;
-		SurfaceRes *		getResSurface( const std::string& id ) const;
-		FontRes *			getResFont( const std::string& id ) const;
-		GfxAnimRes *		getResGfxAnim( const std::string& id ) const;
-		CaretRes *			getResCaret( const std::string& id ) const;
-		TextStyleRes *		getResTextStyle( const std::string& id ) const;
-		ColorRes *			getResColor( const std::string& id ) const;
-		LegoSource *		getLegoSource( const std::string& id ) const;
-		SkinRes *			getResSkin( const std::string& id ) const;
-		ConnectRes *		getResConnect( const std::string& id ) const;
-		WidgetRes *			getResWidget( const std::string& id ) const;
-		DataSetRes *		getResDataSet( const std::string& id ) const;
+		Surface_p		getSurface( const Key& id ) const;
+		Font_p			getFont( const Key& id ) const;
+		GfxAnim_p		getGfxAnim( const Key& id ) const;
+		Caret_p			getCaret( const Key& id ) const;
+		TextStyle_p		getTextStyle( const Key& id ) const;
+		Color				getColor( const Key& id ) const;
+		Skin_p			getSkin( const Key& id ) const;
+		Widget_p			getWidget( const Key& id ) const;
+		MetaData*			getDataSet( const Key& id ) const;
+		Widget_p			cloneWidget( const Key& id ) const;
+
+
+		ResDBRes *			getResDbRes( const Key& id ) const;
+		SurfaceRes *		getResSurface( const Key& id ) const;
+		FontRes *			getResFont( const Key& id ) const;
+		GfxAnimRes *		getResGfxAnim( const Key& id ) const;
+		CaretRes *			getResCaret( const Key& id ) const;
+		TextStyleRes *		getResTextStyle( const Key& id ) const;
+		ColorRes *			getResColor( const Key& id ) const;
+		LegoSource *		getLegoSource( const Key& id ) const;
+		SkinRes *			getResSkin( const Key& id ) const;
+		ConnectRes *		getResConnect( const Key& id ) const;
+		WidgetRes *			getResWidget( const Key& id ) const;
+		DataSetRes *		getResDataSet( const Key& id ) const;
 
 		ResDBRes *			findResDbRes( ResDB * data ) const;
 		SurfaceRes *		findResSurface( Surface * data ) const;
@@ -248,6 +313,51 @@ namespace wg
 		ResDB();
 		virtual ~ResDB();
 
+		enum class ResType : uint8_t
+		{
+			ResDb,
+			Surface,
+			Font,
+			GfxAnim,
+			Caret,
+			TextStyle,
+			Color,
+			LegoSource,
+			Skin,
+			Connect,
+			Widget,
+			DataSet
+		};
+
+		struct IndexEntry
+		{
+			ResType			type;
+			Resource *		pRes;
+		};
+
+		typedef std::unordered_multimap<uint64_t, IndexEntry>		IdIndex;
+		typedef std::unordered_map<const void*, Resource*>		PtrIndex;
+
+		Resource *		_lookup( ResType type, const Key& id ) const;
+		Resource *		_find( const void * pData ) const;
+
+		void			_updateIndex() const { if( !m_bIndexValid ) _buildIndex(); }
+		void			_buildIndex() const;
+		void			_collectIndex( IdIndex& ids, PtrIndex& ptrs ) const;
+		static void		_indexResource( IdIndex& ids, PtrIndex& ptrs, ResType type, const std::string& id, Resource * pRes, const void * pData );
+
+		struct LoadJob;
+		struct LoadState;
+
+		void			_startLoad( ResType type, Resource * pRes, const std::string& file, bool bRequired );
+		void			_finalizeLoad( LoadJob * pJob );
+		void			_forgetLoad( Resource * pRes );
+		void			_cancelLoading();
+
+		void			_added( ResType type, Resource * pRes, const void * pData );
+		void			_invalidateIndex();
+		void			_detach( ResDB * pChild );
+
 		typedef std::map<std::string, ResDBRes*>		ResDBMap;
 		typedef std::map<std::string, SurfaceRes*>		SurfMap;
 		typedef std::map<std::string, FontRes*>			FontMap;
@@ -288,6 +398,20 @@ namespace wg
 		DataSetMap		m_mapDataSets;
 
 		ResLoader *	m_pResLoader;
+
+		std::vector<ResDB*>	m_parents;			// Databases we are nested in, for invalidating their indexes.
+
+		mutable IdIndex		m_idIndex;			// Flattened index of ids in our whole tree.
+		mutable PtrIndex	m_ptrIndex;			// Flattened index of resource objects in our whole tree.
+		mutable bool		m_bIndexValid;
+
+		std::shared_ptr<LoadState>				m_pLoadState;	// Shared with worker threads, created on first async load.
+		std::vector<std::shared_ptr<LoadJob>>	m_loadJobs;		// Jobs not yet finalized.
+		std::function<void(int,int)>			m_loadCallback;
+		TaskId				m_loadTask;
+		int					m_nLoadsTotal;
+		int					m_nLoadsDone;
+		int					m_nLoadsFailed;
 	};
 
 
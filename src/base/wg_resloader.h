@@ -24,8 +24,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <wg_surface.h>
+#include <wg_surfacefactory.h>
 #include <wg_resdb.h>
 
 namespace wg
@@ -33,13 +35,42 @@ namespace wg
 
 	class Font;
 
+	/**
+	 * @brief Interface for loading the resources of a ResDB.
+	 *
+	 * For asynchronous loading through ResDB::addSurfaceAsync() and ResDB::addResDbAsync(),
+	 * decodeSurface() and loadDb() are called from worker threads and need to be thread-safe.
+	 * Loaders that do not implement decodeSurface() or surfaceFactory() get their surfaces
+	 * loaded by loadSurface() on the thread owning the ResDB instead.
+	 *
+	 * A database returned by loadDb() on a worker thread must not contain indexed surfaces,
+	 * since their Palettes are pooled with those of the owning thread, see Palette. Put them
+	 * in databases loaded synchronously or decode them through decodeSurface(), which hands
+	 * the CLUT over to be turned into a surface on the owning thread. Palette asserts the
+	 * thread it is used on.
+	 */
+
 	class ResLoader
 	{
 	public:
+		/// Pixels of a decoded image, ready to be turned into a Surface.
+
+		struct SurfaceData
+		{
+			Size					size;
+			PixelFormat				format = PixelFormat::BGRA_8;
+			int						pitch = 0;
+			std::vector<uint8_t>	pixels;
+			std::vector<Color>		clut;			///< Palette for indexed formats, otherwise empty.
+		};
+
 		virtual Surface_p	loadSurface( const std::string& filename, bool bRequired ) = 0;
 		virtual Font_p	loadFont( const std::string& filename ) = 0;
 		virtual ResDB_p		loadDb( const std::string& filename, ResDB * pDependencies = 0 ) = 0;
 		virtual std::string		loadString( const std::string& token ) = 0;
+
+		virtual bool		decodeSurface( const std::string& filename, bool bRequired, SurfaceData& data ) { return false; }	///< Decode image into data. Return false if not supported or failed.
+		virtual SurfaceFactory_p	surfaceFactory() { return nullptr; }	///< Factory for creating surfaces from decoded images.
 	};
 
 
@@ -0,0 +1,413 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_scheduler.h>
+
+#include <algorithm>
+
+namespace wg
+{
+
+	const char Scheduler::CLASSNAME[] = {"Scheduler"};
+
+
+	//____ Constructor ____________________________________________________________
+
+	Scheduler::Scheduler()
+	{
+	}
+
+	//____ Destructor _____________________________________________________________
+
+	Scheduler::~Scheduler()
+	{
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool Scheduler::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * Scheduler::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	Scheduler_p Scheduler::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return Scheduler_p( static_cast<Scheduler*>(pObject) );
+
+		return 0;
+	}
+
+	//____ addTask() ______________________________________________________________
+	/**
+	 * @brief Add a task to the scheduler.
+	 *
+	 * @param callback	Function to call. Gets the timestamp of the tick and the milliseconds
+	 *					passed since the task was added, woken or last called. Returns
+	 *					milliseconds until next call, 0 for next tick or negative to sleep.
+	 * @param delay		Milliseconds until first call, 0 for next tick or negative to add
+	 *					the task sleeping.
+	 *
+	 * @return Id of the task, needed for removing or waking it.
+	 */
+
+	TaskId Scheduler::addTask( std::function<int(int64_t timestamp, int timediff)> callback, int delay )
+	{
+		if( m_idCounter == 0 )
+			m_idCounter++;
+
+		TaskId id = m_idCounter++;
+
+		Task& task = m_tasks[id];
+		task.callback = callback;
+		task.due = 0;
+		task.lastCall = m_time;
+		task.lastTickCalled = 0;
+		task.state = TaskState::Sleeping;
+
+		if( delay >= 0 )
+			_schedule( id, task, delay );
+
+		return id;
+	}
+
+	//____ removeTask() ___________________________________________________________
+	/**
+	 * @brief Remove a task from the scheduler.
+	 *
+	 * A task may remove itself from within its callback. Any other task
+	 * removed that way is never called again, even if it was due in the same tick.
+	 *
+	 * @return False if there was no task with the given id.
+	 */
+
+	bool Scheduler::removeTask( TaskId id )
+	{
+		if( id == m_runningTask && !m_bRunningTaskRemoved )
+		{
+			m_bRunningTaskRemoved = true;			// Erased once callback has returned.
+			m_bDeadlineValid = false;
+			return true;
+		}
+
+		if( m_tasks.erase(id) == 0 )
+			return false;
+
+		// Entries in the wheel and in m_nextTick are left to be cleaned up
+		// when found to not match any task.
+
+		m_bDeadlineValid = false;
+		return true;
+	}
+
+	//____ wakeTask() _____________________________________________________________
+	/**
+	 * @brief Make sure a task is called within the given delay.
+	 *
+	 * A sleeping task is scheduled to be called after delay milliseconds or on next
+	 * tick if delay is 0. A task already scheduled to be called earlier is left as is.
+	 *
+	 * @return False if there was no task with the given id.
+	 */
+
+	bool Scheduler::wakeTask( TaskId id, int delay )
+	{
+		auto it = m_tasks.find(id);
+		if( it == m_tasks.end() || (id == m_runningTask && m_bRunningTaskRemoved) )
+			return false;
+
+		_wake( id, it->second, std::max(delay, 0) );
+		return true;
+	}
+
+	//____ isScheduled() __________________________________________________________
+	/**
+	 * @brief Check if task will be called by the scheduler.
+	 *
+	 * @return True if task exists and is not sleeping.
+	 */
+
+	bool Scheduler::isScheduled( TaskId id ) const
+	{
+		auto it = m_tasks.find(id);
+		if( it == m_tasks.end() || (id == m_runningTask && m_bRunningTaskRemoved) )
+			return false;
+
+		return it->second.state != TaskState::Sleeping;
+	}
+
+	//____ tick() _________________________________________________________________
+	/**
+	 * @brief Advance time and call all tasks that are due.
+	 *
+	 * Should be called by the host once per frame before dispatching messages and
+	 * rendering. Timestamps are in milliseconds and may start anywhere, but must not
+	 * decrease. A timestamp lower than the previous one is treated as equal to it.
+	 */
+
+	void Scheduler::tick( int64_t timestamp )
+	{
+		// First tick sets our timebase. Move tasks scheduled before it along with it.
+
+		if( !m_bStarted )
+		{
+			m_bStarted = true;
+
+			for( auto& slot : m_wheel )
+				slot.clear();
+			m_nbWheelEntries = 0;
+
+			int64_t oldTime = m_time;
+			m_time = timestamp;
+
+			for( auto& entry : m_tasks )
+			{
+				Task& task = entry.second;
+				task.lastCall = timestamp;
+
+				if( task.state == TaskState::Delayed )
+				{
+					task.state = TaskState::Sleeping;
+					_schedule( entry.first, task, int(task.due - oldTime) );
+				}
+			}
+		}
+
+		timestamp = std::max( timestamp, m_time );
+
+		m_tickCounter++;
+		_collectDue( timestamp );
+		m_time = timestamp;
+		m_bDeadlineValid = false;
+
+		for( TaskId id : m_dueTasks )
+			_callTask( id, timestamp );
+
+		m_dueTasks.clear();
+	}
+
+	//____ nextDeadline() _________________________________________________________
+	/**
+	 * @brief Get timestamp when the scheduler next has a task to call.
+	 *
+	 * Lets the host sleep until something needs to be updated. A timestamp equal to
+	 * time() means that some task wants to be called on next tick.
+	 *
+	 * Input, messages and other events can wake up tasks, so the deadline
+	 * can move earlier as a result of handling them.
+	 *
+	 * @return Timestamp of next due task or -1 if all tasks are sleeping.
+	 */
+
+	int64_t Scheduler::nextDeadline() const
+	{
+		if( m_bDeadlineValid )
+			return m_deadline;
+
+		m_deadline = -1;
+		m_bDeadlineValid = true;
+
+		for( TaskId id : m_nextTick )
+		{
+			auto it = m_tasks.find(id);
+			if( it != m_tasks.end() && it->second.state == TaskState::NextTick && !(id == m_runningTask && m_bRunningTaskRemoved) )
+			{
+				m_deadline = m_time;
+				return m_deadline;
+			}
+		}
+
+		if( m_nbWheelEntries == 0 )
+			return m_deadline;
+
+		// Walk one turn around the wheel. First entry due in its own turn is
+		// the earliest, otherwise take the earliest of those found.
+
+		for( int64_t t = m_time + 1 ; t <= m_time + c_wheelSlots ; t++ )
+		{
+			for( const WheelEntry& entry : m_wheel[t & (c_wheelSlots-1)] )
+			{
+				if( !_isValid(entry) )
+					continue;
+
+				if( entry.due == t )
+				{
+					m_deadline = t;
+					return m_deadline;
+				}
+
+				if( m_deadline < 0 || entry.due < m_deadline )
+					m_deadline = entry.due;
+			}
+		}
+
+		return m_deadline;
+	}
+
+	//____ _schedule() ____________________________________________________________
+
+	void Scheduler::_schedule( TaskId id, Task& task, int delay )
+	{
+		if( delay <= 0 )
+		{
+			if( task.state != TaskState::NextTick )
+			{
+				task.state = TaskState::NextTick;
+				m_nextTick.push_back(id);
+			}
+		}
+		else
+		{
+			task.state = TaskState::Delayed;
+			task.due = m_time + delay;
+			m_wheel[task.due & (c_wheelSlots-1)].push_back( { id, task.due } );
+			m_nbWheelEntries++;
+		}
+
+		m_bDeadlineValid = false;
+	}
+
+	//____ _wake() ________________________________________________________________
+
+	void Scheduler::_wake( TaskId id, Task& task, int delay )
+	{
+		switch( task.state )
+		{
+			case TaskState::Sleeping:
+				task.lastCall = m_time;
+				_schedule( id, task, delay );
+				break;
+
+			case TaskState::Delayed:
+				if( m_time + delay < task.due )
+					_schedule( id, task, delay );
+				break;
+
+			case TaskState::NextTick:
+				break;
+		}
+	}
+
+	//____ _isValid() _____________________________________________________________
+
+	bool Scheduler::_isValid( const WheelEntry& entry ) const
+	{
+		auto it = m_tasks.find(entry.id);
+		return it != m_tasks.end() && it->second.state == TaskState::Delayed && it->second.due == entry.due;
+	}
+
+	//____ _collectDue() __________________________________________________________
+	// Fills m_dueTasks with all tasks due at timestamp. Tasks in wheel are only
+	// collected if they still are valid, but tasks in m_nextTick are checked
+	// when called.
+
+	void Scheduler::_collectDue( int64_t timestamp )
+	{
+		m_dueTasks.swap( m_nextTick );
+
+		if( m_nbWheelEntries == 0 )
+			return;
+
+		// Only slots passed since last tick can hold due entries, but no need
+		// to go more than a full turn.
+
+		int64_t end = std::min( timestamp, m_time + c_wheelSlots );
+
+		for( int64_t t = m_time + 1 ; t <= end ; t++ )
+		{
+			std::vector<WheelEntry>& slot = m_wheel[t & (c_wheelSlots-1)];
+
+			for( size_t i = 0 ; i < slot.size() ; )
+			{
+				bool bValid = _isValid(slot[i]);
+
+				if( bValid && slot[i].due > timestamp )
+				{
+					i++;								// Due in a later turn.
+					continue;
+				}
+
+				if( bValid )
+					m_dueTasks.push_back( slot[i].id );
+
+				slot[i] = slot.back();
+				slot.pop_back();
+				m_nbWheelEntries--;
+			}
+		}
+	}
+
+	//____ _callTask() ____________________________________________________________
+
+	void Scheduler::_callTask( TaskId id, int64_t timestamp )
+	{
+		auto it = m_tasks.find(id);
+		if( it == m_tasks.end() )
+			return;
+
+		// References into unordered_map survive rehashing, so task stays valid
+		// even if callback adds tasks.
+
+		Task& task = it->second;
+
+		if( task.lastTickCalled == m_tickCounter || task.state == TaskState::Sleeping ||
+			(task.state == TaskState::Delayed && task.due > timestamp) )
+			return;
+
+		int timediff = int(timestamp - task.lastCall);
+
+		task.lastTickCalled = m_tickCounter;
+		task.lastCall = timestamp;
+		task.state = TaskState::Sleeping;
+
+		m_runningTask = id;
+		m_bRunningTaskRemoved = false;
+
+		int next = task.callback( timestamp, timediff );
+
+		m_runningTask = 0;
+
+		if( m_bRunningTaskRemoved )
+		{
+			m_tasks.erase(id);
+			return;
+		}
+
+		// Callback might have woken itself, in which case the earliest call wins.
+
+		if( next >= 0 )
+			_wake( id, task, next );
+	}
+
+} // namespace wg
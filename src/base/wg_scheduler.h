@@ -0,0 +1,151 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_SCHEDULER_DOT_H
+#define WG_SCHEDULER_DOT_H
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <wg_pointers.h>
+#include <wg_types.h>
+
+namespace wg
+{
+
+	class Scheduler;
+	typedef	StrongPtr<Scheduler>	Scheduler_p;
+	typedef	WeakPtr<Scheduler>		Scheduler_wp;
+
+	/**
+	 * @brief	Calls timed tasks as time advances.
+	 *
+	 * The Scheduler is what drives animations, caret blinking, key repeat and anything
+	 * else in WonderGUI that needs to be updated over time. Each task is a callback that
+	 * is called with the current timestamp and the number of milliseconds since it was last
+	 * called. Its return value decides when it is called next:
+	 *
+	 * - 0 calls it again on next tick.
+	 * - A positive value calls it again when that many milliseconds have passed.
+	 * - A negative value puts it to sleep until woken up by wakeTask().
+	 *
+	 * Delayed tasks are kept in a timing wheel with one slot per millisecond, so a tick
+	 * only looks at the tasks that have become due since previous tick and the tasks
+	 * asking to be called every tick. Sleeping tasks cost nothing.
+	 *
+	 * The host drives the scheduler by calling tick() with a millisecond timestamp once per
+	 * frame. Posting a TickMsg to the MsgRouter, as was done before, has the same effect.
+	 * Between frames the host can check nextDeadline() to find out how long it can sleep
+	 * without delaying anything.
+	 *
+	 * Tasks may add, remove and wake tasks, including themselves, from within their callbacks.
+	 */
+
+	class Scheduler : public Object
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		static Scheduler_p	create() { return Scheduler_p(new Scheduler()); }
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static Scheduler_p	cast( Object * pObject );
+
+		//.____ Control _________________________________________________
+
+		TaskId			addTask( std::function<int(int64_t timestamp, int timediff)> callback, int delay = 0 );
+		bool			removeTask( TaskId id );
+		bool			wakeTask( TaskId id, int delay = 0 );
+
+		void			tick( int64_t timestamp );
+
+		//.____ State _________________________________________________
+
+		bool			isScheduled( TaskId id ) const;
+
+		int64_t			nextDeadline() const;
+		inline int64_t	time() const { return m_time; }
+
+		inline int		nbTasks() const { return (int) m_tasks.size(); }
+
+	private:
+		Scheduler();
+		~Scheduler();
+
+		enum class TaskState : uint8_t
+		{
+			Sleeping,
+			NextTick,
+			Delayed
+		};
+
+		struct Task
+		{
+			std::function<int(int64_t,int)>	callback;
+			int64_t		due;					// Timestamp of next call when Delayed.
+			int64_t		lastCall;
+			uint64_t	lastTickCalled;			// Prevents a task from being called twice in the same tick.
+			TaskState	state;
+		};
+
+		struct WheelEntry
+		{
+			TaskId		id;
+			int64_t		due;
+		};
+
+		void			_schedule( TaskId id, Task& task, int delay );
+		void			_wake( TaskId id, Task& task, int delay );
+		bool			_isValid( const WheelEntry& entry ) const;
+		void			_collectDue( int64_t timestamp );
+		void			_callTask( TaskId id, int64_t timestamp );
+
+		static const int	c_wheelSlots = 512;		// Must be a power of two.
+
+		std::unordered_map<TaskId,Task>	m_tasks;
+
+		std::vector<WheelEntry>	m_wheel[c_wheelSlots];
+		int						m_nbWheelEntries = 0;
+
+		std::vector<TaskId>		m_nextTick;
+		std::vector<TaskId>		m_dueTasks;				// Tasks called by tick in progress. Kept between ticks to avoid reallocation.
+
+		TaskId					m_idCounter = 1;
+		int64_t					m_time = 0;
+		uint64_t				m_tickCounter = 0;
+		bool					m_bStarted = false;
+
+		TaskId					m_runningTask = 0;
+		bool					m_bRunningTaskRemoved = false;
+
+		mutable int64_t			m_deadline = -1;
+		mutable bool			m_bDeadlineValid = true;
+	};
+
+
+} // namespace wg
+#endif //WG_SCHEDULER_DOT_H
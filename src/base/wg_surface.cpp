@@ -21,6 +21,7 @@
 =========================================================================*/
 
 #include <limits>
+#include <algorithm>
 #include <memory.h>
 #include <wg_surface.h>
 
@@ -74,7 +75,8 @@ namespace wg
 		m_accessMode( AccessMode::None ),
 		m_pPixels( nullptr ),
 		m_pClut( nullptr ),
-		m_scaleMode( ScaleMode::Nearest )
+		m_scaleMode( ScaleMode::Nearest ),
+		m_contentStamp( 0 )
 	{
 		memset( &m_pixelDescription, 0, sizeof(PixelDescription) );
 	}
@@ -186,6 +188,13 @@ namespace wg
 				}
 			}
 		}
+		else if (m_pixelDescription.format == PixelFormat::BGRA_8_pre)
+		{
+			pix = (((col.r * col.a + 127) / 255) << m_pixelDescription.R_shift) |
+				(((col.g * col.a + 127) / 255) << m_pixelDescription.G_shift) |
+				(((col.b * col.a + 127) / 255) << m_pixelDescription.B_shift) |
+				(col.a << m_pixelDescription.A_shift);
+		}
 		else
 		{
 			pix = ((col.r >> m_pixelDescription.R_loss) << m_pixelDescription.R_shift) |
@@ -227,6 +236,18 @@ namespace wg
 		else
 			col.a = ((pixel & m_pixelDescription.A_mask) >> m_pixelDescription.A_shift) << m_pixelDescription.A_loss;
 
+		if (m_pixelDescription.format == PixelFormat::BGRA_8_pre && col.a != 255)
+		{
+			if (col.a == 0)
+				col.r = col.g = col.b = 0;
+			else
+			{
+				col.r = std::min(255, (col.r * 255 + col.a / 2) / col.a);
+				col.g = std::min(255, (col.g * 255 + col.a / 2) / col.a);
+				col.b = std::min(255, (col.b * 255 + col.a / 2) / col.a);
+			}
+		}
+
 		return col;
 	}
 
@@ -293,6 +314,8 @@ namespace wg
 		if( rect.w == 0 )
 			return false;
 
+		markDirty( region );
+
 		//
 
 
@@ -414,6 +437,8 @@ namespace wg
 
 		// Do the copying
 
+		markDirty( dstRect + m_lockRegion.pos() );
+
 		bool retVal = _copyFrom( pSrcSurface->pixelDescription(), (uint8_t*) pSrcSurface->pixels(), pSrcSurface->pitch(), srcRect, dstRect, pSrcSurface->m_pClut );
 
 		// Release any temporary locks
@@ -433,10 +458,89 @@ namespace wg
 	/*
 		Copying to I8 is only allowed from other I8 content. No color conversion is then performed, CLUTs are assumed to be identical.
 		Copying from A8 to any other surface copies white pixels with alpha (if destination has alpha channel, otherwise just white pixels).
+		Copying between BGRA_8_pre and any other format premultiplies or unpremultiplies the color channels as needed.
 	*/
 
-
 	bool Surface::_copyFrom( const PixelDescription * pSrcFormat, uint8_t * pSrcPixels, int srcPitch, const Rect& srcRect, const Rect& dstRect, const Color * pCLUT )
+	{
+		bool bSrcPremultiplied = (pSrcFormat->format == PixelFormat::BGRA_8_pre);
+		bool bDstPremultiplied = (m_pixelDescription.format == PixelFormat::BGRA_8_pre);
+
+		if( bSrcPremultiplied == bDstPremultiplied )
+			return _copyPixels( pSrcFormat, pSrcPixels, srcPitch, srcRect, dstRect, pCLUT );
+
+		if( srcRect.w <= 0 || dstRect.w <= 0 )
+			return false;
+
+		if( bDstPremultiplied )
+		{
+			// Channel layout is identical to BGRA_8, so we convert as usual and premultiply in place afterwards.
+
+			if( !_copyPixels( pSrcFormat, pSrcPixels, srcPitch, srcRect, dstRect, pCLUT ) )
+				return false;
+
+			uint8_t * pLine = m_pPixels + dstRect.y * m_pitch + dstRect.x * 4;
+			for( int y = 0 ; y < srcRect.h ; y++ )
+			{
+				uint8_t * p = pLine;
+				for( int x = 0 ; x < srcRect.w ; x++ )
+				{
+					int a = p[3];
+					p[0] = (p[0] * a + 127) / 255;
+					p[1] = (p[1] * a + 127) / 255;
+					p[2] = (p[2] * a + 127) / 255;
+					p += 4;
+				}
+				pLine += m_pitch;
+			}
+			return true;
+		}
+
+		// Source is premultiplied. We unpremultiply one line at a time into a BGRA_8 buffer
+		// and convert from that.
+
+		PixelDescription straightFormat = *pSrcFormat;
+		straightFormat.format = PixelFormat::BGRA_8;
+
+		uint8_t * pBuffer = new uint8_t[srcRect.w * 4];
+		uint8_t * pSrcLine = pSrcPixels + srcRect.y * srcPitch + srcRect.x * 4;
+
+		bool retVal = true;
+		for( int y = 0 ; y < srcRect.h && retVal ; y++ )
+		{
+			uint8_t * pSrc = pSrcLine;
+			uint8_t * pDst = pBuffer;
+			for( int x = 0 ; x < srcRect.w ; x++ )
+			{
+				int a = pSrc[3];
+				if( a == 0 )
+				{
+					pDst[0] = 0;
+					pDst[1] = 0;
+					pDst[2] = 0;
+				}
+				else
+				{
+					pDst[0] = (uint8_t) std::min( 255, (pSrc[0] * 255 + a/2) / a );
+					pDst[1] = (uint8_t) std::min( 255, (pSrc[1] * 255 + a/2) / a );
+					pDst[2] = (uint8_t) std::min( 255, (pSrc[2] * 255 + a/2) / a );
+				}
+				pDst[3] = a;
+				pSrc += 4;
+				pDst += 4;
+			}
+
+			retVal = _copyPixels( &straightFormat, pBuffer, srcRect.w * 4, Rect(0,0,srcRect.w,1), Rect(dstRect.x, dstRect.y+y, dstRect.w, 1), pCLUT );
+			pSrcLine += srcPitch;
+		}
+
+		delete [] pBuffer;
+		return retVal;
+	}
+
+	//____ _copyPixels() _________________________________________________________
+
+	bool Surface::_copyPixels( const PixelDescription * pSrcFormat, uint8_t * pSrcPixels, int srcPitch, const Rect& srcRect, const Rect& dstRect, const Color * pCLUT )
 	{
 
 		if( srcRect.w <= 0 || dstRect.w <= 0 )
@@ -891,6 +995,62 @@ namespace wg
 		return true;
 	}
 
+	//____ markDirty() ___________________________________________________________
+	/**
+	 * @brief Mark region of surface as modified.
+	 *
+	 * @param region	Region of surface that has been modified.
+	 *
+	 * Modified regions are collected in dirtyRects() until cleared, so that consumers
+	 * such as stream and GPU surfaces only need to transfer the parts that have changed.
+	 *
+	 * Regions written through fill(), copyFrom(), rendering by a GfxDevice or a lock are
+	 * marked automatically. Unlocking a surface marks the whole locked region, unless
+	 * the parts actually modified have been marked by calls to markDirty() while locked.
+	 *
+	 * Every modification also increases contentStamp(), which lets cached information
+	 * about the pixels be checked for validity.
+	 **/
 
+	void Surface::markDirty( const Rect& region )
+	{
+		Rect rect( region, Rect( 0, 0, size() ) );
+		if( rect.w <= 0 || rect.h <= 0 )
+			return;
+
+		if( m_accessMode == AccessMode::None )
+		{
+			m_dirtyRects.add( rect );
+			m_contentStamp++;
+		}
+		else if( m_accessMode != AccessMode::ReadOnly )
+			m_lockDirtyRects.add( Rect( rect, m_lockRegion ) );
+	}
+
+	//____ _commitLockDirtyRects() _______________________________________________
+	// Called by unlock(). Marks whole lock region if nothing else was marked and adds
+	// the result to dirty rects. Regions are left in m_lockDirtyRects for the caller
+	// to use and clear.
+
+	void Surface::_commitLockDirtyRects()
+	{
+		if( m_accessMode == AccessMode::None || m_accessMode == AccessMode::ReadOnly )
+			return;
+
+		if( m_lockDirtyRects.isEmpty() )
+			m_lockDirtyRects.add( m_lockRegion );
+
+		m_dirtyRects.add( m_lockDirtyRects );
+		m_contentStamp++;
+	}
+
+	//____ _setClut() ____________________________________________________________
+	// Makes surface share the palette with these colors, created if needed.
+
+	void Surface::_setClut( const Color * pClut )
+	{
+		m_pPalette = Palette::create( pClut );
+		m_pClut = m_pPalette ? m_pPalette->colors() : nullptr;
+	}
 
 } // namespace wg
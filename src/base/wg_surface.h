@@ -30,6 +30,8 @@
 #include <wg_color.h>
 #include <wg_pointers.h>
 #include <wg_blob.h>
+#include <wg_palette.h>
+#include <wg_bandedpatches.h>
 
 namespace wg
 {
@@ -131,6 +133,7 @@ namespace wg
 		virtual	Color		pixelToColor( uint32_t pixel ) const;		///< @brief Get the color and alpha values of a pixel.
 
 		inline const Color * clut() const { return m_pClut; }
+		inline Palette_p	palette() const { return m_pPalette; }		///< @brief Get the shared palette of an indexed surface, or nullptr.
 
 		//.____ Control _______________________________________________________
 
@@ -209,6 +212,12 @@ namespace wg
 																			///< @return Pointer to the raw pixels of the locked region or
 																			///<		 null if surface is not locked.
 
+		void				markDirty( const Rect& region );
+		inline const BandedPatches&	dirtyRects() const { return m_dirtyRects; }	///< @brief Get regions modified since dirty rects last were cleared.
+		inline bool			isDirty() const { return !m_dirtyRects.isEmpty(); }			///< @brief Check if surface has been modified since dirty rects last were cleared.
+		inline void			clearDirtyRects() { m_dirtyRects.clear(); }					///< @brief Forget about modified regions, typically once they have been consumed.
+		inline uint32_t	contentStamp() const { return m_contentStamp; }			///< @brief Get counter increased every time the content of the surface is modified.
+
 		//.____  Rendering ____________________________________________________
 
 		virtual bool		fill( Color col );						///< @brief Fill surface with specified color.
@@ -225,6 +234,9 @@ namespace wg
 
 		Rect				_lockAndAdjustRegion( AccessMode modeNeeded, const Rect& region );
 		bool 				_copyFrom( const PixelDescription * pSrcFormat, uint8_t * pSrcPixels, int srcPitch, const Rect& srcRect, const Rect& dstRect, const Color * pCLUT = nullptr );
+		bool 				_copyPixels( const PixelDescription * pSrcFormat, uint8_t * pSrcPixels, int srcPitch, const Rect& srcRect, const Rect& dstRect, const Color * pCLUT );
+		void				_setClut( const Color * pClut );
+		void				_commitLockDirtyRects();
 
 		PixelDescription	m_pixelDescription;
 		int					m_pitch;
@@ -232,10 +244,15 @@ namespace wg
 		ScaleMode			m_scaleMode;
 
 		AccessMode			m_accessMode;
-		Color *				m_pClut;			// Pointer at color lookup table. Always 256 entries long.
+		const Color *		m_pClut;			// Pointer at colors of m_pPalette or null. Always 256 entries long.
+		Palette_p			m_pPalette;			// Shared color lookup table of indexed surfaces.
 		uint8_t *			m_pPixels;			// Pointer at pixels when surface locked.
 		Rect				m_lockRegion;		// Region of surface that is locked. Width/Height should be set to 0 when not locked.
 
+		BandedPatches		m_dirtyRects;		// Regions modified since last call to clearDirtyRects().
+		BandedPatches		m_lockDirtyRects;	// Regions marked dirty during current lock.
+		uint32_t			m_contentStamp;		// Increased on every modification, unlike dirty rects never cleared.
+
 	};
 
 	//____ Surface::pitch() _______________________________________________
@@ -0,0 +1,424 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_surfaceatlas.h>
+#include <wg_skin.h>
+#include <wg_resdb.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits.h>
+
+namespace wg
+{
+
+	const char SurfaceAtlas::CLASSNAME[] = {"SurfaceAtlas"};
+
+	//____ create() _______________________________________________________________
+
+	SurfaceAtlas_p SurfaceAtlas::create( SurfaceFactory * pFactory, Size pageSize, int padding )
+	{
+		if( !pFactory || pageSize.w <= 0 || pageSize.h <= 0 || padding < 0 )
+			return nullptr;
+
+		return SurfaceAtlas_p( new SurfaceAtlas( pFactory, pageSize, padding ) );
+	}
+
+	//____ Constructor ____________________________________________________________
+
+	SurfaceAtlas::SurfaceAtlas( SurfaceFactory * pFactory, Size pageSize, int padding ) :
+		m_pFactory(pFactory),
+		m_pageSize(pageSize),
+		m_padding(padding)
+	{
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool SurfaceAtlas::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Object::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * SurfaceAtlas::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	SurfaceAtlas_p SurfaceAtlas::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return SurfaceAtlas_p( static_cast<SurfaceAtlas*>(pObject) );
+
+		return 0;
+	}
+
+	//____ add() __________________________________________________________________
+	/**
+	 * @brief Add surface to be packed by next call to pack().
+	 *
+	 * @return False if surface already has been added or has a pixel format that pages
+	 *		   can not be created with (Unknown or Custom).
+	 */
+
+	bool SurfaceAtlas::add( Surface * pSurface )
+	{
+		if( !pSurface || contains( pSurface ) )
+			return false;
+
+		PixelFormat format = pSurface->pixelFormat();
+		if( format == PixelFormat::Unknown || format == PixelFormat::Custom )
+			return false;
+
+		m_pending.push_back( pSurface );
+		return true;
+	}
+
+	//____ pack() _________________________________________________________________
+	/**
+	 * @brief Copy all surfaces added since last pack into the pages.
+	 *
+	 * Free space in existing pages with the same pixel format, scale mode and palette
+	 * is used before new pages are created.
+	 *
+	 * @return False if any surface was too large for a page or a page could not be created.
+	 */
+
+	bool SurfaceAtlas::pack()
+	{
+		// Placing the tallest surfaces first keeps the skyline flat.
+
+		std::vector<Surface_p> pending;
+		pending.swap( m_pending );
+
+		std::stable_sort( pending.begin(), pending.end(), []( const Surface_p& a, const Surface_p& b )
+		{
+			Size sa = a->size();
+			Size sb = b->size();
+			return sa.h != sb.h ? sa.h > sb.h : sa.w > sb.w;
+		});
+
+		bool bAllPacked = true;
+
+		for( auto& pSource : pending )
+		{
+			Size size = pSource->size() + Size( m_padding*2, m_padding*2 );
+
+			if( size.w > m_pageSize.w || size.h > m_pageSize.h )
+			{
+				bAllPacked = false;
+				continue;
+			}
+
+			Coord	pos;
+			int		pageIdx = 0;
+
+			while( pageIdx < (int) m_pages.size() && !(_isMatch( m_pages[pageIdx], pSource ) && _findPosition( m_pages[pageIdx], size, pos )) )
+				pageIdx++;
+
+			if( pageIdx == (int) m_pages.size() )
+			{
+				if( !_addPage( pSource ) || !_findPosition( m_pages.back(), size, pos ) )
+				{
+					bAllPacked = false;
+					continue;
+				}
+			}
+
+			Page& page = m_pages[pageIdx];
+
+			if( !_copyExtruded( page.pSurface, pSource, pos ) )
+			{
+				bAllPacked = false;
+				continue;
+			}
+
+			_occupy( page, Rect( pos, size ) );
+			m_placements[pSource.rawPtr()] = { pSource, pageIdx, pos + Coord( m_padding, m_padding ) };
+		}
+
+		return bAllPacked;
+	}
+
+	//____ clear() ________________________________________________________________
+
+	void SurfaceAtlas::clear()
+	{
+		m_pages.clear();
+		m_pending.clear();
+		m_placements.clear();
+	}
+
+	//____ contains() _____________________________________________________________
+	/**
+	 * @brief Check if surface has been added, packed or not.
+	 */
+
+	bool SurfaceAtlas::contains( Surface * pSurface ) const
+	{
+		if( m_placements.count( pSurface ) )
+			return true;
+
+		for( auto& p : m_pending )
+			if( p.rawPtr() == pSurface )
+				return true;
+
+		return false;
+	}
+
+	//____ region() _______________________________________________________________
+	/**
+	 * @brief Get where the content of a surface can be found.
+	 *
+	 * Surfaces not packed, including surfaces never added, are their own region.
+	 */
+
+	SurfaceAtlas::Region SurfaceAtlas::region( Surface * pSurface ) const
+	{
+		auto it = m_placements.find( pSurface );
+		if( it == m_placements.end() )
+			return { pSurface, pSurface ? Rect( 0, 0, pSurface->size() ) : Rect() };
+
+		return { m_pages[it->second.page].pSurface, Rect( it->second.pos, pSurface->size() ) };
+	}
+
+	//____ page() _________________________________________________________________
+
+	Surface_p SurfaceAtlas::page( int index ) const
+	{
+		if( index < 0 || index >= (int) m_pages.size() )
+			return nullptr;
+
+		return m_pages[index].pSurface;
+	}
+
+	//____ relocate() _____________________________________________________________
+	/**
+	 * @brief Move skin over to the pages for all packed surfaces it uses.
+	 *
+	 * @return True if the skin uses any packed surface.
+	 */
+
+	bool SurfaceAtlas::relocate( Skin * pSkin ) const
+	{
+		if( !pSkin )
+			return false;
+
+		bool bRelocated = false;
+		for( auto& entry : m_placements )
+			bRelocated |= pSkin->relocateSurface( entry.first, m_pages[entry.second.page].pSurface, entry.second.pos );
+
+		return bRelocated;
+	}
+
+	/**
+	 * @brief Relocate all skins of a ResDB, including those of nested databases.
+	 *
+	 * @return Number of skins relocated.
+	 */
+
+	int SurfaceAtlas::relocate( ResDB * pDB ) const
+	{
+		if( !pDB )
+			return 0;
+
+		int nRelocated = 0;
+
+		for( ResDB::ResDBRes * pRes = pDB->getFirstResDbRes() ; pRes ; pRes = pRes->next() )
+			nRelocated += relocate( pRes->res.rawPtr() );
+
+		for( ResDB::SkinRes * pRes = pDB->getFirstResSkin() ; pRes ; pRes = pRes->next() )
+			if( relocate( pRes->res.rawPtr() ) )
+				nRelocated++;
+
+		return nRelocated;
+	}
+
+	//____ _findPosition() ________________________________________________________
+	// Lowest, then leftmost, position where size fits on top of the skyline.
+
+	bool SurfaceAtlas::_findPosition( const Page& page, Size size, Coord& pos ) const
+	{
+		const std::vector<Segment>& skyline = page.skyline;
+
+		int bestY = INT_MAX;
+
+		for( size_t i = 0 ; i < skyline.size() ; i++ )
+		{
+			int x = skyline[i].x;
+			if( x + size.w > m_pageSize.w )
+				break;
+
+			int y = 0;
+			for( size_t j = i ; j < skyline.size() && skyline[j].x < x + size.w ; j++ )
+				y = std::max( y, skyline[j].y );
+
+			if( y + size.h <= m_pageSize.h && y < bestY )
+			{
+				bestY = y;
+				pos = Coord( x, y );
+			}
+		}
+
+		return bestY != INT_MAX;
+	}
+
+	//____ _occupy() ______________________________________________________________
+	// Raises the skyline under rect to its bottom edge.
+
+	void SurfaceAtlas::_occupy( Page& page, const Rect& _rect )
+	{
+		int x1 = _rect.x;
+		int x2 = std::min( _rect.x + _rect.w, m_pageSize.w );
+
+		std::vector<Segment> skyline;
+		skyline.reserve( page.skyline.size() + 2 );
+
+		bool bInserted = false;
+		for( auto& seg : page.skyline )
+		{
+			int segEnd = seg.x + seg.w;
+
+			if( segEnd <= x1 || seg.x >= x2 )
+			{
+				if( seg.x >= x2 && !bInserted )
+				{
+					skyline.push_back( { x1, _rect.y + _rect.h, x2 - x1 } );
+					bInserted = true;
+				}
+				skyline.push_back( seg );
+				continue;
+			}
+
+			if( seg.x < x1 )
+				skyline.push_back( { seg.x, seg.y, x1 - seg.x } );
+
+			if( !bInserted )
+			{
+				skyline.push_back( { x1, _rect.y + _rect.h, x2 - x1 } );
+				bInserted = true;
+			}
+
+			if( segEnd > x2 )
+				skyline.push_back( { x2, seg.y, segEnd - x2 } );
+		}
+
+		if( !bInserted )
+			skyline.push_back( { x1, _rect.y + _rect.h, x2 - x1 } );
+
+		// Join neighbours at the same height.
+
+		page.skyline.clear();
+		for( auto& seg : skyline )
+		{
+			if( !page.skyline.empty() && page.skyline.back().y == seg.y )
+				page.skyline.back().w += seg.w;
+			else
+				page.skyline.push_back( seg );
+		}
+	}
+
+	//____ _isMatch() _____________________________________________________________
+	// Page can hold surface without it looking any different.
+
+	bool SurfaceAtlas::_isMatch( const Page& page, Surface * pSurface ) const
+	{
+		return page.format == pSurface->pixelFormat() && page.scaleMode == pSurface->scaleMode() &&
+				page.pPalette == pSurface->palette();
+	}
+
+	//____ _addPage() _____________________________________________________________
+	// Adds a page matching pSurface.
+
+	bool SurfaceAtlas::_addPage( Surface * pSurface )
+	{
+		Palette_p pPalette = pSurface->palette();
+
+		Surface_p pPage = m_pFactory->createSurface( m_pageSize, pSurface->pixelFormat(), SurfaceFlag::Static, pPalette ? pPalette->colors() : nullptr );
+		if( !pPage )
+			return false;
+
+		pPage->setScaleMode( pSurface->scaleMode() );
+		pPage->fill( Color( 0, 0, 0, 0 ) );
+
+		m_pages.emplace_back();
+		Page& page = m_pages.back();
+		page.pSurface = pPage;
+		page.format = pSurface->pixelFormat();
+		page.scaleMode = pSurface->scaleMode();
+		page.pPalette = pPalette;
+		page.skyline.push_back( { 0, 0, m_pageSize.w } );
+		return true;
+	}
+
+	//____ _copyExtruded() ________________________________________________________
+	// Copies pSource to pos + padding in pPage, repeating its edge pixels over the padding.
+	// Pixels are copied as is, since pages have the same format as their surfaces.
+
+	bool SurfaceAtlas::_copyExtruded( Surface * pPage, Surface * pSource, Coord pos ) const
+	{
+		Size size = pSource->size();
+		int	 padding = m_padding;
+
+		const uint8_t * pSrc = pSource->lock( AccessMode::ReadOnly );
+		if( !pSrc )
+			return false;
+
+		uint8_t * pDst = pPage->lockRegion( AccessMode::WriteOnly, Rect( pos, size.w + padding*2, size.h + padding*2 ) );
+		if( !pDst )
+		{
+			pSource->unlock();
+			return false;
+		}
+
+		int pixelBytes = pSource->pixelDescription()->bits / 8;
+		int srcPitch = pSource->pitch();
+		int dstPitch = pPage->pitch();
+		int lineBytes = size.w * pixelBytes;
+
+		for( int y = 0 ; y < size.h + padding*2 ; y++ )
+		{
+			const uint8_t * pSrcLine = pSrc + std::min( std::max( y - padding, 0 ), size.h - 1 ) * srcPitch;
+			uint8_t * pDstLine = pDst + y * dstPitch;
+
+			for( int x = 0 ; x < padding ; x++ )
+			{
+				std::memcpy( pDstLine + x * pixelBytes, pSrcLine, pixelBytes );
+				std::memcpy( pDstLine + (padding + size.w + x) * pixelBytes, pSrcLine + lineBytes - pixelBytes, pixelBytes );
+			}
+
+			std::memcpy( pDstLine + padding * pixelBytes, pSrcLine, lineBytes );
+		}
+
+		pPage->unlock();
+		pSource->unlock();
+		return true;
+	}
+
+} // namespace wg
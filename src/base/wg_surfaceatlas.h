@@ -0,0 +1,147 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_SURFACEATLAS_DOT_H
+#define WG_SURFACEATLAS_DOT_H
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <wg_pointers.h>
+#include <wg_surface.h>
+#include <wg_surfacefactory.h>
+
+namespace wg
+{
+	class Skin;
+	class ResDB;
+
+	class SurfaceAtlas;
+	typedef	StrongPtr<SurfaceAtlas>		SurfaceAtlas_p;
+	typedef	WeakPtr<SurfaceAtlas>		SurfaceAtlas_wp;
+
+	//____ SurfaceAtlas _______________________________________________________
+	/**
+	 * @brief Packs many small surfaces into a few shared ones.
+	 *
+	 * Skins and icons that each use their own surface makes the GfxDevice switch blit
+	 * source for almost everything it draws, which is costly for devices like
+	 * StreamGfxDevice and defeats batching. SurfaceAtlas copies the content of the surfaces
+	 * added to it into large pages at load time, so that they can share blit source.
+	 *
+	 * After pack(), region() tells where a surface ended up. relocate() moves skins over to
+	 * the pages, which they then use transparently through Skin::relocateSurface().
+	 *
+	 * Pages are packed using a skyline, placing each surface as low as possible. Surfaces that
+	 * do not fit in an empty page are left out and keep being used as they are.
+	 *
+	 * Each page only holds surfaces of one pixel format, scale mode and palette, which it
+	 * takes over from them, so packed surfaces look the same as before when scaled. The
+	 * padding around each surface is filled with its edge pixels, which keeps neighbours
+	 * from bleeding in when interpolating.
+	 *
+	 * The atlas keeps its pages and the added surfaces alive until cleared. Since some skins
+	 * (like MultiBlockSkin) do not keep their surfaces alive, the atlas must be kept
+	 * for as long as relocated skins are in use.
+	 */
+
+	class SurfaceAtlas : public Object
+	{
+	public:
+		//.____ Creation __________________________________________
+
+		static SurfaceAtlas_p	create( SurfaceFactory * pFactory, Size pageSize = Size(1024,1024), int padding = 1 );
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static SurfaceAtlas_p	cast( Object * pObject );
+
+		//.____ Content _______________________________________________
+
+		struct Region
+		{
+			Surface_p	pSurface;			///< Page the surface was copied to, or the surface itself if not packed.
+			Rect		rect;				///< Area in pSurface.
+		};
+
+		bool				add( Surface * pSurface );
+		bool				pack();
+		void				clear();
+
+		bool				contains( Surface * pSurface ) const;
+		Region				region( Surface * pSurface ) const;
+
+		inline int			nbPages() const { return (int) m_pages.size(); }
+		Surface_p			page( int index ) const;
+
+		//.____ Misc __________________________________________________
+
+		bool				relocate( Skin * pSkin ) const;
+		int					relocate( ResDB * pDB ) const;
+
+	protected:
+		SurfaceAtlas( SurfaceFactory * pFactory, Size pageSize, int padding );
+		virtual ~SurfaceAtlas() {}
+
+		struct Segment						// Part of the skyline: x to x+w is free from y and down.
+		{
+			int		x;
+			int		y;
+			int		w;
+		};
+
+		struct Page
+		{
+			Surface_p				pSurface;
+			PixelFormat				format;
+			ScaleMode				scaleMode;
+			Palette_p				pPalette;
+			std::vector<Segment>	skyline;
+		};
+
+		struct Placement
+		{
+			Surface_p	pSource;			// Keeps source alive, so its pointer is never reused for another surface.
+			int			page;
+			Coord		pos;				// Position in page, inside the padding.
+		};
+
+		bool				_findPosition( const Page& page, Size size, Coord& pos ) const;
+		void				_occupy( Page& page, const Rect& rect );
+		bool				_isMatch( const Page& page, Surface * pSurface ) const;
+		bool				_addPage( Surface * pSurface );
+		bool				_copyExtruded( Surface * pPage, Surface * pSource, Coord pos ) const;
+
+		SurfaceFactory_p	m_pFactory;
+		Size				m_pageSize;
+		int					m_padding;
+
+		std::vector<Page>							m_pages;
+		std::vector<Surface_p>						m_pending;
+		std::unordered_map<Surface*,Placement>		m_placements;
+	};
+
+} // namespace wg
+#endif //WG_SURFACEATLAS_DOT_H
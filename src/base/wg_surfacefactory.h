@@ -70,8 +70,15 @@ namespace wg
 										   const Color * pClut = nullptr) const = 0;
 		virtual Surface_p	createSurface( Surface * pOther, int flags = SurfaceFlag::Static ) const = 0;
 
+		//.____ Behavior ____________________________________________________
+
+		void				setPremultiplyOnLoad( bool bPremultiply ) { m_bPremultiplyOnLoad = bPremultiply; }	///< @brief Convert BGRA_8 content to BGRA_8_pre when creating surfaces from existing pixels.
+		bool				premultiplyOnLoad() const { return m_bPremultiplyOnLoad; }							///< @brief Check if BGRA_8 content is converted to BGRA_8_pre on creation.
+
 	protected:
 		virtual ~SurfaceFactory() {}
+
+		bool				m_bPremultiplyOnLoad = false;
 	};
 
 
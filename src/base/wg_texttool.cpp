@@ -43,6 +43,58 @@ namespace wg
 	static char	breakRulesTab[256];
 
 
+	// Helpers for processing UTF-8 strings eight bytes at a time. Plain ASCII dominates
+	// most texts, so we skip through it a word at a time and only decode what's left
+	// character by character.
+
+	const static uint64_t	c_lowBits	= 0x0101010101010101ULL;
+	const static uint64_t	c_highBits	= 0x8080808080808080ULL;
+	const static uint64_t	c_lowSeven	= 0x7F7F7F7F7F7F7F7FULL;
+	const static uint64_t	c_newlines	= 0x0A0A0A0A0A0A0A0AULL;
+
+	static inline uint64_t _loadWord( const char * p )
+	{
+		uint64_t w;
+		memcpy( &w, p, 8 );
+		return w;
+	}
+
+	// True if all bytes are 7-bit characters other than null.
+
+	static inline bool _isAsciiWord( uint64_t w )
+	{
+		return ((w | ((w - c_lowBits) & ~w)) & c_highBits) == 0;
+	}
+
+	// Number of line feeds among the bytes.
+
+	static inline int _countNewlines( uint64_t w )
+	{
+		uint64_t x = w ^ c_newlines;
+		uint64_t mask = ~(((x & c_lowSeven) + c_lowSeven) | x) & c_highBits;
+		return (int) (((mask >> 7) * c_lowBits) >> 56);
+	}
+
+	// Number of bytes to decode character by character after a word that wasn't plain ASCII.
+	// Doubles for each word in a row that fails, so text with dense non-ASCII doesn't
+	// spend time testing words that rarely pass.
+
+	static inline int _scalarRun( int prevRun, bool bAsciiBefore )
+	{
+		return bAsciiBefore ? 8 : std::min( prevRun*2, 256 );
+	}
+
+	// Length in bytes of string, not looking further than needed for maxChars characters.
+
+	static inline int _utf8Length( const char * pStr, uint32_t maxChars )
+	{
+		if( maxChars >= INT_MAX/4 )
+			return (int) strlen( pStr );
+
+		return (int) strnlen( pStr, maxChars*4 );
+	}
+
+
 	//____ parseChar() ____________________________________________________________
 
 	uint16_t TextTool::parseChar( const char * pChar )
@@ -198,10 +250,39 @@ namespace wg
 				pDst[0] = 0;
 			return 0;
 		}
+		// Work on a local copy of the pointer, so the compiler doesn't need to assume
+		// that writing to pDst might change it.
+
+		const char * p = pSrc;
+		const char * pEnd = p + _utf8Length( p, maxChars );
 		uint32_t n = 0;
+		int run = 4;
 
-		while(n < maxChars && * pSrc != 0 )
-			pDst[n++] = readChar(pSrc);
+		while( n < maxChars && p < pEnd )
+		{
+			const char * pBeg = p;
+
+			while( n + 8 <= maxChars && p + 8 <= pEnd && _isAsciiWord( _loadWord(p) ) )
+			{
+				for( int i = 0 ; i < 8 ; i++ )
+					pDst[n+i] = (uint8_t) p[i];
+				n += 8;
+				p += 8;
+			}
+
+			// Decode character by character for a while before trying again.
+
+			if( p == pEnd )
+				break;
+
+			run = _scalarRun( run, p != pBeg );
+
+			const char * pStop = pEnd - p > run ? p + run : pEnd;
+			while( n < maxChars && p < pStop )
+				pDst[n++] = readChar(p);
+		}
+
+		pSrc = p;
 
 		if( n != maxChars )
 			pDst[n] = 0;
@@ -217,12 +298,40 @@ namespace wg
 				pDst[0].setCode(0);
 			return 0;
 		}
+		// Work on a local copy of the pointer, so the compiler doesn't need to assume
+		// that writing to pDst might change it.
+
+		const char * p = pSrc;
+		const char * pEnd = p + _utf8Length( p, maxChars );
 		uint32_t n = 0;
+		int run = 4;
 
-		while(n < maxChars && * pSrc != 0 )
+		while( n < maxChars && p < pEnd )
 		{
-			pDst[n++].setCode(readChar(pSrc));
+			const char * pBeg = p;
+
+			while( n + 8 <= maxChars && p + 8 <= pEnd && _isAsciiWord( _loadWord(p) ) )
+			{
+				for( int i = 0 ; i < 8 ; i++ )
+					pDst[n+i].setCode( (uint8_t) p[i] );
+				n += 8;
+				p += 8;
+			}
+
+			// Decode character by character for a while before trying again.
+
+			if( p == pEnd )
+				break;
+
+			run = _scalarRun( run, p != pBeg );
+
+			const char * pStop = pEnd - p > run ? p + run : pEnd;
+			while( n < maxChars && p < pStop )
+				pDst[n++].setCode(readChar(p));
 		}
+
+		pSrc = p;
+
 		if( n != maxChars )
 			pDst[n].setCode(0);
 		return n;
@@ -420,13 +529,13 @@ namespace wg
 		for( int i = 0 ; i < n ; i++ )
 		{
 
-			uint16_t h = p[i].styleHandle();
+			TextStyle_h h = p[i].styleHandle();
 			if( h == hStyle )
 				nStyle++;
 			else
 			{
 				if( hStyle )
-					TextStyleManager::_getPointer(hStyle)->_decRefCount( nStyle );
+					TextStyleManager::_getPointer(hStyle)->_incRefCount( nStyle );
 
 				hStyle = h;
 				nStyle = 1;
@@ -434,7 +543,7 @@ namespace wg
 		}
 
 		if( hStyle )
-			TextStyleManager::_getPointer(hStyle)->_decRefCount( nStyle );
+			TextStyleManager::_getPointer(hStyle)->_incRefCount( nStyle );
 	}
 
 
@@ -445,11 +554,35 @@ namespace wg
 		if( !pStr )
 			return 0;
 
+		const char * p = pStr;
+		const char * pEnd = pStr + (strlen == INT_MAX ? ::strlen(pStr) : strnlen(pStr,strlen) );
+
 		int n = 0;
-		for( const char * p = pStr ; (p - pStr) < strlen ; n++ )
-			if( readChar(p) == 0 )
+		int run = 4;
+
+		while( p < pEnd )
+		{
+			const char * pBeg = p;
+
+			while( p + 8 <= pEnd && _isAsciiWord( _loadWord(p) ) )
+			{
+				p += 8;
+				n += 8;
+			}
+
+			if( p == pEnd )
 				break;
 
+			run = _scalarRun( run, p != pBeg );
+
+			const char * pStop = pEnd - p > run ? p + run : pEnd;
+			while( p < pStop )
+			{
+				readChar(p);
+				n++;
+			}
+		}
+
 		return n;
 	}
 
@@ -473,8 +606,16 @@ namespace wg
 		if( !pStr )
 			return 0;
 
+		const char * pEnd = pStr + ::strlen(pStr);
+
 		uint32_t n = 1;
-		while( * pStr != 0 )
+		while( pStr + 8 <= pEnd )
+		{
+			n += _countNewlines( _loadWord(pStr) );
+			pStr += 8;
+		}
+
+		while( pStr < pEnd )
 		{
 			if( * pStr++ == '\n' )
 				n++;
@@ -585,21 +726,40 @@ namespace wg
 		if( !pStr )
 			return;
 
-		const char * pEnd = pStr + strlen;
+		const char * pEnd = pStr + (strlen >= INT_MAX ? ::strlen(pStr) : strnlen(pStr,strlen) );
 
 		nChars = 0;
 		nLines = 1;
 
-		while( pStr != pEnd )
+		int run = 4;
+
+		while( pStr < pEnd )
 		{
-			uint16_t c = readChar(pStr);
-			if( c == 0 )
+			const char * pBeg = pStr;
+
+			while( pStr + 8 <= pEnd )
+			{
+				uint64_t w = _loadWord(pStr);
+				if( !_isAsciiWord(w) )
+					break;
+
+				nLines += _countNewlines(w);
+				nChars += 8;
+				pStr += 8;
+			}
+
+			if( pStr == pEnd )
 				break;
 
-			if( c == (uint16_t) '\n' )
-				nLines++;
+			run = _scalarRun( run, pStr != pBeg );
 
-			nChars++;
+			const char * pStop = pEnd - pStr > run ? pStr + run : pEnd;
+			while( pStr < pStop )
+			{
+				if( readChar(pStr) == (uint16_t) '\n' )
+					nLines++;
+				nChars++;
+			}
 		}
 	}
 
@@ -1183,7 +1343,7 @@ namespace wg
 		int				refCnt = 0;
 		int				refCntTotal = 0;
 		TextStyle_h		old_style = 0xFFFF;
-		TextStyle_h		new_style = pStyle->handle();
+		TextStyle_h		new_style = pStyle ? pStyle->handle() : 0;
 
 		for( int i = 0 ; i < nb ; i++ )
 		{
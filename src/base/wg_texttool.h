@@ -47,6 +47,7 @@ namespace wg
 		friend class String;
 		friend class CharSeq;
 		friend class CharSeq::CharBasket;
+		friend class ChunkedCharBuffer;
 
 	public:
 
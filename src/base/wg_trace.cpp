@@ -0,0 +1,206 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_trace.h>
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+
+namespace wg
+{
+	namespace
+	{
+		struct TraceEvent
+		{
+			const char *	pName;
+			int64_t			begin;
+			int64_t			end;
+		};
+
+		// Written by its own thread only. Other threads only read, so the write count
+		// is all that needs to be atomic.
+
+		struct TraceBuffer
+		{
+			int						threadId;
+			std::vector<TraceEvent>	events;
+			std::atomic<uint64_t>	nWritten;
+		};
+
+		std::mutex					s_buffersMutex;			// Protects s_buffers, not the content of the buffers.
+		std::vector<TraceBuffer*>	s_buffers;
+
+		thread_local TraceBuffer *	t_pBuffer = nullptr;
+
+		const int64_t				c_timeBase = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::atomic<bool>	Trace::s_bEnabled(false);
+	int					Trace::s_bufferSize = 65536;
+
+
+	//____ setEnabled() ___________________________________________________________
+
+	void Trace::setEnabled( bool bEnabled )
+	{
+		s_bEnabled.store(bEnabled, std::memory_order_relaxed);
+	}
+
+	//____ setBufferSize() ________________________________________________________
+	/**
+	 * @brief Set number of events kept per thread.
+	 *
+	 * Only affects buffers of threads that have not recorded anything yet, or
+	 * all threads after a call to clear(). Default is 65536 events.
+	 */
+
+	void Trace::setBufferSize( int events )
+	{
+		s_bufferSize = std::max(events, 16);
+	}
+
+	//____ clear() ________________________________________________________________
+	/**
+	 * @brief Remove all recorded events.
+	 *
+	 * Must not be called while other threads are recording.
+	 */
+
+	void Trace::clear()
+	{
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+		for( auto pBuffer : s_buffers )
+		{
+			pBuffer->events.assign(s_bufferSize, TraceEvent());
+			pBuffer->nWritten.store(0, std::memory_order_release);
+		}
+	}
+
+	//____ chromeTraceJSON() ______________________________________________________
+	/**
+	 * @brief Get recorded events as Chrome trace_event JSON.
+	 *
+	 * Events overwritten by threads still recording while we read are left out.
+	 */
+
+	std::string Trace::chromeTraceJSON()
+	{
+		std::string	json = "{\"traceEvents\":[\n";
+		char		temp[256];
+		bool		bFirst = true;
+
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+		for( auto pBuffer : s_buffers )
+		{
+			uint64_t capacity = pBuffer->events.size();
+			uint64_t end = pBuffer->nWritten.load(std::memory_order_acquire);
+			uint64_t begin = end > capacity ? end - capacity : 0;
+
+			std::vector<TraceEvent> events;
+			events.reserve(end - begin);
+			for( uint64_t i = begin ; i < end ; i++ )
+				events.push_back( pBuffer->events[i % capacity] );
+
+			// Drop events that might have been overwritten while we copied.
+
+			uint64_t written = pBuffer->nWritten.load(std::memory_order_acquire);
+			size_t firstValid = written > capacity + begin ? std::min<size_t>(written - capacity - begin, events.size()) : 0;
+
+			for( size_t i = firstValid ; i < events.size() ; i++ )
+			{
+				const TraceEvent& e = events[i];
+
+				json += bFirst ? "" : ",\n";
+				bFirst = false;
+
+				json += "{\"name\":\"";
+				for( const char * p = e.pName ; *p ; p++ )
+				{
+					if( *p == '"' || *p == '\\' )
+						json += '\\';
+					json += *p;
+				}
+
+				snprintf( temp, sizeof(temp), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+						  pBuffer->threadId, (e.begin - c_timeBase) / 1000.0, (e.end - e.begin) / 1000.0 );
+				json += temp;
+			}
+		}
+
+		json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return json;
+	}
+
+	//____ exportChromeTrace() ____________________________________________________
+
+	bool Trace::exportChromeTrace( const char * pPath )
+	{
+		FILE * fp = fopen( pPath, "wb" );
+		if( !fp )
+			return false;
+
+		std::string json = chromeTraceJSON();
+		size_t written = fwrite( json.data(), 1, json.size(), fp );
+		fclose(fp);
+
+		return written == json.size();
+	}
+
+	//____ _now() _________________________________________________________________
+
+	int64_t Trace::_now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//____ _record() ______________________________________________________________
+
+	void Trace::_record( const char * pName, int64_t begin, int64_t end )
+	{
+		TraceBuffer * pBuffer = t_pBuffer;
+
+		if( !pBuffer )
+		{
+			// First event of this thread. Buffers are kept until the program ends
+			// so that events of finished threads can still be exported.
+
+			pBuffer = new TraceBuffer();
+			pBuffer->events.resize(s_bufferSize);
+			pBuffer->nWritten.store(0, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> lock(s_buffersMutex);
+			pBuffer->threadId = (int) s_buffers.size() + 1;
+			s_buffers.push_back(pBuffer);
+			t_pBuffer = pBuffer;
+		}
+
+		uint64_t n = pBuffer->nWritten.load(std::memory_order_relaxed);
+		pBuffer->events[n % pBuffer->events.size()] = { pName, begin, end };
+		pBuffer->nWritten.store(n + 1, std::memory_order_release);
+	}
+
+} // namespace wg
@@ -0,0 +1,118 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#ifndef	WG_TRACE_DOT_H
+#define	WG_TRACE_DOT_H
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+
+#include <wg_userdefines.h>
+
+namespace wg
+{
+
+	//____ Trace ______________________________________________________________
+	/**
+	 * @brief	Static class for lightweight timeline tracing.
+	 *
+	 * Time spent in scopes marked with WG_TRACE_SCOPE() is recorded while tracing
+	 * is enabled and can be exported as Chrome trace_event JSON, to be viewed in
+	 * chrome://tracing or Perfetto.
+	 *
+	 * Each thread records into its own ring buffer, so recording takes no locks.
+	 * When a buffer is full the oldest events are overwritten, which keeps the
+	 * latest frames available when looking for a spike.
+	 *
+	 * When tracing is disabled a scope only costs a check of a flag. Define
+	 * WG_NO_TRACING in wg_userdefines.h to compile out the scopes completely.
+	 *
+	 * Trace names must be string literals or otherwise outlive the trace, since
+	 * only the pointer is stored.
+	 */
+
+	class Trace
+	{
+	public:
+
+		//.____ Control _________________________________________________________
+
+		static void		setEnabled( bool bEnabled );
+		static inline bool	isEnabled() { return s_bEnabled.load(std::memory_order_relaxed); }
+
+		static void		setBufferSize( int events );
+		static int		bufferSize() { return s_bufferSize; }
+
+		static void		clear();
+
+		//.____ Misc ____________________________________________________________
+
+		static std::string	chromeTraceJSON();
+		static bool			exportChromeTrace( const char * pPath );
+
+		//.____ Recording _______________________________________________________
+
+		class Scope
+		{
+		public:
+			inline Scope( const char * pName ) : m_pName(nullptr)
+			{
+				if( Trace::isEnabled() )
+				{
+					m_pName = pName;
+					m_begin = Trace::_now();
+				}
+			}
+
+			inline ~Scope()
+			{
+				if( m_pName )
+					Trace::_record( m_pName, m_begin, Trace::_now() );
+			}
+
+		private:
+			const char *	m_pName;
+			int64_t			m_begin;
+		};
+
+	private:
+		static int64_t	_now();
+		static void		_record( const char * pName, int64_t begin, int64_t end );
+
+		static std::atomic<bool>	s_bEnabled;
+		static int					s_bufferSize;
+	};
+
+} // namespace wg
+
+#define	WG_TRACE_CONCAT_(a,b)	a##b
+#define	WG_TRACE_CONCAT(a,b)	WG_TRACE_CONCAT_(a,b)
+
+#ifdef WG_NO_TRACING
+#	define WG_TRACE_SCOPE(name)
+#else
+#	define WG_TRACE_SCOPE(name)	wg::Trace::Scope WG_TRACE_CONCAT(_traceScope,__LINE__)(name)
+#endif
+
+#endif //WG_TRACE_DOT_H
@@ -199,6 +199,7 @@ namespace wg
 
 
 	typedef unsigned int	RouteId;
+	typedef unsigned int	TaskId;
 
 	typedef uint16_t		TextStyle_h;
 
@@ -542,6 +543,7 @@ namespace wg
 		const int Static = 0;		// No content access/modification expected
 		const int Dynamic = 1;		// Expect content to be accessed and/or modified
 		const int WriteOnly = 2;	// Can only be locked in WriteOnly mode. Alpha can still be read pixel by pixel if present.
+		const int Mipmapped = 4;	// Generate mipmaps for better quality and speed when scaled down. Ignored where not supported.
 	};
 
 
@@ -557,7 +559,8 @@ namespace wg
 		BGRA_4,				///< 4 bits each of blue, green, red and alpha in exactly that order in memory.
 		BGR_565,			///< 5 bits of blue, 6 bits of green and 5 bits of red in exactly that order in memory.
 		I8,					///< 8 bits of index into the CLUT (Color Lookup Table).
-		A8					///< 8 bits of alpha only.
+		A8,					///< 8 bits of alpha only.
+		BGRA_8_pre			///< Same memory layout as BGRA_8, but with blue, green and red premultiplied by alpha.
 	};
 
 	//____ PixelDescription __________________________________________________________
@@ -698,7 +701,7 @@ namespace wg
 		TransformDrawSegments,
 		EdgeSamples,
 
-//		BlitNinePatch,
+		BlitNinePatch,
 
 
 		CreateSurface,
@@ -708,7 +711,10 @@ namespace wg
 		EndSurfaceUpdate,
 		FillSurface,
 		CopySurface,
-		DeleteSurface
+		DeleteSurface,
+
+		CreatePalette,
+		DeletePalette
 	};
 
 	//____ GfxFlip ____________________________________________________________
@@ -23,6 +23,7 @@
 #include <wg_util.h>
 #include <wg_geo.h>
 #include <wg_surface.h>
+#include <wg_gfxdevice.h>
 
 namespace wg
 {
@@ -185,6 +186,251 @@ double Util::powerOfTen(int num){
 		return (alpha >= opacityTreshold);
 	}
 
+	//____ ninePatchSections() ____________________________________________________
+
+	void Util::ninePatchSections( const Rect& rect, const Border& frame, Rect sections[9] )
+	{
+		int x[4] = { rect.x, rect.x + frame.left, rect.x + rect.w - frame.right, rect.x + rect.w };
+		int y[4] = { rect.y, rect.y + frame.top, rect.y + rect.h - frame.bottom, rect.y + rect.h };
+
+		for( int row = 0 ; row < 3 ; row++ )
+		{
+			for( int col = 0 ; col < 3 ; col++ )
+				sections[row*3+col] = Rect( x[col], y[row], x[col+1] - x[col], y[row+1] - y[row] );
+		}
+	}
+
+	//____ _expandChannel() _______________________________________________________
+	// Expands a channel of given bit depth to 8 bits the way blitters and GPUs do it,
+	// so that a 5-bit 31 becomes 255 and not 248.
+
+	static inline uint8_t _expandChannel( uint32_t pixel, uint32_t mask, int shift, int bits )
+	{
+		if( bits == 0 )
+			return 0;
+
+		int max = (1 << bits) - 1;
+		int value = (pixel & mask) >> shift;
+		return (uint8_t) ((value * 255 + max / 2) / max);
+	}
+
+	//____ analyzeNinePatch() _____________________________________________________
+	/*
+		Finds out which sections of a block are opaque, invisible or of a single color.
+		Empty sections are flagged as both opaque and invisible since they cover nothing as
+		long as source and destination frames are the same. Surfaces that can't be locked
+		for reading or bReadPixels is false for, such as surfaces modified after being analyzed,
+		only get their opacity from isOpaque().
+
+		Solid colors are only reported for non-premultiplied formats, where filling with
+		the color gives the exact same result as blitting.
+	*/
+
+	void Util::analyzeNinePatch( Surface * pSurface, const Rect& block, const Border& frame, NinePatchInfo& info, bool bReadPixels )
+	{
+		info = NinePatchInfo();
+
+		if( !pSurface )
+			return;
+
+		Rect sections[9];
+		ninePatchSections( block, frame, sections );
+
+		bool bOpaqueSurface = pSurface->isOpaque();
+
+		uint8_t * pPixels = nullptr;
+		if( bReadPixels && pSurface->regionLocked().isEmpty() )
+			pPixels = pSurface->lock( AccessMode::ReadOnly );
+
+		if( !pPixels )
+		{
+			for( int i = 0 ; i < 9 ; i++ )
+			{
+				if( sections[i].w <= 0 || sections[i].h <= 0 )
+				{
+					info.opaqueSections |= 1 << i;
+					info.invisibleSections |= 1 << i;
+				}
+				else if( bOpaqueSurface )
+					info.opaqueSections |= 1 << i;
+			}
+			return;
+		}
+
+		const PixelDescription * pFormat = pSurface->pixelDescription();
+		int pixelBytes = pFormat->bits / 8;
+		int pitch = pSurface->pitch();
+		const Color * pClut = pSurface->clut();
+		bool bAlphaOnly = (pFormat->format == PixelFormat::A8);
+		bool bCanFill = (pFormat->format != PixelFormat::BGRA_8_pre);
+
+		for( int i = 0 ; i < 9 ; i++ )
+		{
+			const Rect& r = sections[i];
+			uint16_t bit = 1 << i;
+
+			if( r.w <= 0 || r.h <= 0 )
+			{
+				info.opaqueSections |= bit;
+				info.invisibleSections |= bit;
+				continue;
+			}
+
+			Color	first;
+			bool	bSolid = true;
+			bool	bOpaque = true;
+			bool	bInvisible = true;
+
+			for( int y = r.y ; y < r.y + r.h && (bSolid || bOpaque || bInvisible) ; y++ )
+			{
+				const uint8_t * p = pPixels + y * pitch + r.x * pixelBytes;
+				for( int x = 0 ; x < r.w ; x++ )
+				{
+					uint32_t raw;
+					switch( pixelBytes )
+					{
+						case 1:
+							raw = p[0];
+							break;
+						case 2:
+							raw = * (const uint16_t *) p;
+							break;
+						case 3:
+							raw = p[0] | (p[1] << 8) | (p[2] << 16);
+							break;
+						default:
+							raw = * (const uint32_t *) p;
+							break;
+					}
+					p += pixelBytes;
+
+					Color col;
+					if( bAlphaOnly )
+						col = Color( 255, 255, 255, (uint8_t) raw );		// A8 is blitted as white.
+					else if( pFormat->bIndexed )
+						col = pClut[raw];
+					else
+					{
+						col.r = _expandChannel( raw, pFormat->R_mask, pFormat->R_shift, pFormat->R_bits );
+						col.g = _expandChannel( raw, pFormat->G_mask, pFormat->G_shift, pFormat->G_bits );
+						col.b = _expandChannel( raw, pFormat->B_mask, pFormat->B_shift, pFormat->B_bits );
+						col.a = pFormat->A_bits == 0 ? 255 : _expandChannel( raw, pFormat->A_mask, pFormat->A_shift, pFormat->A_bits );
+					}
+
+					if( x == 0 && y == r.y )
+						first = col;
+					else if( col != first )
+						bSolid = false;
+
+					if( col.a != 255 )
+						bOpaque = false;
+					if( col.a != 0 )
+						bInvisible = false;
+				}
+			}
+
+			if( bOpaque || bOpaqueSurface )
+				info.opaqueSections |= bit;
+			if( bInvisible )
+				info.invisibleSections |= bit;
+			if( bSolid && bCanFill )
+			{
+				info.solidSections |= bit;
+				info.solidColors[i] = first;
+			}
+		}
+
+		pSurface->unlock();
+	}
+
+	//____ renderNinePatch() ______________________________________________________
+	/*
+		Renders a nine-patch using the section info from analyzeNinePatch(). Solid sections
+		are filled and invisible ones skipped when the blend mode allows it, the rest is
+		left to the device.
+	*/
+
+	void Util::renderNinePatch( GfxDevice * pDevice, const Rect& dstRect, const Border& dstFrame, const Rect& srcRect, const Border& srcFrame, const NinePatchInfo& info )
+	{
+		BlendMode blendMode = pDevice->blendMode();
+
+		uint16_t skip = 0;
+		if( blendMode == BlendMode::Blend || blendMode == BlendMode::Add || blendMode == BlendMode::Subtract )
+			skip = info.invisibleSections;
+
+		uint16_t fills = info.solidSections & ~skip;
+
+		if( skip == 0 && fills == 0 )
+		{
+			pDevice->blitNinePatch( dstRect, dstFrame, srcRect, srcFrame );
+			return;
+		}
+
+		Rect src[9];
+		Rect dst[9];
+		ninePatchSections( srcRect, srcFrame, src );
+		ninePatchSections( dstRect, dstFrame, dst );
+
+		// Shortcut for blocks of one single color.
+
+		bool bSingleFill = true;
+		int	 firstFill = -1;
+		for( int i = 0 ; i < 9 && bSingleFill ; i++ )
+		{
+			if( dst[i].w <= 0 || dst[i].h <= 0 )
+				continue;
+
+			if( (fills & (1 << i)) == 0 || src[i].w <= 0 || src[i].h <= 0 )
+				bSingleFill = false;
+			else if( firstFill == -1 )
+				firstFill = i;
+			else if( info.solidColors[i] != info.solidColors[firstFill] )
+				bSingleFill = false;
+		}
+
+		if( bSingleFill && firstFill != -1 )
+		{
+			pDevice->fill( dstRect, info.solidColors[firstFill] );
+			return;
+		}
+
+		//
+
+		for( int i = 0 ; i < 9 ; i++ )
+		{
+			uint16_t bit = 1 << i;
+
+			if( dst[i].w <= 0 || dst[i].h <= 0 || src[i].w <= 0 || src[i].h <= 0 || (skip & bit) )
+				continue;
+
+			if( fills & bit )
+				pDevice->fill( dst[i], info.solidColors[i] );
+			else
+				pDevice->blitNinePatch( dst[i], Border(), src[i], Border() );
+		}
+	}
+
+	//____ isNinePatchOpaque() ____________________________________________________
+
+	bool Util::isNinePatchOpaque( uint16_t opaqueSections, const Rect& rect, const Size& canvasSize, const Border& frame )
+	{
+		if( (opaqueSections & 0x1FF) == 0x1FF )
+			return true;
+
+		if( !Rect(canvasSize).contains(rect) )
+			return false;
+
+		Rect sections[9];
+		ninePatchSections( Rect(canvasSize), frame, sections );
+
+		for( int i = 0 ; i < 9 ; i++ )
+		{
+			if( (opaqueSections & (1 << i)) == 0 && sections[i].w > 0 && sections[i].h > 0 && sections[i].intersectsWith(rect) )
+				return false;
+		}
+		return true;
+	}
+
 
 
 	//____ pixelFormatToDescription() _____________________________________________________
@@ -232,6 +478,7 @@ double Util::powerOfTen(int num){
 				return true;
 
 			case PixelFormat::BGRA_8:
+			case PixelFormat::BGRA_8_pre:
 				wFormat.format = format;
 				wFormat.bits = 32;
 				wFormat.bIndexed = false;
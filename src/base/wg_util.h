@@ -26,12 +26,14 @@
 
 #include <wg_geo.h>
 #include <wg_types.h>
+#include <wg_color.h>
 
 namespace wg
 {
 
 	class Rect;
 	class Surface;
+	class GfxDevice;
 
 	//____ Util _________________________________________________________________
 
@@ -42,6 +44,22 @@ namespace wg
 
 		bool		markTestStretchRect( Coord ofs, Surface * pSurface, const Rect& source, const Rect& area, int opacityTreshold );
 
+		// Content of the nine sections of a nine-patch block, as analysed by analyzeNinePatch().
+		// Sections are numbered left to right, top to bottom and each mask has one bit per section.
+
+		struct NinePatchInfo
+		{
+			uint16_t	opaqueSections = 0;		// All pixels fully opaque.
+			uint16_t	invisibleSections = 0;	// All pixels fully transparent.
+			uint16_t	solidSections = 0;		// All pixels of the same color, found in solidColors.
+			Color		solidColors[9];
+		};
+
+		void		ninePatchSections( const Rect& rect, const Border& frame, Rect sections[9] );
+		void		analyzeNinePatch( Surface * pSurface, const Rect& block, const Border& frame, NinePatchInfo& info, bool bReadPixels = true );
+		void		renderNinePatch( GfxDevice * pDevice, const Rect& dstRect, const Border& dstFrame, const Rect& srcRect, const Border& srcFrame, const NinePatchInfo& info );
+		bool		isNinePatchOpaque( uint16_t opaqueSections, const Rect& rect, const Size& canvasSize, const Border& frame );
+
 		bool		pixelFormatToDescription( PixelFormat format, PixelDescription& wFormat );
 
 		Coord 		origoToOfs( Origo origo, Size base );
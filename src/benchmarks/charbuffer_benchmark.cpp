@@ -0,0 +1,239 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Compares CharBuffer and ChunkedCharBuffer doing random edits in a large text.
+//
+// Usage: charbuffer_benchmark [megabytes] [edits]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <chrono>
+#include <vector>
+#include <deque>
+
+#include <wg_charbuffer.h>
+#include <wg_chunkedcharbuffer.h>
+
+using namespace wg;
+
+struct Edit
+{
+	int		ofs;
+	int		nDelete;
+	int		nInsert;
+};
+
+const static size_t	c_undoDepth = 4;
+
+static uint32_t	s_seed = 12345;
+
+static int rnd( int max )
+{
+	s_seed = s_seed * 1103515245 + 12345;
+	return (int) ((s_seed >> 8) % (uint32_t) max);
+}
+
+//____ makeEdits() ____________________________________________________________
+//
+// Mix of typing, deleting and pasting, like a user editing a document.
+
+static std::vector<Edit> makeEdits( int textLen, int nEdits )
+{
+	std::vector<Edit> edits;
+	int len = textLen;
+
+	for( int i = 0 ; i < nEdits ; i++ )
+	{
+		Edit e;
+		int type = rnd(10);
+
+		if( type < 6 )				// Typing
+		{
+			e.nDelete = 0;
+			e.nInsert = 1 + rnd(8);
+		}
+		else if( type < 9 )			// Deleting
+		{
+			e.nDelete = 1 + rnd(16);
+			e.nInsert = 0;
+		}
+		else						// Pasting over a selection
+		{
+			e.nDelete = rnd(2000);
+			e.nInsert = rnd(4000);
+		}
+
+		e.ofs = rnd(len+1);
+		if( e.nDelete > len - e.ofs )
+			e.nDelete = len - e.ofs;
+
+		len += e.nInsert - e.nDelete;
+		edits.push_back(e);
+	}
+	return edits;
+}
+
+//____ run() __________________________________________________________________
+
+template<class Buffer>
+static double run( Buffer& buffer, const std::vector<Edit>& edits, const Char * pInsert, bool bSnapshots )
+{
+	std::deque<Buffer> undo;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for( auto& e : edits )
+	{
+		if( bSnapshots )
+		{
+			undo.push_back( buffer );
+			if( undo.size() > c_undoDepth )
+				undo.pop_front();
+		}
+
+		buffer.replace( e.ofs, e.nDelete, pInsert, e.nInsert );
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double,std::milli>(end-start).count();
+}
+
+//____ isEqual() ______________________________________________________________
+
+static bool isEqual( const CharBuffer& flat, const ChunkedCharBuffer& chunked )
+{
+	return flat.length() == chunked.length() && memcmp( flat.chars(), chunked.chars(), flat.length()*sizeof(Char) ) == 0;
+}
+
+//____ main() _________________________________________________________________
+
+int main( int argc, char** argv )
+{
+	int megabytes = argc > 1 ? atoi(argv[1]) : 10;
+	int nEdits = argc > 2 ? atoi(argv[2]) : 2000;
+
+	int textLen = megabytes * 1024 * 1024;
+
+	// Fill a text with some lines of random length.
+
+	std::vector<Char> text( textLen + 1 );
+	for( int i = 0 ; i < textLen ; i++ )
+		text[i].setCode( rnd(60) == 0 ? '\n' : 'a' + rnd(26) );
+	text[textLen].setCode(0);
+
+	std::vector<Char> insert( 4001 );
+	for( int i = 0 ; i < 4000 ; i++ )
+		insert[i].setCode( 'A' + rnd(26) );
+
+	std::vector<Edit> edits = makeEdits( textLen, nEdits );
+
+	printf( "Text of %d characters, %d random edits.\n\n", textLen, nEdits );
+
+	for( int snapshots = 0 ; snapshots < 2 ; snapshots++ )
+	{
+		CharBuffer			flat;
+		ChunkedCharBuffer	chunked;
+
+		flat.pushBack( text.data(), textLen );
+		chunked.pushBack( text.data(), textLen );
+
+		// Undo snapshots of a flat buffer makes every edit copy the whole text, so only do a few.
+
+		int nFlatEdits = snapshots ? std::min( nEdits, 100 ) : nEdits;
+		std::vector<Edit> flatEdits( edits.begin(), edits.begin() + nFlatEdits );
+
+		double flatTime = run( flat, flatEdits, insert.data(), snapshots == 1 );
+		double chunkedTime = run( chunked, edits, insert.data(), snapshots == 1 );
+
+		printf( "%s\n", snapshots ? "With undo snapshot before each edit:" : "Without snapshots:" );
+		printf( "  CharBuffer:        %10.2f ms, %8.3f us/edit (%d edits)\n", flatTime, flatTime * 1000 / nFlatEdits, nFlatEdits );
+		printf( "  ChunkedCharBuffer: %10.2f ms, %8.3f us/edit (%d chunks)\n", chunkedTime, chunkedTime * 1000 / nEdits, chunked.nbChunks() );
+
+		// Check that both ended up with the same text.
+
+		if( !snapshots )
+		{
+			bool bEqual = isEqual( flat, chunked );
+			printf( "  Results %s\n", bEqual ? "match." : "DIFFER!" );
+			if( !bEqual )
+				return 1;
+
+			// Modify ranges running to the end, where ofs + len overflows if not clipped first.
+
+			Char fillChar;
+			fillChar.setCode( '-' );
+
+			flat.setCharCodes( 'x', 3, INT_MAX );
+			chunked.setCharCodes( 'x', 3, INT_MAX );
+			flat.fill( fillChar, flat.length() / 2, INT_MAX );
+			chunked.fill( fillChar, chunked.length() / 2, INT_MAX );
+			flat.clearStyle( 5, INT_MAX );
+			chunked.clearStyle( 5, INT_MAX );
+
+			bEqual = isEqual( flat, chunked ) && chunked.chars()[3].code() == 'x' && chunked.chars()[chunked.length()-1].code() == '-';
+			printf( "  Range modifications %s\n", bEqual ? "match." : "DIFFER!" );
+			if( !bEqual )
+				return 1;
+		}
+		printf( "\n" );
+	}
+
+	// Appending lines one by one, like a growing log. Splitting full chunks must keep the
+	// tree balanced here too, otherwise each append gets slower than the last.
+
+	{
+		const int lineLen = 60;
+		int nLines = textLen / lineLen;
+
+		std::vector<Char> line( lineLen );
+		for( int i = 0 ; i < lineLen ; i++ )
+			line[i].setCode( i == lineLen-1 ? '\n' : 'a' + rnd(26) );
+
+		ChunkedCharBuffer	chunked;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for( int i = 0 ; i < nLines ; i++ )
+			chunked.pushBack( line.data(), lineLen );
+		double chunkedTime = std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now()-start).count();
+
+		printf( "Appending %d lines of %d characters:\n", nLines, lineLen );
+		printf( "  ChunkedCharBuffer: %10.2f ms, %8.3f us/append (%d chunks)\n", chunkedTime, chunkedTime * 1000 / nLines, chunked.nbChunks() );
+
+		// CharBuffer reallocates on every append, so we build the reference in one go.
+
+		std::vector<Char> all( nLines * lineLen );
+		for( int i = 0 ; i < nLines ; i++ )
+			memcpy( &all[i*lineLen], line.data(), lineLen*sizeof(Char) );
+
+		CharBuffer flat;
+		flat.pushBack( all.data(), (int) all.size() );
+
+		bool bEqual = isEqual( flat, chunked );
+		printf( "  Results %s\n", bEqual ? "match." : "DIFFER!" );
+		if( !bEqual )
+			return 1;
+	}
+
+	return 0;
+}
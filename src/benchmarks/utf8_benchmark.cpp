@@ -0,0 +1,195 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Measures throughput of the UTF-8 decoding and counting in TextTool compared
+// to decoding character by character, on texts with different amounts of non-ASCII.
+//
+// Usage: utf8_benchmark [megabytes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include <wg_texttool.h>
+#include <wg_char.h>
+
+using namespace wg;
+
+static uint32_t	s_seed = 12345;
+
+static int rnd( int max )
+{
+	s_seed = s_seed * 1103515245 + 12345;
+	return (int) ((s_seed >> 8) % (uint32_t) max);
+}
+
+//____ makeText() _____________________________________________________________
+//
+// Creates a text of lines with words, where about one character in nonAsciiRatio is a
+// two or three byte character.
+
+static std::string makeText( int bytes, int nonAsciiRatio )
+{
+	std::string text;
+	text.reserve( bytes + 8 );
+
+	while( (int) text.size() < bytes )
+	{
+		int r = rnd(1000);
+		if( r < 15 )
+			text += '\n';
+		else if( r < 170 )
+			text += ' ';
+		else if( nonAsciiRatio && rnd(nonAsciiRatio) == 0 )
+			text += rnd(2) ? "\xC3\xA5" : "\xE2\x82\xAC";			// å or €
+		else
+			text += (char) ('a' + rnd(26));
+	}
+	return text;
+}
+
+//____ Character by character references ______________________________________
+
+static int refCountChars( const char * pStr )
+{
+	int n = 0;
+	while( TextTool::readChar(pStr) != 0 )
+		n++;
+	return n;
+}
+
+static uint32_t refCountLines( const char * pStr )
+{
+	uint32_t n = 1;
+	while( * pStr != 0 )
+	{
+		if( * pStr++ == '\n' )
+			n++;
+	}
+	return n;
+}
+
+static uint32_t refReadString( const char * pSrc, uint16_t * pDst )
+{
+	uint32_t n = 0;
+	while( * pSrc != 0 )
+		pDst[n++] = TextTool::readChar(pSrc);
+	pDst[n] = 0;
+	return n;
+}
+
+//____ measure() ______________________________________________________________
+
+template<class F>
+static double measure( int rounds, const F& func )
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	for( int i = 0 ; i < rounds ; i++ )
+		func();
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(end-start).count() / rounds;
+}
+
+static void report( const char * pName, int bytes, double refTime, double time )
+{
+	printf( "  %-16s %8.0f MB/s -> %8.0f MB/s  (%.1fx)\n", pName, bytes / refTime / 1000000, bytes / time / 1000000, refTime / time );
+}
+
+//____ main() _________________________________________________________________
+
+int main( int argc, char** argv )
+{
+	int megabytes = argc > 1 ? atoi(argv[1]) : 16;
+	int bytes = megabytes * 1024 * 1024;
+	const int rounds = 5;
+
+	std::vector<uint16_t>	unicode( bytes + 1 );
+	std::vector<uint16_t>	refUnicode( bytes + 1 );
+	std::vector<Char>		chars( bytes + 1 );
+
+	int nonAsciiRatios[] = { 0, 100, 5 };
+
+	for( int ratio : nonAsciiRatios )
+	{
+		std::string text = makeText( bytes, ratio );
+		const char * pText = text.c_str();
+
+		if( ratio == 0 )
+			printf( "Plain ASCII, %d bytes:\n", (int) text.size() );
+		else
+			printf( "About 1 in %d characters multibyte, %d bytes:\n", ratio, (int) text.size() );
+
+		// Check that we get the same results as decoding character by character.
+
+		int nChars = refCountChars( pText );
+		uint32_t nLines = refCountLines( pText );
+
+		uint32_t nChars2, nLines2;
+		TextTool::countCharsLines( pText, nChars2, nLines2 );
+
+		const char * p = pText;
+		uint32_t nRead = TextTool::readString( p, unicode.data() );
+		refReadString( pText, refUnicode.data() );
+
+		p = pText;
+		TextTool::readString( p, chars.data() );
+		bool bCharsEqual = true;
+		for( int i = 0 ; i <= nChars ; i++ )
+			if( chars[i].code() != refUnicode[i] )
+				bCharsEqual = false;
+
+		if( TextTool::countChars( pText ) != nChars || TextTool::countLines( pText ) != nLines ||
+			nChars2 != (uint32_t) nChars || nLines2 != nLines || nRead != (uint32_t) nChars || !bCharsEqual ||
+			memcmp( unicode.data(), refUnicode.data(), (nChars+1)*sizeof(uint16_t) ) != 0 )
+		{
+			printf( "  Results DIFFER!\n" );
+			return 1;
+		}
+
+		// Measure
+
+		volatile uint32_t sink = 0;
+
+		double ref = measure( rounds, [&]() { sink += refCountChars( pText ); } );
+		double opt = measure( rounds, [&]() { sink += TextTool::countChars( pText ); } );
+		report( "countChars()", bytes, ref, opt );
+
+		ref = measure( rounds, [&]() { sink += refCountLines( pText ); } );
+		opt = measure( rounds, [&]() { sink += TextTool::countLines( pText ); } );
+		report( "countLines()", bytes, ref, opt );
+
+		ref = measure( rounds, [&]() { sink += refCountChars( pText ) + refCountLines( pText ); } );
+		opt = measure( rounds, [&]() { uint32_t c, l; TextTool::countCharsLines( pText, c, l ); sink += c + l; } );
+		report( "countCharsLines()", bytes, ref, opt );
+
+		ref = measure( rounds, [&]() { sink += refReadString( pText, refUnicode.data() ); } );
+		opt = measure( rounds, [&]() { const char * p = pText; sink += TextTool::readString( p, unicode.data() ); } );
+		report( "readString()", bytes, ref, opt );
+
+		printf( "\n" );
+	}
+
+	return 0;
+}
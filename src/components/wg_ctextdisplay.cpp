@@ -29,7 +29,7 @@ namespace wg
 
 	//____ Constructor _____________________________________________________________
 
-	CTextDisplay::CTextDisplay( ComponentHolder * pHolder ) : CText( pHolder )
+	CTextDisplay::CTextDisplay( ComponentHolder * pHolder ) : CText( pHolder ), m_maxLines(0), m_nbLines(1)
 	{
 	}
 
@@ -40,6 +40,7 @@ namespace wg
 		int removed = m_charBuffer.length();
 		m_charBuffer.clear();
 		_textMapper()->onTextModified(this, 0, removed, 0 );
+		m_nbLines = 1;
 	}
 
 	//___ set() ____________________________________________________________________
@@ -51,6 +52,7 @@ namespace wg
 		int removed = m_charBuffer.length();
 		m_charBuffer = seq;
 		_textMapper()->onTextModified(this, 0, removed, m_charBuffer.length() );
+		_trimLines();
 	}
 
 	void CTextDisplay::set( const CharBuffer * buffer )
@@ -60,6 +62,7 @@ namespace wg
 		int removed = m_charBuffer.length();
 		m_charBuffer = * buffer;
 		_textMapper()->onTextModified(this, 0, removed, m_charBuffer.length() );
+		_trimLines();
 	}
 
 	void CTextDisplay::set( const String& str )
@@ -69,6 +72,7 @@ namespace wg
 		int removed = m_charBuffer.length();
 		m_charBuffer = str;
 		_textMapper()->onTextModified(this, 0, removed, m_charBuffer.length() );
+		_trimLines();
 	}
 
 	//____ append() ________________________________________________________________
@@ -80,6 +84,17 @@ namespace wg
 		int ofs = m_charBuffer.length();
 		int len = m_charBuffer.pushBack(seq);
 		_textMapper()->onTextModified(this, ofs, 0, len );
+
+		if( m_maxLines > 0 )
+		{
+			const Char * pChars = m_charBuffer.chars();
+			for( int i = ofs ; i < ofs + len ; i++ )
+			{
+				if( pChars[i].code() == '\n' )
+					m_nbLines++;
+			}
+			_trimLines(false);
+		}
 		return len;
 	}
 
@@ -91,6 +106,7 @@ namespace wg
 
 		int len = m_charBuffer.insert(ofs,seq);
 		_textMapper()->onTextModified(this, ofs, 0, seq.length() );
+		_trimLines();
 		return len;
 	}
 
@@ -102,6 +118,7 @@ namespace wg
 
 		int diff = m_charBuffer.replace(ofs,nDelete,seq);
 		_textMapper()->onTextModified(this, ofs, nDelete, seq.length() );
+		_trimLines();
 		return diff;
 	}
 
@@ -113,9 +130,69 @@ namespace wg
 
 		int removed = m_charBuffer.remove(ofs,len);
 		_textMapper()->onTextModified(this, ofs, len, 0 );
+		if( m_maxLines > 0 )
+			_countLines();
 		return removed;
 	}
 
+	//____ setMaxLines() _______________________________________________________
+	//
+	// Limits the number of lines kept, dropping the oldest lines from the front when
+	// more are added. Meant for logs and similar where text mostly is appended, which
+	// then only needs the new lines to be laid out. 0 removes the limit.
+
+	void CTextDisplay::setMaxLines( int maxLines )
+	{
+		if( maxLines < 0 )
+			maxLines = 0;
+
+		if( maxLines == m_maxLines )
+			return;
+
+		m_maxLines = maxLines;
+		_trimLines();
+	}
+
+	//____ _countLines() _______________________________________________________
+
+	void CTextDisplay::_countLines()
+	{
+		const Char * pChars = m_charBuffer.chars();
+		int len = m_charBuffer.length();
+
+		m_nbLines = 1;
+		for( int i = 0 ; i < len ; i++ )
+		{
+			if( pChars[i].code() == '\n' )
+				m_nbLines++;
+		}
+	}
+
+	//____ _trimLines() ________________________________________________________
+	//
+	// Removes lines from the front if we have more than m_maxLines. Lines are recounted
+	// unless bRecount is false, in which case m_nbLines needs to be up to date.
+
+	void CTextDisplay::_trimLines( bool bRecount )
+	{
+		if( m_maxLines == 0 )
+			return;
+
+		if( bRecount )
+			_countLines();
+
+		if( m_nbLines <= m_maxLines )
+			return;
+
+		int ofs = 0;
+		for( int i = m_nbLines - m_maxLines ; i > 0 ; i-- )
+			ofs = m_charBuffer.findFirst( '\n', ofs ) + 1;
+
+		m_charBuffer.remove( 0, ofs );
+		_textMapper()->onTextModified(this, 0, ofs, 0 );
+		m_nbLines = m_maxLines;
+	}
+
 	//____ markedLink() _____________________________________________________
 
 	TextLink_p CTextDisplay::markedLink() const
@@ -36,6 +36,7 @@ namespace wg
 	class String;
 	class CharSeq;
 	class CharBuffer;
+	class Msg;
 
 	//____ CTextDisplay __________________________________________________________________
 
@@ -55,6 +56,8 @@ namespace wg
 		virtual int			replace( int ofs, int nDelete, const CharSeq& seq );
 		virtual int			remove( int ofs, int len );
 
+		void				setMaxLines( int maxLines );
+		inline int			maxLines() const { return m_maxLines; }
 
 		inline int			length() const { return m_charBuffer.length(); }
 		inline bool			isEmpty() const { return length()==0?true:false; }
@@ -70,7 +73,13 @@ namespace wg
 		virtual void		receive( Msg * pMsg );
 
 	protected:
+		void				_countLines();
+		void				_trimLines( bool bRecount = true );
+
 		TextLink_p			m_pMarkedLink;	// Character offset for beginning of marked or focused link
+
+		int					m_maxLines;		// Max number of lines to keep, older lines dropped from the front. 0 = no limit.
+		int					m_nbLines;		// Number of lines in text, only kept up to date when m_maxLines is set.
 	};
 
 
@@ -184,23 +184,11 @@ int main ( int argc, char** argv )
 
 void translateEvents( RootPanel_p pRoot )
 {
-	// WonderGUI needs Tick-messages to keep track of time passed for things such
-	// key-repeat, double-click detection, animations etc.  So we create one
-	// and post it.
+	// WonderGUI needs to know the time to handle things such as key-repeat,
+	// double-click detection, animations etc. So we tick the scheduler, which
+	// updates everything that is due.
 
-	static unsigned int oldTicks = 0;
-
-	unsigned int ticks = SDL_GetTicks();
-	int tickDiff;
-
-	if( oldTicks == 0 )
-		tickDiff = 0;
-	else
-		tickDiff = (int) (ticks - oldTicks);
-	oldTicks = ticks;
-
-
-	Base::msgRouter()->post( TickMsg::create(ticks, tickDiff) );
+	Base::scheduler()->tick( SDL_GetTicks() );
 
 	// Process all the SDL events in a loop
 
@@ -30,6 +30,7 @@
 #include <wg_freetypefont.h>
 #include <wg_surface.h>
 #include <wg_surfacefactory.h>
+#include <wg_trace.h>
 #include <assert.h>
 
 
@@ -463,6 +464,8 @@ namespace wg
 
 	FreeTypeFont::CacheSlot * FreeTypeFont::_generateBitmap( MyGlyph * pGlyph )
 	{
+		WG_TRACE_SCOPE("FreeTypeFont::_generateBitmap");
+
 		FT_Error err;
 
 		// Load MyGlyph
@@ -365,6 +365,9 @@ namespace wg
 		if (canvasSize.w < 1 || canvasSize.h < 1)
 			return false;
 
+		if (m_bRendering)
+			_markCanvasDirty();
+
 		m_pCanvas = nullptr;
 		m_canvasSize = canvasSize;
 		m_clipCanvas = m_canvasSize;
@@ -400,6 +403,9 @@ namespace wg
 		if (!pSurface || pSurface->className() != GlSurface::CLASSNAME)
 			return false;
 
+		if (m_bRendering)
+			_markCanvasDirty();
+
 		m_pCanvas = pSurface;
 		m_canvasSize = pSurface->size();
 		m_clipCanvas = m_canvasSize;
@@ -475,6 +481,12 @@ namespace wg
 		if (!pSource || pSource->className() != GlSurface::CLASSNAME)
 			return false;
 
+		// Skins set their blit source every time they render, no need to end the
+		// current command unless it actually changes.
+
+		if (pSource == m_pBlitSource)
+			return true;
+
 		m_pBlitSource = pSource;
 
 		if (m_bRendering)
@@ -531,6 +543,7 @@ namespace wg
 		//
 
 		m_bRendering = true;
+		_clearRenderBounds();
 		m_cmd = Command::None;
 		m_pCmdFinalizer = &GlGfxDevice::_dummyFinalizer;
 		m_vertexOfs = 0;
@@ -603,6 +616,8 @@ namespace wg
 		assert(glGetError() == 0);
 		m_bRendering = false;
 
+		_markCanvasDirty();
+
 		// Restore previously active device and exit
 
 		s_pActiveDevice = m_pPrevActiveDevice;
@@ -629,6 +644,8 @@ namespace wg
 
 	void GlGfxDevice::fill(const Rect& rect, const Color& col)
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		// Skip calls that won't affect destination
@@ -703,6 +720,8 @@ namespace wg
 
 	void GlGfxDevice::fill(const RectF& rect, const Color& col)
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		// Skip calls that won't affect destination
@@ -799,6 +818,8 @@ namespace wg
 
 	void GlGfxDevice::plotPixels(int nPixels, const Coord * pCoords, const Color * pColors)
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		if (nPixels == 0)
@@ -844,6 +865,8 @@ namespace wg
 
 	void GlGfxDevice::drawLine(Coord begin, Coord end, Color color, float thickness)
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		if (m_vertexOfs > c_vertexBufferSize - 6 * m_nClipRects || m_extrasOfs > c_extrasBufferSize - 4 || m_clipCurrOfs == -1 )
@@ -982,6 +1005,8 @@ namespace wg
 
 	void GlGfxDevice::drawLine(Coord begin, Direction dir, int length, Color col, float thickness)
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		// Skip calls that won't affect destination
@@ -1118,6 +1143,8 @@ namespace wg
 
 	void GlGfxDevice::transformBlit(const Rect& dest, Coord src, const int simpleTransform[2][2])
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		if (m_pBlitSource == nullptr)
@@ -1220,6 +1247,8 @@ namespace wg
 
 	void GlGfxDevice::transformBlit(const Rect& dest, CoordF src, const float complexTransform[2][2])
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		if (m_pBlitSource == nullptr)
@@ -1311,6 +1340,8 @@ namespace wg
 
 	void GlGfxDevice::transformDrawSegments( const Rect& _dest, int nSegments, const Color * pSegmentColors, int nEdgeStrips, const int * pEdgeStrips, int edgeStripPitch, const int simpleTransform[2][2] )
 	{
+		_markClipRendered();
+
 		assert(glGetError() == 0);
 
 		if (!_dest.intersectsWith(m_clipBounds))
@@ -115,15 +115,9 @@ namespace wg
 		_setPixelDetails(format);
 		m_size	= size;
 		m_pitch = ((size.w*m_pixelDescription.bits/8)+3)&0xFFFFFFFC;
-		m_pBlob = Blob::create(m_pitch*m_size.h + (pClut ? 4096 : 0));
+		m_pBlob = Blob::create(m_pitch*m_size.h);
 
-		if (pClut)
-		{
-			m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * size.h);
-			memcpy(m_pClut, pClut, 4096);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut(pClut);
 
 		_setupGlTexture(nullptr);
 
@@ -139,7 +133,7 @@ namespace wg
 		m_size	= size;
 		m_pitch = pitch;
 		m_pBlob = pBlob;
-		m_pClut = const_cast<Color*>(pClut);
+		_setClut(pClut);
 
 		_setupGlTexture(m_pBlob->data());
 	}
@@ -149,19 +143,13 @@ namespace wg
 	   _setPixelDetails(format);
 		m_size	= size;
 		m_pitch = ((size.w*m_pixelDescription.bits/8)+3)&0xFFFFFFFC;
-		m_pBlob = Blob::create(m_pitch*m_size.h + (pClut ? 1024 : 0));
+		m_pBlob = Blob::create(m_pitch*m_size.h);
 
 		m_pPixels = (uint8_t *) m_pBlob->data();
 		_copyFrom( pPixelDescription==0 ? &m_pixelDescription:pPixelDescription, pPixels, pitch, size, size );
 		m_pPixels = 0;
 
-		if (pClut)
-		{
-			m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * size.h);
-			memcpy(m_pClut, pClut, 1024);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut(pClut);
 
 		_setupGlTexture(m_pBlob->data());
 	}
@@ -172,19 +160,13 @@ namespace wg
 		_setPixelDetails(pOther->pixelFormat());
 		m_size	= pOther->size();
 		m_pitch = m_size.w * m_pixelSize;
-		m_pBlob = Blob::create(m_pitch*m_size.h + (pOther->clut() ? 1024 : 0) );
+		m_pBlob = Blob::create(m_pitch*m_size.h);
 
 		m_pPixels = (uint8_t *) m_pBlob->data();
 		_copyFrom( pOther->pixelDescription(), (uint8_t*)pOther->pixels(), pOther->pitch(), m_size, m_size );
 		m_pPixels = 0;
 
-		if (pOther->clut())
-		{
-			m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * m_size.h);
-			memcpy(m_pClut, pOther->clut(), 1024);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut(pOther->clut());
 
 		_setupGlTexture(m_pBlob->data());
 	}
@@ -446,12 +428,26 @@ namespace wg
 		if(m_accessMode == AccessMode::None )
 			return;
 
+		_commitLockDirtyRects();
+
 		if( m_accessMode != AccessMode::ReadOnly )
 		{
+			// Only upload the parts of the texture that have been modified.
+
+			int rowLength = (m_pitch % m_pixelSize) == 0 ? m_pitch / m_pixelSize : m_size.w;		// Else pitch is just padding to GL_UNPACK_ALIGNMENT.
+
 			glBindTexture( GL_TEXTURE_2D, m_texture );
-			glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, m_size.w, m_size.h, m_accessFormat, m_pixelDataType, m_pBlob->data() );
-	//		glTexSubImage2D( GL_TEXTURE_2D, 0, m_lockRegion.x, m_lockRegion.y, m_lockRegion.w, m_lockRegion.h, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, rowLength );
+
+			for( const Rect * pRect = m_lockDirtyRects.begin() ; pRect != m_lockDirtyRects.end() ; pRect++ )
+			{
+				const uint8_t * pPixels = ((const uint8_t*) m_pBlob->data()) + pRect->y * m_pitch + pRect->x * m_pixelSize;
+				glTexSubImage2D( GL_TEXTURE_2D, 0, pRect->x, pRect->y, pRect->w, pRect->h, m_accessFormat, m_pixelDataType, pPixels );
+			}
+
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
 		}
+		m_lockDirtyRects.clear();
 		m_accessMode = AccessMode::None;
 		m_pPixels = 0;
 		m_lockRegion.w = 0;
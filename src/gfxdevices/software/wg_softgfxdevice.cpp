@@ -39,6 +39,7 @@ namespace wg
 	const char SoftGfxDevice::CLASSNAME[] = {"SoftGfxDevice"};
 
 	int SoftGfxDevice::s_mulTab[256];
+	int SoftGfxDevice::s_unpremulTab[256];
 
 	SoftGfxDevice::PlotOp_p		SoftGfxDevice::s_plotOpTab[BlendMode_size][PixelFormat_size];
 	SoftGfxDevice::FillOp_p		SoftGfxDevice::s_fillOpTab[BlendMode_size][TintMode_size][PixelFormat_size];
@@ -61,6 +62,18 @@ namespace wg
 	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_transformBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];
 	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_transformBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];
 
+	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_stretchTo_BGRA_8_OpTab[PixelFormat_size][2][2];
+	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_stretchTo_BGR_8_OpTab[PixelFormat_size][2][2];
+
+	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_stretchBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];
+	SoftGfxDevice::ComplexBlitOp_p		SoftGfxDevice::s_stretchBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];
+
+	// Simple transforms with a zero source step, repeating a single column or row of the source.
+
+	static const int s_repeatColumnTransform[2][2] = { { 0,0 }, { 0,1 } };
+	static const int s_repeatRowTransform[2][2] = { { 1,0 }, { 0,0 } };
+	static const int s_normalTransform[2][2] = { { 1,0 }, { 0,1 } };
+
 
 
 	const uint8_t s_channel_4_1[256] = {	0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
@@ -136,7 +149,7 @@ namespace wg
 
 	inline void SoftGfxDevice::_read_pixel(const uint8_t * pPixel, PixelFormat format, const Color * pClut, uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
 	{
-		if (format == PixelFormat::BGRA_8)
+		if (format == PixelFormat::BGRA_8 || format == PixelFormat::BGRA_8_pre)
 		{
 			outB = pPixel[0];
 			outG = pPixel[1];
@@ -299,6 +312,53 @@ namespace wg
 	}
 
 
+	//____ _blend_premultiplied_pixels() ______________________________________
+
+	inline void	SoftGfxDevice::_blend_premultiplied_pixels(	BlendMode mode, uint8_t srcB, uint8_t srcG, uint8_t srcR, uint8_t srcA,
+															uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
+															uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
+	{
+		// Source colors are premultiplied by source alpha, which saves us the multiplications
+		// of the source for Blend, Add and Subtract. Remaining modes work on unpremultiplied colors.
+
+		if (mode == BlendMode::Blend)
+		{
+			int invAlpha = s_mulTab[255 - srcA];
+
+			outB = srcB + ((backB * invAlpha) >> 16);
+			outG = srcG + ((backG * invAlpha) >> 16);
+			outR = srcR + ((backR * invAlpha) >> 16);
+			outA = srcA + ((backA * invAlpha) >> 16);
+		}
+
+		if (mode == BlendMode::Add)
+		{
+			outB = limitUint8(backB + srcB);
+			outG = limitUint8(backG + srcG);
+			outR = limitUint8(backR + srcR);
+			outA = backA;
+		}
+
+		if (mode == BlendMode::Subtract)
+		{
+			outB = limitUint8(backB - srcB);
+			outG = limitUint8(backG - srcG);
+			outR = limitUint8(backR - srcR);
+			outA = backA;
+		}
+
+		if (mode == BlendMode::Replace || mode == BlendMode::Multiply || mode == BlendMode::Invert)
+		{
+			int unpremul = s_unpremulTab[srcA];
+
+			srcB = (std::min(srcB, srcA) * unpremul) >> 16;
+			srcG = (std::min(srcG, srcA) * unpremul) >> 16;
+			srcR = (std::min(srcR, srcA) * unpremul) >> 16;
+
+			_blend_pixels(mode, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+		}
+	}
+
 	//____ _init_tint_color() _________________________________________________
 
 	inline void	SoftGfxDevice::_init_tint_color(TintMode tintMode, const ColTrans& tint, uint8_t inB, uint8_t inG, uint8_t inR, uint8_t inA, uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA)
@@ -1092,6 +1152,15 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+			{
+				// Premultiplied color channels need to be scaled by tint alpha as well.
+
+				tintB = s_mulTab[(tint.baseTint.b * tintA) >> 16];
+				tintG = s_mulTab[(tint.baseTint.g * tintA) >> 16];
+				tintR = s_mulTab[(tint.baseTint.r * tintA) >> 16];
+			}
 		}
 
 		for (int y = 0; y < nLines; y++)
@@ -1122,7 +1191,10 @@ namespace wg
 				// Step 3: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
 
 				// Step 4: Write resulting pixel to destination
 
@@ -1153,6 +1225,9 @@ namespace wg
 		int lineIncX = (int)(matrix[1][0] * 32768);
 		int lineIncY = (int)(matrix[1][1] * 32768);
 
+		int srcMaxX = pSrcSurf->m_size.w - 1;
+		int srcMaxY = pSrcSurf->m_size.h - 1;
+
 
 		int tintB, tintG, tintR, tintA;
 
@@ -1162,6 +1237,15 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+			{
+				// Premultiplied color channels need to be scaled by tint alpha as well.
+
+				tintB = s_mulTab[(tint.baseTint.b * tintA) >> 16];
+				tintG = s_mulTab[(tint.baseTint.g * tintA) >> 16];
+				tintR = s_mulTab[(tint.baseTint.r * tintA) >> 16];
+			}
 		}
 
 		for (int y = 0; y < nLines; y++)
@@ -1178,18 +1262,26 @@ namespace wg
 
 				if (SCALEMODE == ScaleMode::Interpolate)
 				{
-					// Read separate source color components for our 2x2 pixel square.
+					// Read separate source color components for our 2x2 pixel square,
+					// clamped to the source so we never read outside its pixels at the edges.
 
+					int x1 = std::min(std::max(ofsX >> 15, 0), srcMaxX);
+					int x2 = std::min(std::max((ofsX >> 15) + 1, 0), srcMaxX);
+					int y1 = std::min(std::max(ofsY >> 15, 0), srcMaxY);
+					int y2 = std::min(std::max((ofsY >> 15) + 1, 0), srcMaxY);
+
+					uint8_t * pLine1 = pSrcSurf->m_pData + y1 * srcPitch;
+					uint8_t * pLine2 = pSrcSurf->m_pData + y2 * srcPitch;
 
 					uint8_t src11_b, src11_g, src11_r, src11_a;
 					uint8_t src12_b, src12_g, src12_r, src12_a;
 					uint8_t src21_b, src21_g, src21_r, src21_a;
 					uint8_t src22_b, src22_g, src22_r, src22_a;
 
-					_read_pixel(p, SRCFORMAT, pSrcSurf->m_pClut, src11_b, src11_g, src11_r, src11_a);
-					_read_pixel(p + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
-					_read_pixel(p + srcPitch, SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
-					_read_pixel(p + srcPitch + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
+					_read_pixel(pLine1 + x1 * srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src11_b, src11_g, src11_r, src11_a);
+					_read_pixel(pLine1 + x2 * srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
+					_read_pixel(pLine2 + x1 * srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
+					_read_pixel(pLine2 + x2 * srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
 
 					// Interpolate our 2x2 source colors into one source color, srcX
 
@@ -1235,7 +1327,10 @@ namespace wg
 				// Step 4: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
 
 				// Step 5: Write resulting pixel to destination
 
@@ -1252,6 +1347,9 @@ namespace wg
 	}
 
 	//____ _stretch_blit __________________________________________
+	// Axis-aligned version of _complex_blit, for matrices with zero in [0][1] and [1][0].
+	// Source offsets and interpolation fractions of the columns are the same for every
+	// line, so they are calculated once per call instead of stepped per pixel.
 
 	template<PixelFormat SRCFORMAT, ScaleMode SCALEMODE, int TINTFLAGS, BlendMode BLEND, PixelFormat DSTFORMAT>
 	void SoftGfxDevice::_stretch_blit(const SoftSurface * pSrcSurf, CoordF pos, const float matrix[2][2], uint8_t * pDst, int dstPitchX, int dstPitchY, int nLines, int lineLength, const SoftGfxDevice::ColTrans& tint)
@@ -1262,6 +1360,9 @@ namespace wg
 		int pixelIncX = (int)(matrix[0][0] * 32768);
 		int lineIncY = (int)(matrix[1][1] * 32768);
 
+		int srcMaxX = pSrcSurf->m_size.w - 1;
+		int srcMaxY = pSrcSurf->m_size.h - 1;
+
 		int tintB, tintG, tintR, tintA;
 
 		if (TINTFLAGS & 0x1)
@@ -1270,22 +1371,75 @@ namespace wg
 			tintG = s_mulTab[tint.baseTint.g];
 			tintR = s_mulTab[tint.baseTint.r];
 			tintA = s_mulTab[tint.baseTint.a];
+
+			if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+			{
+				// Premultiplied color channels need to be scaled by tint alpha as well.
+
+				tintB = s_mulTab[(tint.baseTint.b * tintA) >> 16];
+				tintG = s_mulTab[(tint.baseTint.g * tintA) >> 16];
+				tintR = s_mulTab[(tint.baseTint.r * tintA) >> 16];
+			}
 		}
 
-		int ofsY = (int)(pos.y * 32768);		// We use 15 binals for all calculations
+		// Precalculate byte offsets into source line for each column. When interpolating
+		// we need offsets of both pixels of the 2x2 square and fraction of the right one.
+
+		const int columnInts = (SCALEMODE == ScaleMode::Interpolate) ? 3 : 1;
+
+		int memBufferSize = lineLength * columnInts * sizeof(int);
+		int * pColumns = (int*) Base::memStackAlloc(memBufferSize);
+
+		int ofsX = (int)(pos.x * 32768);		// We use 15 binals for all calculations
+
+		for (int x = 0; x < lineLength; x++)
+		{
+			if (SCALEMODE == ScaleMode::Interpolate)
+			{
+				int x1 = std::min(std::max(ofsX >> 15, 0), srcMaxX);
+				int x2 = std::min(std::max((ofsX >> 15) + 1, 0), srcMaxX);
+
+				pColumns[x * 3] = x1 * srcPixelBytes;
+				pColumns[x * 3 + 1] = x2 * srcPixelBytes;
+				pColumns[x * 3 + 2] = ofsX & 0x7FFF;
+			}
+			else
+				pColumns[x] = (ofsX >> 15) * srcPixelBytes;
+
+			ofsX += pixelIncX;
+		}
 
 		for (int y = 0; y < nLines; y++)
 		{
-			int ofsX = (int)(pos.x * 32768);
+			// Line offset is calculated the same way as in _complex_blit so that both give identical output.
+
+			int ofsY = (int)(pos.y * 32768 + lineIncY * y);
 
-			uint8_t * pSrc = pSrcSurf->m_pData + (ofsY >> 15) * srcPitch;
+			const uint8_t * pLine1;
+			const uint8_t * pLine2 = nullptr;
+			int fracY1 = 0, fracY2 = 0;
+
+			if (SCALEMODE == ScaleMode::Interpolate)
+			{
+				int y1 = std::min(std::max(ofsY >> 15, 0), srcMaxY);
+				int y2 = std::min(std::max((ofsY >> 15) + 1, 0), srcMaxY);
+
+				pLine1 = pSrcSurf->m_pData + y1 * srcPitch;
+				pLine2 = pSrcSurf->m_pData + y2 * srcPitch;
+
+				fracY2 = ofsY & 0x7FFF;
+				fracY1 = 32768 - fracY2;
+			}
+			else
+				pLine1 = pSrcSurf->m_pData + (ofsY >> 15) * srcPitch;
+
+			const int * pColumn = pColumns;
 
 			for (int x = 0; x < lineLength; x++)
 			{
 				// Step 1: Read source color.
 
 				uint8_t srcB, srcG, srcR, srcA;
-				uint8_t * p = pSrc + (ofsX >> 15)*srcPixelBytes;
 
 				if (SCALEMODE == ScaleMode::Interpolate)
 				{
@@ -1296,19 +1450,16 @@ namespace wg
 					uint8_t src21_b, src21_g, src21_r, src21_a;
 					uint8_t src22_b, src22_g, src22_r, src22_a;
 
-					_read_pixel(p, SRCFORMAT, pSrcSurf->m_pClut, src11_b, src11_g, src11_r, src11_a);
-					_read_pixel(p + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
-					_read_pixel(p + srcPitch, SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
-					_read_pixel(p + srcPitch + srcPixelBytes, SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
+					_read_pixel(pLine1 + pColumn[0], SRCFORMAT, pSrcSurf->m_pClut, src11_b, src11_g, src11_r, src11_a);
+					_read_pixel(pLine1 + pColumn[1], SRCFORMAT, pSrcSurf->m_pClut, src12_b, src12_g, src12_r, src12_a);
+					_read_pixel(pLine2 + pColumn[0], SRCFORMAT, pSrcSurf->m_pClut, src21_b, src21_g, src21_r, src21_a);
+					_read_pixel(pLine2 + pColumn[1], SRCFORMAT, pSrcSurf->m_pClut, src22_b, src22_g, src22_r, src22_a);
 
 					// Interpolate our 2x2 source colors into one source color, srcX
 
-					int fracX2 = ofsX & 0x7FFF;
+					int fracX2 = pColumn[2];
 					int fracX1 = 32768 - fracX2;
 
-					int fracY2 = ofsY & 0x7FFF;
-					int fracY1 = 32768 - fracY2;
-
 					int mul11 = fracX1 * fracY1 >> 15;
 					int mul12 = fracX2 * fracY1 >> 15;
 					int mul21 = fracX1 * fracY2 >> 15;
@@ -1321,7 +1472,7 @@ namespace wg
 				}
 				else
 				{
-					_read_pixel(p, SRCFORMAT, pSrcSurf->m_pClut, srcB, srcG, srcR, srcA);
+					_read_pixel(pLine1 + pColumn[0], SRCFORMAT, pSrcSurf->m_pClut, srcB, srcG, srcR, srcA);
 				}
 
 				// Step 3.5: Apply any tinting
@@ -1343,21 +1494,25 @@ namespace wg
 				// Step 4: Blend srcX and backX into outX
 
 				uint8_t outB, outG, outR, outA;
-				_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				if (SRCFORMAT == PixelFormat::BGRA_8_pre)
+					_blend_premultiplied_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
+				else
+					_blend_pixels(BLEND, srcB, srcG, srcR, srcA, backB, backG, backR, backA, outB, outG, outR, outA);
 
 				// Step 5: Write resulting pixel to destination
 
 				_write_pixel(pDst, DSTFORMAT, outB, outG, outR, outA);
 
-				// Step 6: Increment source and destination pointers
+				// Step 6: Increment column and destination pointers
 
-				ofsX += pixelIncX;
+				pColumn += columnInts;
 				pDst += dstPitchX;
 			}
 
-			ofsY += lineIncY;
 			pDst += dstPitchY;
 		}
+
+		Base::memStackRelease(memBufferSize);
 	}
 
 
@@ -1458,6 +1613,11 @@ namespace wg
 		if (m_pCanvas == pCanvas)
 			return true;			// Not an error.
 
+		_countStateChange();
+
+		if( m_pCanvasPixels )
+			_markCanvasDirty();
+
 		if( !pCanvas )
 		{
 			m_pCanvas		= nullptr;
@@ -1554,6 +1714,10 @@ namespace wg
 		if( !m_pCanvas)
 			return false;
 
+		if( m_pStats )
+			m_pStats->clear();
+
+		_clearRenderBounds();
 		m_pCanvasPixels = m_pCanvas->lock(AccessMode::ReadWrite);
 		m_canvasPixelBits = m_pCanvas->pixelDescription()->bits;
 		m_canvasPitch = m_pCanvas->pitch();
@@ -1595,8 +1759,10 @@ namespace wg
 		if( m_bEnableCustomFunctions && m_customFunctions.endRender )
 			m_customFunctions.endRender();
 
-		// Clean up.
+		// Clean up. Canvas is marked dirty while locked so that only the rendered area
+		// is committed on unlock.
 
+		_markCanvasDirty();
 		m_pCanvas->unlock();
 		m_pCanvasPixels = 0;
 		m_canvasPixelBits = 0;
@@ -1610,6 +1776,8 @@ namespace wg
 
 	void SoftGfxDevice::fill(const Rect& rect, const Color& col)
 	{
+		StatsScope stats(this, GfxStats::Fill, rect);
+
 		if (!m_pCanvas || !m_pCanvasPixels )
 			return;
 
@@ -1654,6 +1822,8 @@ namespace wg
 
 	void SoftGfxDevice::fill(const RectF& rect, const Color& col)
 	{
+		StatsScope stats(this, GfxStats::Fill, Rect((int)rect.x, (int)rect.y, (int)(rect.x + rect.w + 0.999f) - (int)rect.x, (int)(rect.y + rect.h + 0.999f) - (int)rect.y));
+
 		if (!m_pCanvas || !m_pCanvasPixels)
 			return;
 
@@ -1798,6 +1968,8 @@ namespace wg
 
 	void SoftGfxDevice::drawLine(Coord beg, Coord end, Color color, float thickness)
 	{
+		StatsScope stats(this, GfxStats::Line, (int64_t) (std::max(std::abs(end.x - beg.x), std::abs(end.y - beg.y)) * thickness));
+
 		if (!m_pCanvas || !m_pCanvasPixels)
 			return;
 
@@ -1931,6 +2103,8 @@ namespace wg
 
 	void SoftGfxDevice::drawLine(Coord _begin, Direction dir, int _length, Color _col, float thickness)
 	{
+		StatsScope stats(this, GfxStats::Line, (int64_t) (_length * thickness));
+
 		//TODO: Optimize!
 
 		if (thickness <= 0.f)
@@ -2100,6 +2274,8 @@ namespace wg
 
 	void SoftGfxDevice::transformDrawSegments(const Rect& _dest, int nSegments, const Color * pSegmentColors, int nEdgeStrips, const int * _pEdgeStrips, int edgeStripPitch, const int _simpleTransform[2][2])
 	{
+		StatsScope stats(this, GfxStats::Segments, _dest);
+
 		Rect dest = _dest;
 
 		SegmentEdge edges[c_maxSegments-1];
@@ -2288,6 +2464,8 @@ namespace wg
 
 	void SoftGfxDevice::drawSegments(const Rect& _dest, int nSegments, const Color * pSegmentColors, int nEdgeStrips, const int * _pEdgeStrips, int edgeStripPitch)
 	{
+		StatsScope stats(this, GfxStats::Segments, _dest);
+
 		Rect dest = _dest;
 
 		SegmentEdge edges[c_maxSegments - 1];
@@ -2542,6 +2720,8 @@ namespace wg
 
 	void SoftGfxDevice::plotPixels(int nCoords, const Coord * pCoords, const Color * pColors)
 	{
+		StatsScope stats(this, GfxStats::Plot, (int64_t) nCoords);
+
 		const int pitch = m_canvasPitch;
 		const int pixelBytes = m_canvasPixelBits / 8;
 
@@ -2563,6 +2743,8 @@ namespace wg
 		if (pSource == m_pBlitSource)
 			return true;
 
+		_countStateChange();
+
 		if (!pSource || !pSource->isInstanceOf(SoftSurface::CLASSNAME))
 		{
 			m_pBlitSource = nullptr;
@@ -2588,10 +2770,66 @@ namespace wg
 
 
 
+	//____ _blitNinePatchSection() ____________________________________________
+
+	void SoftGfxDevice::_blitNinePatchSection(const Rect& dst, const Rect& src)
+	{
+		if (dst.w <= 0 || dst.h <= 0 || src.w <= 0 || src.h <= 0)
+			return;
+
+		if (dst.w == src.w && dst.h == src.h)
+		{
+			transformBlit(dst, src.pos(), s_normalTransform);
+			return;
+		}
+
+		// Sections that are a single pixel wide in their stretched direction look the same
+		// no matter the scale mode, so we repeat that pixel line through a simple blit with
+		// zero source pitch instead of taking the complex blit path.
+
+		if (src.w == 1 && src.h == 1)
+		{
+			// A single pixel is just a fill, which doesn't need to read the source for every pixel.
+
+			SoftSurface * pSource = m_pBlitSource;
+			const uint8_t * pPixel = pSource->m_pData + src.y * pSource->m_pitch + src.x * pSource->m_pixelDescription.bits / 8;
+
+			Color col;
+			_read_pixel(pPixel, pSource->m_pixelDescription.format, pSource->m_pClut, col.b, col.g, col.r, col.a);
+
+			if (pSource->m_pixelDescription.format == PixelFormat::BGRA_8_pre)
+			{
+				int unpremul = s_unpremulTab[col.a];
+				col.b = (std::min(col.b, col.a) * unpremul) >> 16;
+				col.g = (std::min(col.g, col.a) * unpremul) >> 16;
+				col.r = (std::min(col.r, col.a) * unpremul) >> 16;
+			}
+
+			fill(dst, col);
+			return;
+		}
+
+		if (src.w == 1 && src.h == dst.h)
+		{
+			transformBlit(dst, src.pos(), s_repeatColumnTransform);
+			return;
+		}
+
+		if (src.h == 1 && src.w == dst.w)
+		{
+			transformBlit(dst, src.pos(), s_repeatRowTransform);
+			return;
+		}
+
+		GfxDevice::_blitNinePatchSection(dst, src);
+	}
+
 	//____ transformBlit() [simple] ____________________________________
 
 	void SoftGfxDevice::transformBlit(const Rect& dest, Coord _src, const int simpleTransform[2][2])
 	{
+		StatsScope stats(this, GfxStats::Blit, dest);
+
 		// Clip and render the patches
 
 		if (!dest.intersectsWith(m_clipBounds))
@@ -2659,6 +2897,8 @@ namespace wg
 
 	void SoftGfxDevice::transformBlit(const Rect& dest, CoordF _src, const float complexTransform[2][2])
 	{
+		StatsScope stats(this, GfxStats::StretchBlit, dest);
+
 		// Clip and render the patches
 
 		if (!dest.intersectsWith(m_clipBounds))
@@ -2669,6 +2909,44 @@ namespace wg
 		_src.x += 0.5f * complexTransform[0][0] + 0.5f * complexTransform[1][0];
 		_src.y += 0.5f * complexTransform[1][1] + 0.5f * complexTransform[0][1];
 
+		// Sample a smaller mipmap level when scaling down more than 2x. Bilinear interpolation
+		// of the full size surface would otherwise skip pixels and alias.
+
+		SoftSurface * pOrgSource = m_pBlitSource;
+		float	mipTransform[2][2];
+
+		if (m_pBlitSource->m_bMipmapped && m_pBlitSource->m_scaleMode == ScaleMode::Interpolate)
+		{
+			float stepX = sqrt(complexTransform[0][0] * complexTransform[0][0] + complexTransform[0][1] * complexTransform[0][1]);
+			float stepY = sqrt(complexTransform[1][0] * complexTransform[1][0] + complexTransform[1][1] * complexTransform[1][1]);
+			float minification = min(stepX, stepY);
+
+			int maxLevel = m_pBlitSource->_mipmapLevels();
+			int level = 0;
+			while (minification >= 2.f && level < maxLevel)
+			{
+				minification /= 2.f;
+				level++;
+			}
+
+			SoftSurface * pMipmap = level > 0 ? m_pBlitSource->_mipmap(level) : nullptr;
+			if (pMipmap)
+			{
+				float scale = 1.f / (1 << level);
+
+				for (int i = 0; i < 2; i++)
+					for (int j = 0; j < 2; j++)
+						mipTransform[i][j] = complexTransform[i][j] * scale;
+
+				complexTransform = mipTransform;
+				_src.x *= scale;
+				_src.y *= scale;
+
+				m_pBlitSource = pMipmap;
+				_updateBlitFunctions();
+			}
+		}
+
 		const Rect& clip = dest;
 
 		for (int i = 0; i < m_nClipRects; i++)
@@ -2718,6 +2996,12 @@ namespace wg
 
 			(this->*m_pComplexBlitOp)(patch, src, complexTransform);
 		}
+
+		if (m_pBlitSource != pOrgSource)
+		{
+			m_pBlitSource = pOrgSource;
+			_updateBlitFunctions();
+		}
 	}
 
 
@@ -2777,6 +3061,8 @@ namespace wg
 
 		uint8_t * pChunkBuffer = (uint8_t*) Base::memStackAlloc(memBufferSize);
 
+		int srcLineInc = srcPixelBytes * simpleTransform[1][0] + pSource->m_pitch * simpleTransform[1][1];
+
 		int line = 0;
 
 		while (line < dest.h)
@@ -2784,7 +3070,7 @@ namespace wg
 			int thisChunkLines = min(dest.h - line, chunkLines);
 
 			uint8_t * pDst = m_pCanvasPixels + (dest.y+line) * m_canvasPitch + dest.x * dstPixelBytes;
-			uint8_t * pSrc = pSource->m_pData + (src.y+line) * pSource->m_pitch + src.x * srcPixelBytes;
+			uint8_t * pSrc = pSource->m_pData + src.y * pSource->m_pitch + src.x * srcPixelBytes + line * srcLineInc;
 
 			m_pSimpleBlitFirstPassOp(pSrc, pChunkBuffer, pSource->m_pClut, pitchesPass1, thisChunkLines, dest.w, m_colTrans);
 			m_pBlitSecondPassOp(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, dest.w, m_colTrans);
@@ -2809,11 +3095,17 @@ namespace wg
 			pos.y -= 0.5f;
 		}
 
+		// Axis-aligned scaling and flipping has its own faster kernels.
+
+		ComplexBlitOp_p pOp = m_pComplexBlitOnePassOp;
+		if (transformMatrix[0][1] == 0.f && transformMatrix[1][0] == 0.f && m_pStretchBlitOnePassOp)
+			pOp = m_pStretchBlitOnePassOp;
+
 		int dstPixelBytes = m_canvasPixelBits / 8;
 
 		uint8_t * pDst = m_pCanvasPixels + dest.y * m_canvasPitch + dest.x * dstPixelBytes;
 
-		m_pComplexBlitOnePassOp(pSource, pos, transformMatrix, pDst, dstPixelBytes, m_canvasPitch - dstPixelBytes * dest.w, dest.h, dest.w, m_colTrans);
+		pOp(pSource, pos, transformMatrix, pDst, dstPixelBytes, m_canvasPitch - dstPixelBytes * dest.w, dest.h, dest.w, m_colTrans);
 	}
 
 
@@ -2831,6 +3123,11 @@ namespace wg
 			pos.y -= 0.5f;
 		}
 
+		// Axis-aligned scaling and flipping has its own faster kernels.
+
+		ComplexBlitOp_p pFirstPassOp = m_pComplexBlitFirstPassOp;
+		if (transformMatrix[0][1] == 0.f && transformMatrix[1][0] == 0.f && m_pStretchBlitFirstPassOp)
+			pFirstPassOp = m_pStretchBlitFirstPassOp;
 
 		int dstPixelBytes = m_canvasPixelBits / 8;
 
@@ -2862,7 +3159,7 @@ namespace wg
 
 			uint8_t * pDst = m_pCanvasPixels + (dest.y + line) * m_canvasPitch + dest.x * dstPixelBytes;
 
-			m_pComplexBlitFirstPassOp(pSource, pos, transformMatrix, pChunkBuffer, 4, 0, thisChunkLines, dest.w, m_colTrans);
+			pFirstPassOp(pSource, pos, transformMatrix, pChunkBuffer, 4, 0, thisChunkLines, dest.w, m_colTrans);
 			m_pBlitSecondPassOp(pChunkBuffer, pDst, nullptr, pitchesPass2, thisChunkLines, dest.w, m_colTrans);
 
 			pos.x += transformMatrix[1][0] * thisChunkLines;
@@ -2913,9 +3210,11 @@ namespace wg
 
 		m_pSimpleBlitOnePassOp = nullptr;
 		m_pComplexBlitOnePassOp = nullptr;
+		m_pStretchBlitOnePassOp = nullptr;
 
 		m_pSimpleBlitFirstPassOp = s_moveTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 		m_pComplexBlitFirstPassOp = s_transformTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+		m_pStretchBlitFirstPassOp = s_stretchTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 		m_pBlitSecondPassOp = s_pass2OpTab[(int)m_blendMode][(int)m_pCanvas->pixelFormat()];
 
 		// Try to find a suitable one-pass operation
@@ -2926,11 +3225,13 @@ namespace wg
 			{
 				m_pSimpleBlitOnePassOp = s_blendTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 				m_pComplexBlitOnePassOp = s_transformBlendTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+				m_pStretchBlitOnePassOp = s_stretchBlendTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			}
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 			{
 				m_pSimpleBlitOnePassOp = s_blendTo_BGR_8_OpTab[(int)srcFormat][tintMode];
 				m_pComplexBlitOnePassOp = s_transformBlendTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+				m_pStretchBlitOnePassOp = s_stretchBlendTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			}
 		}
 		else if (m_blendMode == BlendMode::Replace)
@@ -2939,11 +3240,13 @@ namespace wg
 			{
 				m_pSimpleBlitOnePassOp = s_moveTo_BGRA_8_OpTab[(int)srcFormat][tintMode];
 				m_pComplexBlitOnePassOp = s_transformTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+				m_pStretchBlitOnePassOp = s_stretchTo_BGRA_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			}
 			else if (dstFormat == PixelFormat::BGR_8 || dstFormat == PixelFormat::BGRX_8)
 			{
 				m_pSimpleBlitOnePassOp = s_moveTo_BGR_8_OpTab[(int)srcFormat][tintMode];
 				m_pComplexBlitOnePassOp = s_transformTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
+				m_pStretchBlitOnePassOp = s_stretchTo_BGR_8_OpTab[(int)srcFormat][(int)scaleMode][tintMode];
 			}
 		}
 
@@ -2973,6 +3276,12 @@ namespace wg
 		for (int i = 0; i < 256; i++)
 			s_mulTab[i] = i * 256 + i + 1;
 
+		// Init unpremulTab
+
+		s_unpremulTab[0] = 0;
+		for (int i = 1; i < 256; i++)
+			s_unpremulTab[i] = (65536 * 255 + i/2) / i;
+
 		// Init lineThicknessTable
 
 		for( int i = 0 ; i < 17 ; i++ )
@@ -3021,6 +3330,16 @@ namespace wg
 				s_transformBlendTo_BGRA_8_OpTab[i][1][j] = nullptr;
 				s_transformBlendTo_BGR_8_OpTab[i][0][j] = nullptr;
 				s_transformBlendTo_BGR_8_OpTab[i][1][j] = nullptr;
+
+				s_stretchTo_BGRA_8_OpTab[i][0][j] = nullptr;
+				s_stretchTo_BGRA_8_OpTab[i][1][j] = nullptr;
+				s_stretchTo_BGR_8_OpTab[i][0][j] = nullptr;
+				s_stretchTo_BGR_8_OpTab[i][1][j] = nullptr;
+
+				s_stretchBlendTo_BGRA_8_OpTab[i][0][j] = nullptr;
+				s_stretchBlendTo_BGRA_8_OpTab[i][1][j] = nullptr;
+				s_stretchBlendTo_BGR_8_OpTab[i][0][j] = nullptr;
+				s_stretchBlendTo_BGR_8_OpTab[i][1][j] = nullptr;
 			}
 		}
 
@@ -3426,6 +3745,9 @@ namespace wg
 		s_moveTo_BGRA_8_OpTab[(int)PixelFormat::A8][0] =_simple_blit < PixelFormat::A8, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
 		s_moveTo_BGRA_8_OpTab[(int)PixelFormat::A8][1] =_simple_blit < PixelFormat::A8, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
 
+		s_moveTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0] =_simple_blit < PixelFormat::BGRA_8_pre, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_moveTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1] =_simple_blit < PixelFormat::BGRA_8_pre, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
 		// Init straight blend to BGRA_8 Operation Table
 
 		s_blendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0] =_simple_blit < PixelFormat::BGRA_8, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
@@ -3449,6 +3771,9 @@ namespace wg
 		s_blendTo_BGRA_8_OpTab[(int)PixelFormat::A8][0] =_simple_blit < PixelFormat::A8, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
 		s_blendTo_BGRA_8_OpTab[(int)PixelFormat::A8][1] =_simple_blit < PixelFormat::A8, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
 
+		s_blendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0] =_simple_blit < PixelFormat::BGRA_8_pre, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_blendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1] =_simple_blit < PixelFormat::BGRA_8_pre, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
 
 
 		// Init straight move to BGR_8 Operation Table
@@ -3474,6 +3799,9 @@ namespace wg
 		s_moveTo_BGR_8_OpTab[(int)PixelFormat::A8][0] =_simple_blit < PixelFormat::A8, 0, BlendMode::Replace, PixelFormat::BGR_8>;
 		s_moveTo_BGR_8_OpTab[(int)PixelFormat::A8][1] =_simple_blit < PixelFormat::A8, 1, BlendMode::Replace, PixelFormat::BGR_8>;
 
+		s_moveTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0] =_simple_blit < PixelFormat::BGRA_8_pre, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_moveTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1] =_simple_blit < PixelFormat::BGRA_8_pre, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
 
 		// Init straight blend to BGR_8 Operation Table
 
@@ -3498,6 +3826,9 @@ namespace wg
 		s_blendTo_BGR_8_OpTab[(int)PixelFormat::A8][0] =_simple_blit < PixelFormat::A8, 0, BlendMode::Blend, PixelFormat::BGR_8>;
 		s_blendTo_BGR_8_OpTab[(int)PixelFormat::A8][1] =_simple_blit < PixelFormat::A8, 1, BlendMode::Blend, PixelFormat::BGR_8>;
 
+		s_blendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0] =_simple_blit < PixelFormat::BGRA_8_pre, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_blendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1] =_simple_blit < PixelFormat::BGRA_8_pre, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
 		// Init stretch move to BGRA_8 Operation Table
 
 		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0][0] = _complex_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
@@ -3535,6 +3866,11 @@ namespace wg
 		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][0] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
 		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][1] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
 
+		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_transformTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
 
 		// Init straight blend to BGRA_8 Operation Table
 
@@ -3573,6 +3909,11 @@ namespace wg
 		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][0] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
 		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][1] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
 
+		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8 > ;
+		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8 >;
+		s_transformBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
 
 		// Init stretch move to BGR_8 Operation Table
 
@@ -3611,6 +3952,11 @@ namespace wg
 		s_transformTo_BGR_8_OpTab[(int)PixelFormat::A8][1][0] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
 		s_transformTo_BGR_8_OpTab[(int)PixelFormat::A8][1][1] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
 
+		s_transformTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_transformTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_transformTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_transformTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
 
 		// Init stretch blend to BGR_8 Operation Table
 
@@ -3649,6 +3995,183 @@ namespace wg
 		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][0] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
 		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][1] = _complex_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
 
+		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_transformBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _complex_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+
+		// Init axis-aligned stretch move to BGRA_8 Operation Table
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGRA_8>;
+		s_stretchTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGRA_8>;
+
+
+		// Init axis-aligned stretch blend to BGRA_8 Operation Table
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8 > ;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8 >;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGRA_8 > ;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGRA_8 >;
+		s_stretchBlendTo_BGRA_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGRA_8>;
+
+
+		// Init axis-aligned stretch move to BGR_8 Operation Table
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Replace, PixelFormat::BGR_8>;
+		s_stretchTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Replace, PixelFormat::BGR_8>;
+
+
+		// Init axis-aligned stretch blend to BGR_8 Operation Table
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][0][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][0][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][1][0] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8][1][1] = _stretch_blit < PixelFormat::BGRA_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRX_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][0][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][0][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][1][0] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_8][1][1] = _stretch_blit < PixelFormat::BGR_8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][0][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][0][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][1][0] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGR_565][1][1] = _stretch_blit < PixelFormat::BGR_565, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][0][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][0][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][1][0] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_4][1][1] = _stretch_blit < PixelFormat::BGRA_4, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::I8][0][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::I8][0][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::I8][1][0] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::I8][1][1] = _stretch_blit < PixelFormat::I8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][0][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][0][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][0] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::A8][1][1] = _stretch_blit < PixelFormat::A8, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][0][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Nearest, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][0] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 0, BlendMode::Blend, PixelFormat::BGR_8>;
+		s_stretchBlendTo_BGR_8_OpTab[(int)PixelFormat::BGRA_8_pre][1][1] = _stretch_blit < PixelFormat::BGRA_8_pre, ScaleMode::Interpolate, 1, BlendMode::Blend, PixelFormat::BGR_8>;
+
 
 		// Init Segments Operation Table
 
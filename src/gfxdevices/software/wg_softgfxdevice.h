@@ -174,6 +174,10 @@ namespace wg
 											uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
 											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
 
+		inline static void	_blend_premultiplied_pixels(BlendMode mode, uint8_t srcB, uint8_t srcG, uint8_t srcR, uint8_t srcA,
+											uint8_t backB, uint8_t backG, uint8_t backR, uint8_t backA,
+											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
+
 		inline static void _init_tint_color(TintMode tintMode, const ColTrans& tint, uint8_t inB, uint8_t inG, uint8_t inR, uint8_t inA,
 											uint8_t& outB, uint8_t& outG, uint8_t& outR, uint8_t& outA);
 
@@ -227,6 +231,8 @@ namespace wg
 
 		void	_lineToEdges(const WaveLine * pWave, int offset, int nPoints, SegmentEdge * pDest, int pitch);
 
+		void	_blitNinePatchSection(const Rect& dst, const Rect& src) override;
+
 		void	_initTables();
 		void	_updateBlitFunctions();
 		void	_clearCustomFunctionTable();
@@ -281,8 +287,15 @@ namespace wg
 		static ComplexBlitOp_p	s_transformBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
 		static ComplexBlitOp_p	s_transformBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];	// [SourceFormat][ScaleMode][TintMode]
 
+		static ComplexBlitOp_p	s_stretchTo_BGRA_8_OpTab[PixelFormat_size][2][2];			// [SourceFormat][ScaleMode][TintMode]
+		static ComplexBlitOp_p	s_stretchTo_BGR_8_OpTab[PixelFormat_size][2][2];			// [SourceFormat][ScaleMode][TintMode]
+
+		static ComplexBlitOp_p	s_stretchBlendTo_BGRA_8_OpTab[PixelFormat_size][2][2];		// [SourceFormat][ScaleMode][TintMode]
+		static ComplexBlitOp_p	s_stretchBlendTo_BGR_8_OpTab[PixelFormat_size][2][2];		// [SourceFormat][ScaleMode][TintMode]
+
 
 		static int			s_mulTab[256];
+		static int			s_unpremulTab[256];		// 65536*255/alpha, for converting premultiplied colors back.
 
 		SurfaceFactory_p	m_pSurfaceFactory;
 
@@ -302,6 +315,8 @@ namespace wg
 		ComplexBlitOp_p		m_pComplexBlitOnePassOp		= nullptr;
 		SimpleBlitOp_p		m_pSimpleBlitFirstPassOp	= nullptr;
 		ComplexBlitOp_p		m_pComplexBlitFirstPassOp	= nullptr;
+		ComplexBlitOp_p		m_pStretchBlitOnePassOp		= nullptr;		// Used instead of complex blit ops when transform is axis-aligned.
+		ComplexBlitOp_p		m_pStretchBlitFirstPassOp	= nullptr;
 		SimpleBlitOp_p		m_pBlitSecondPassOp			= nullptr;		// Second pass is same for simple and complex blits (always a simple blit).
 
 		//
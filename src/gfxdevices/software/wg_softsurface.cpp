@@ -46,7 +46,9 @@ namespace wg
 		if (format == PixelFormat::Unknown || format == PixelFormat::Custom || format < PixelFormat_min || format > PixelFormat_max || (format == PixelFormat::I8 && pClut == nullptr) )
 			return SoftSurface_p();
 
-		return SoftSurface_p(new SoftSurface(size,format,pClut));
+		SoftSurface_p p(new SoftSurface(size,format,pClut));
+		p->m_bMipmapped = (flags & SurfaceFlag::Mipmapped) && _canMipmap(format);
+		return p;
 	}
 
 	SoftSurface_p SoftSurface::create( Size size, PixelFormat format, Blob * pBlob, int pitch, int flags, const Color * pClut)
@@ -54,7 +56,9 @@ namespace wg
 		if (format == PixelFormat::Unknown || format == PixelFormat::Custom || format < PixelFormat_min || format > PixelFormat_max || (format == PixelFormat::I8 && pClut == nullptr) || !pBlob || pitch % 4 != 0 )
 			return SoftSurface_p();
 
-		return SoftSurface_p(new SoftSurface(size,format,pBlob,pitch,pClut));
+		SoftSurface_p p(new SoftSurface(size,format,pBlob,pitch,pClut));
+		p->m_bMipmapped = (flags & SurfaceFlag::Mipmapped) && _canMipmap(format);
+		return p;
 	}
 
 	SoftSurface_p SoftSurface::create( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int flags, const Color * pClut )
@@ -63,7 +67,9 @@ namespace wg
 			 (format == PixelFormat::I8 && pClut == nullptr) || pPixels == nullptr || pitch <= 0 || pPixelDescription == nullptr)
 			return SoftSurface_p();
 
-		return  SoftSurface_p(new SoftSurface(size,format,pPixels,pitch,pPixelDescription,pClut));
+		SoftSurface_p p(new SoftSurface(size,format,pPixels,pitch,pPixelDescription,pClut));
+		p->m_bMipmapped = (flags & SurfaceFlag::Mipmapped) && _canMipmap(format);
+		return p;
 	};
 
 	SoftSurface_p SoftSurface::create( Surface * pOther, int flags )
@@ -71,7 +77,9 @@ namespace wg
 		if( !pOther )
 			return SoftSurface_p();
 
-		return SoftSurface_p(new SoftSurface( pOther ));
+		SoftSurface_p p(new SoftSurface( pOther ));
+		p->m_bMipmapped = (flags & SurfaceFlag::Mipmapped) && _canMipmap(p->pixelFormat());
+		return p;
 	}
 
 
@@ -85,16 +93,10 @@ namespace wg
 
 		m_pitch = ((size.w+3)&0xFFFFFFFC)*m_pixelDescription.bits/8;
 		m_size = size;
-		m_pBlob = Blob::create( m_pitch*size.h + (pClut ? 1024 : 0) );
+		m_pBlob = Blob::create( m_pitch*size.h );
 		m_pData = (uint8_t*) m_pBlob->data();
 
-		if (pClut)
-		{
-			m_pClut = (Color*)(m_pData + m_pitch * size.h);
-			memcpy(m_pClut, pClut, 1024);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut(pClut);
 	}
 
 	SoftSurface::SoftSurface( Size size, PixelFormat format, Blob * pBlob, int pitch, const Color * pClut )
@@ -106,7 +108,7 @@ namespace wg
 		m_size = size;
 		m_pBlob = pBlob;
 		m_pData = (uint8_t*) m_pBlob->data();
-		m_pClut = const_cast<Color*>(pClut);
+		_setClut(pClut);
 	}
 
 	SoftSurface::SoftSurface(Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, const Color * pClut)
@@ -115,20 +117,14 @@ namespace wg
 
 		m_pitch = ((size.w + 3) & 0xFFFFFFFC)*m_pixelDescription.bits / 8;
 		m_size = size;
-		m_pBlob = Blob::create(m_pitch*m_size.h + (pClut ? 1024 : 0) );
+		m_pBlob = Blob::create(m_pitch*m_size.h);
 		m_pData = (uint8_t*)m_pBlob->data();
 
 		m_pPixels = m_pData;	// Simulate a lock
 		_copyFrom(pPixelDescription == 0 ? &m_pixelDescription : pPixelDescription, pPixels, pitch, size, size);
 		m_pPixels = 0;
 
-		if (pClut)
-		{
-			m_pClut = (Color*)(m_pData + m_pitch * size.h);
-			memcpy(m_pClut, pClut, 1024);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut(pClut);
 	}
 
 
@@ -145,20 +141,14 @@ namespace wg
 
 		m_pitch = ((size.w+3)&0xFFFFFFFC)*m_pixelDescription.bits/8;
 		m_size = size;
-		m_pBlob = Blob::create(m_pitch*m_size.h + (pOther->clut() ? 1024 : 0) );
+		m_pBlob = Blob::create(m_pitch*m_size.h);
 		m_pData = (uint8_t*) m_pBlob->data();
 
 		m_pPixels = m_pData;	// Simulate a lock
 		_copyFrom( &m_pixelDescription, pPixels, pitch, Rect(size), Rect(size) );
 		m_pPixels = 0;
 
-		if ( pOther->clut() )
-		{
-			m_pClut = (Color*)(m_pData + m_pitch * size.h);
-			memcpy(m_pClut, pOther->clut(), 1024);
-		}
-		else
-			m_pClut = nullptr;
+		_setClut( pOther->clut() );
 
 		pOther->unlock();
 	}
@@ -257,6 +247,7 @@ namespace wg
 				return ((pConvTab[(pixel & m_pixelDescription.A_mask) >> m_pixelDescription.A_shift] >> m_pixelDescription.A_loss) << m_pixelDescription.A_shift);
 			}
 			case PixelFormat::BGRA_8:
+			case PixelFormat::BGRA_8_pre:
 			{
 				uint8_t * pPixel = m_pData + m_pitch * coord.y + coord.x * 4;
 				return pPixel[3];
@@ -288,7 +279,7 @@ namespace wg
 
 	uint8_t * SoftSurface::lock( AccessMode mode )
 	{
-		m_accessMode = AccessMode::ReadWrite;
+		m_accessMode = mode;
 		m_pPixels = m_pData;
 		m_lockRegion = Rect(0,0,m_size);
 		return m_pPixels;
@@ -308,6 +299,15 @@ namespace wg
 
 	void SoftSurface::unlock()
 	{
+		_commitLockDirtyRects();
+
+		if (!m_mipmaps.empty() && m_accessMode != AccessMode::ReadOnly && m_accessMode != AccessMode::None)
+		{
+			for (const Rect * pRect = m_lockDirtyRects.begin(); pRect != m_lockDirtyRects.end(); pRect++)
+				_updateMipmaps(*pRect);
+		}
+		m_lockDirtyRects.clear();
+
 		m_accessMode = AccessMode::None;
 		m_pPixels = 0;
 		m_lockRegion.clear();
@@ -351,6 +351,157 @@ namespace wg
 			default:
 				break;
 		}
+
+		markDirty(Rect(m_size));
+
+		if (!m_mipmaps.empty())
+			_updateMipmaps(Rect(m_size));
+	}
+
+	//____ _canMipmap() ____________________________________________________________
+
+	bool SoftSurface::_canMipmap(PixelFormat format)
+	{
+		// Only formats with 8 bits per channel, which can be averaged byte by byte.
+
+		return (format == PixelFormat::BGR_8 || format == PixelFormat::BGRX_8 || format == PixelFormat::BGRA_8 ||
+				format == PixelFormat::BGRA_8_pre || format == PixelFormat::A8);
+	}
+
+	//____ _mipmapLevels() _________________________________________________________
+
+	int SoftSurface::_mipmapLevels() const
+	{
+		if (!m_bMipmapped)
+			return 0;
+
+		int levels = 0;
+		Size sz = m_size;
+		while (sz.w > 1 || sz.h > 1)
+		{
+			sz.w = (sz.w + 1) / 2;
+			sz.h = (sz.h + 1) / 2;
+			levels++;
+		}
+		return levels;
+	}
+
+	//____ _mipmap() _______________________________________________________________
+	/*
+		Returns the specified mipmap level, generating it and the levels above on demand.
+		Level 0 is the surface itself. Each level is half the size of the one above,
+		rounded up, so that pixel x of one level covers pixels 2x and 2x+1 of the level above.
+	*/
+
+	SoftSurface * SoftSurface::_mipmap(int level)
+	{
+		if (level <= 0)
+			return this;
+
+		if (level > _mipmapLevels())
+			return nullptr;
+
+		while ((int) m_mipmaps.size() < level)
+		{
+			SoftSurface * pAbove = m_mipmaps.empty() ? this : m_mipmaps.back().rawPtr();
+
+			Size sz((pAbove->m_size.w + 1) / 2, (pAbove->m_size.h + 1) / 2);
+			int pitch = ((sz.w + 3) & 0xFFFFFFFC)*m_pixelDescription.bits / 8;
+
+			// One extra line since interpolating blits might read one line beyond the last.
+
+			Blob_p pBlob = Blob::create(pitch*(sz.h + 1));
+			memset(pBlob->data(), 0, pitch*(sz.h + 1));
+
+			SoftSurface_p pLevel = SoftSurface::create(sz, m_pixelDescription.format, pBlob, pitch);
+			pLevel->m_scaleMode = ScaleMode::Interpolate;
+			m_mipmaps.push_back(pLevel);
+
+			_downsample(pAbove, pLevel.rawPtr(), Rect(sz));
+		}
+
+		return m_mipmaps[level-1].rawPtr();
+	}
+
+	//____ _downsample() ___________________________________________________________
+	/*
+		Generates region of a mipmap level by averaging 2x2 pixels of the level above.
+		Pixels outside the level above are replaced by its last column/row.
+	*/
+
+	void SoftSurface::_downsample(const SoftSurface * pAbove, SoftSurface * pLevel, const Rect& region)
+	{
+		PixelFormat format = pLevel->m_pixelDescription.format;
+		int pixelBytes = pLevel->m_pixelDescription.bits / 8;
+
+		int srcPitch = pAbove->m_pitch;
+		int dstPitch = pLevel->m_pitch;
+
+		int maxX = pAbove->m_size.w - 1;
+		int maxY = pAbove->m_size.h - 1;
+
+		for (int y = region.y; y < region.y + region.h; y++)
+		{
+			const uint8_t * pLine1 = pAbove->m_pData + (y * 2) * srcPitch;
+			const uint8_t * pLine2 = pAbove->m_pData + min(y * 2 + 1, maxY) * srcPitch;
+
+			uint8_t * pDst = pLevel->m_pData + y * dstPitch + region.x * pixelBytes;
+
+			for (int x = region.x; x < region.x + region.w; x++)
+			{
+				int ofs1 = (x * 2) * pixelBytes;
+				int ofs2 = min(x * 2 + 1, maxX) * pixelBytes;
+
+				const uint8_t * p11 = pLine1 + ofs1;
+				const uint8_t * p12 = pLine1 + ofs2;
+				const uint8_t * p21 = pLine2 + ofs1;
+				const uint8_t * p22 = pLine2 + ofs2;
+
+				if (format == PixelFormat::BGRA_8)
+				{
+					// Weight colors by alpha so transparent pixels don't bleed their color into the average.
+
+					int a11 = p11[3], a12 = p12[3], a21 = p21[3], a22 = p22[3];
+					int alphaSum = a11 + a12 + a21 + a22;
+
+					if (alphaSum == 0)
+						*((uint32_t*)pDst) = 0;
+					else
+					{
+						for (int i = 0; i < 3; i++)
+							pDst[i] = (uint8_t) ((p11[i] * a11 + p12[i] * a12 + p21[i] * a21 + p22[i] * a22 + alphaSum / 2) / alphaSum);
+						pDst[3] = (uint8_t) ((alphaSum + 2) >> 2);
+					}
+				}
+				else
+				{
+					for (int i = 0; i < pixelBytes; i++)
+						pDst[i] = (uint8_t) ((p11[i] + p12[i] + p21[i] + p22[i] + 2) >> 2);
+				}
+
+				pDst += pixelBytes;
+			}
+		}
+	}
+
+	//____ _updateMipmaps() ________________________________________________________
+
+	void SoftSurface::_updateMipmaps(const Rect& region)
+	{
+		Rect rect = region;
+		SoftSurface * pAbove = this;
+
+		for (auto& pLevel : m_mipmaps)
+		{
+			int x1 = rect.x / 2;
+			int y1 = rect.y / 2;
+			int x2 = (rect.x + rect.w + 1) / 2;
+			int y2 = (rect.y + rect.h + 1) / 2;
+
+			rect = Rect(x1, y1, x2 - x1, y2 - y1);
+			_downsample(pAbove, pLevel.rawPtr(), rect);
+			pAbove = pLevel.rawPtr();
+		}
 	}
 
 } // namespace wg
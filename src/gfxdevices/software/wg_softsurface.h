@@ -65,6 +65,7 @@ namespace wg
 		//.____ Appearance ____________________________________________________
 
 		bool		isOpaque() const;
+		bool		isMipmapped() const { return m_bMipmapped; }
 
 		//.____ Content _______________________________________________________
 
@@ -90,9 +91,18 @@ namespace wg
 
 		virtual ~SoftSurface();
 
+		static bool		_canMipmap( PixelFormat format );
+		int				_mipmapLevels() const;
+		SoftSurface *	_mipmap( int level );
+		void			_updateMipmaps( const Rect& region );
+		static void		_downsample( const SoftSurface * pAbove, SoftSurface * pLevel, const Rect& region );
+
 		Blob_p		m_pBlob;
 		Size		m_size;
 		uint8_t*	m_pData;
+
+		bool		m_bMipmapped = false;
+		std::vector<SoftSurface_p>	m_mipmaps;		// Mipmap levels generated so far, starting with level 1 (half size).
 	};
 
 
@@ -79,11 +79,30 @@ namespace wg
 
 	Surface_p SoftSurfaceFactory::createSurface( Size size, PixelFormat format, uint8_t * pPixels, int pitch, const PixelDescription * pPixelDescription, int flags, const Color * pClut ) const
 	{
+		if( m_bPremultiplyOnLoad && format == PixelFormat::BGRA_8 )
+		{
+			PixelDescription	straight;
+			if( pPixelDescription == nullptr )
+			{
+				Util::pixelFormatToDescription(PixelFormat::BGRA_8, straight);
+				pPixelDescription = &straight;
+			}
+			format = PixelFormat::BGRA_8_pre;
+		}
+
 		return SoftSurface::create(size,format, pPixels, pitch, pPixelDescription, flags, pClut);
 	}
 
 	Surface_p SoftSurfaceFactory::createSurface( Surface * pOther, int flags ) const
 	{
+		if( m_bPremultiplyOnLoad && pOther && pOther->pixelFormat() == PixelFormat::BGRA_8 )
+		{
+			SoftSurface_p pSurface = SoftSurface::create( pOther->size(), PixelFormat::BGRA_8_pre, flags );
+			if( pSurface )
+				pSurface->copyFrom( pOther, Coord(0,0) );
+			return pSurface;
+		}
+
 		return SoftSurface::create( pOther, flags );
 	}
 
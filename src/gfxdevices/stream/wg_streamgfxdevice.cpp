@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <math.h>
 #include <algorithm>
+#include <cstdlib>
 
 using namespace std;
 
@@ -124,6 +125,7 @@ namespace wg
 
 	void StreamGfxDevice::clearClipList()
 	{
+		_countStateChange();
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetClip, 0 };
 	}
 
@@ -139,7 +141,11 @@ namespace wg
 				return false;			// Surface must be of type StreamSurface!
 		}
 
+		if( m_bRendering )
+			_markCanvasDirty();
+
 		m_pCanvas		= _pSurface;
+		_countStateChange();
 
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetCanvas, 2 };
 
@@ -158,7 +164,7 @@ namespace wg
 	{
 		GfxDevice::setTintColor(color);
 
-		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetTintColor, 2 };
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetTintColor, 4 };
 		(*m_pStream) << color;
 	}
 
@@ -186,7 +192,14 @@ namespace wg
 		if (!pSource || !pSource->isInstanceOf(StreamSurface::CLASSNAME) )
 			return false;
 
+		// Skins set their blit source every time they render, no need to stream a chunk
+		// unless it actually changes.
+
+		if (pSource == m_pBlitSource)
+			return true;
+
 		m_pBlitSource = pSource;
+		_countStateChange();
 
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::SetBlitSource, 2 };
 		(*m_pStream) << static_cast<StreamSurface*>(pSource)->m_inStreamId;
@@ -202,8 +215,12 @@ namespace wg
 		if( m_bRendering == true )
 			return false;
 
+		if( m_pStats )
+			m_pStats->clear();
+
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::BeginRender, 0 };
 
+		_clearRenderBounds();
 		m_bRendering = true;
 		return true;
 	}
@@ -218,6 +235,8 @@ namespace wg
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::EndRender, 0 };
 		m_pStream->flush();
 
+		_markCanvasDirty();
+
 		m_bRendering = false;
 		return true;
 	}
@@ -226,6 +245,8 @@ namespace wg
 
 	void StreamGfxDevice::fill( const Rect& _rect, const Color& _col )
 	{
+		StatsScope stats(this, GfxStats::Fill, _rect);
+
 		if( _col.a  == 0 || _rect.w < 1 || _rect.h < 1 )
 			return;
 
@@ -238,6 +259,8 @@ namespace wg
 
 	void StreamGfxDevice::fill(const RectF& rect, const Color& col)
 	{
+		StatsScope stats(this, GfxStats::Fill, Rect((int)rect.x, (int)rect.y, (int)(rect.x + rect.w + 0.999f) - (int)rect.x, (int)(rect.y + rect.h + 0.999f) - (int)rect.y));
+
 		if (col.a == 0)
 			return;
 
@@ -252,6 +275,8 @@ namespace wg
 
 	void StreamGfxDevice::plotPixels(int nCoords, const Coord * pCoords, const Color * pColors)
 	{
+		StatsScope stats(this, GfxStats::Plot, (int64_t) nCoords);
+
 		// Each pixel is packed down to 4 + 4 bytes: int16_t x, int16_t y, Color
 		// All coordinates comes first, then all colors.
 
@@ -296,6 +321,8 @@ namespace wg
 
 	void StreamGfxDevice::drawLine(Coord begin, Coord end, Color color, float thickness)
 	{
+		StatsScope stats(this, GfxStats::Line, (int64_t) (std::max(std::abs(end.x - begin.x), std::abs(end.y - begin.y)) * thickness));
+
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::DrawLineFromTo, 16 };
 		(*m_pStream) << begin;
 		(*m_pStream) << end;
@@ -305,6 +332,8 @@ namespace wg
 
 	void StreamGfxDevice::drawLine(Coord begin, Direction dir, int length, Color col, float thickness)
 	{
+		StatsScope stats(this, GfxStats::Line, (int64_t) (length * thickness));
+
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::DrawLineStraight, 16 };
 		(*m_pStream) << begin;
 		(*m_pStream) << dir;
@@ -317,6 +346,8 @@ namespace wg
 
 	void StreamGfxDevice::blit(Coord dest, const Rect& _src)
 	{
+		StatsScope stats(this, GfxStats::Blit, Rect(dest, _src.size()));
+
 		if (_src.w < 1 || _src.h < 1)
 			return;
 
@@ -329,17 +360,36 @@ namespace wg
 
 	void StreamGfxDevice::stretchBlit(const Rect& dest, const RectF& source)
 	{
+		StatsScope stats(this, GfxStats::StretchBlit, dest);
+
 
 		(*m_pStream) << GfxStream::Header{ GfxChunkId::StretchBlit, 24 };
 		(*m_pStream) << dest;
 		(*m_pStream) << source;
 	}
 
+	//____ blitNinePatch() ________________________________________________
+
+	void StreamGfxDevice::blitNinePatch(const Rect& dstRect, const Border& dstFrame, const Rect& srcRect, const Border& srcFrame)
+	{
+		StatsScope stats(this, GfxStats::Blit, dstRect);
+
+		// Sent as one chunk so the receiving device can use its own nine-patch path.
+
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::BlitNinePatch, 32 };
+		(*m_pStream) << dstRect;
+		(*m_pStream) << dstFrame;
+		(*m_pStream) << srcRect;
+		(*m_pStream) << srcFrame;
+	}
+
 	//____ transformBlit() _____________________________________________
 
 	void StreamGfxDevice::transformBlit(const Rect& dest, Coord src, const int simpleTransform[2][2])
 	{
-		(*m_pStream) << GfxStream::Header{ GfxChunkId::SimpleTransformBlit, 18 };
+		StatsScope stats(this, GfxStats::Blit, dest);
+
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::SimpleTransformBlit, 16 };
 		(*m_pStream) << dest;
 		(*m_pStream) << src;
 		(*m_pStream) << simpleTransform;
@@ -347,7 +397,9 @@ namespace wg
 
 	void StreamGfxDevice::transformBlit(const Rect& dest, CoordF src, const float complexTransform[2][2])
 	{
-		(*m_pStream) << GfxStream::Header{ GfxChunkId::ComplexTransformBlit, 34 };
+		StatsScope stats(this, GfxStats::StretchBlit, dest);
+
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::ComplexTransformBlit, 32 };
 		(*m_pStream) << dest;
 		(*m_pStream) << src;
 		(*m_pStream) << complexTransform;
@@ -357,11 +409,13 @@ namespace wg
 
 	void StreamGfxDevice::transformDrawSegments(const Rect& dest, int nSegments, const Color * pSegmentColors, int nEdgeStrips, const int * pEdgeStrips, int edgeStripPitch, const int simpleTransform[2][2])
 	{
+		StatsScope stats(this, GfxStats::Segments, dest);
+
 		//NOTE: Precision of edge data is scaled down to 4 binals and there is a limitation of 4095 pixels height of the segment waveform to keep data compact.
 
 		// Generate the TransformDrawSegmentPatches chunk.
 
-		(*m_pStream) << GfxStream::Header{ GfxChunkId::TransformDrawSegments, 18 + nSegments * 4 };
+		(*m_pStream) << GfxStream::Header{ GfxChunkId::TransformDrawSegments, 16 + nSegments * 4 };
 		(*m_pStream) << dest;
 		(*m_pStream) << (uint16_t) nSegments;
 		(*m_pStream) << (uint16_t) nEdgeStrips;
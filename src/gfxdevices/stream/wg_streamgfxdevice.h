@@ -92,6 +92,8 @@ namespace wg
 //		void	stretchBlit(const Rect& dest, const Rect& src) override;
 		void	stretchBlit(const Rect& dest, const RectF& src) override;
 
+		void	blitNinePatch(const Rect& dstRect, const Border& dstFrame, const Rect& srcRect, const Border& srcFrame) override;
+
 //		void	stretchFlipBlit(const Rect& dest, GfxFlip flip) override;
 //		void	stretchFlipBlit(const Rect& dest, const Rect& src, GfxFlip flip) override;
 //		void	stretchFlipBlit(const Rect& dest, const RectF& src, GfxFlip flip) override;
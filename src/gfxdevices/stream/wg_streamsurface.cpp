@@ -86,7 +86,8 @@ namespace wg
 		m_size = size;
 		m_pitch = ((size.w + 3) & 0xFFFFFFFC)*m_pixelDescription.bits / 8;
 
-		m_inStreamId = _sendCreateSurface(size, format, flags, pClut);
+		_setClut(pClut);
+		m_inStreamId = _sendCreateSurface(size, format, flags);
 
 		if (m_pixelDescription.bits > 8 && (flags & SurfaceFlag::WriteOnly))
 		{
@@ -100,17 +101,9 @@ namespace wg
 		}
 		else
 		{
-			m_pBlob = Blob::create(m_pitch*size.h + (pClut ? 4096 : 0) );
+			m_pBlob = Blob::create(m_pitch*size.h);
 			std::memset(m_pBlob->data(), 0, m_pitch*size.h);
 
-			if (pClut)
-			{
-				m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * size.h);
-				memcpy(m_pClut, pClut, 4096);
-			}
-			else
-				m_pClut = nullptr;
-
 			m_pAlphaLayer = nullptr;
 		}
 	}
@@ -123,7 +116,8 @@ namespace wg
 		m_size = size;
 		m_pitch = pitch;
 
-		m_inStreamId = _sendCreateSurface(size, format, flags, pClut);
+		_setClut(pClut);
+		m_inStreamId = _sendCreateSurface(size, format, flags);
 
 		if (m_pixelDescription.bits > 8 && (flags & SurfaceFlag::WriteOnly))
 		{
@@ -135,7 +129,6 @@ namespace wg
 		else
 		{
 			m_pBlob = pBlob;
-			m_pClut = const_cast<Color*>(pClut);
 			m_pAlphaLayer = nullptr;
 		}
 
@@ -150,12 +143,13 @@ namespace wg
 		m_size = size;
 		m_pitch = ((size.w + 3) & 0xFFFFFFFC)*m_pixelDescription.bits / 8;
 
-		m_inStreamId = _sendCreateSurface(size, format, flags, pClut);
+		_setClut(pClut);
+		m_inStreamId = _sendCreateSurface(size, format, flags);
 
 		// We always convert the data even if we throw it away, since we need to stream the converted data.
 		// (but we could optimize and skip conversion if format already is correct)
 
-		Blob_p pBlob = Blob::create(m_pitch*m_size.h + (pClut ? 4096 : 0) );
+		Blob_p pBlob = Blob::create(m_pitch*m_size.h);
 
 		m_pPixels = (uint8_t*)pBlob->data();	// Simulate a lock
 		_copyFrom(pPixelDescription == 0 ? &m_pixelDescription : pPixelDescription, pPixels, pitch, size, size);
@@ -175,14 +169,6 @@ namespace wg
 		{
 			m_pBlob = pBlob;
 
-			if (pClut)
-			{
-				m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * size.h);
-				memcpy(m_pClut, pClut, 4096);
-			}
-			else
-				m_pClut = nullptr;
-
 			m_pAlphaLayer = nullptr;
 		}
 
@@ -211,22 +197,15 @@ namespace wg
 		}
 		else
 		{
-			m_pBlob = Blob::create(m_pitch*m_size.h + (pOther->clut() ? 4096 : 0));
+			m_pBlob = Blob::create(m_pitch*m_size.h);
 
 			m_pPixels = (uint8_t*)m_pBlob->data();	// Simulate a lock
 			_copyFrom(&m_pixelDescription, pPixels, pitch, Rect(size), Rect(size));
 			m_pPixels = 0;
-
-			if (pOther->clut())
-			{
-				m_pClut = (Color*)((uint8_t*)m_pBlob->data() + m_pitch * m_size.h);
-				memcpy(m_pClut, pOther->clut(), 4096);
-			}
-			else
-				m_pClut = nullptr;
 		}
 
-		m_inStreamId = _sendCreateSurface(size, format, flags, pOther->clut());
+		_setClut(pOther->clut());
+		m_inStreamId = _sendCreateSurface(size, format, flags);
 
 		_sendPixels(size, pPixels, pitch);
 		pOther->unlock();
@@ -331,7 +310,7 @@ namespace wg
 		if (!m_pBlob && mode != AccessMode::WriteOnly)
 			return 0;
 
-		if( region.x + region.w > m_size.w || region.y + region.w > m_size.h || region.x < 0 || region.y < 0 )
+		if( region.x + region.w > m_size.w || region.y + region.h > m_size.h || region.x < 0 || region.y < 0 )
 			return 0;
 
 		if( m_pBlob )
@@ -354,7 +333,21 @@ namespace wg
 		if(m_accessMode ==  AccessMode::None )
 			return;
 
-		_sendPixels(m_lockRegion, m_pPixels, m_pitch);
+		// Only stream the parts of the locked region that have been modified.
+
+		_commitLockDirtyRects();
+
+		if( m_accessMode != AccessMode::ReadOnly )
+		{
+			int pixelBytes = m_pixelDescription.bits / 8;
+
+			for( const Rect * pRect = m_lockDirtyRects.begin() ; pRect != m_lockDirtyRects.end() ; pRect++ )
+			{
+				const uint8_t * pSource = m_pPixels + (pRect->y - m_lockRegion.y) * m_pitch + (pRect->x - m_lockRegion.x) * pixelBytes;
+				_sendPixels(*pRect, pSource, m_pitch);
+			}
+		}
+		m_lockDirtyRects.clear();
 
 		if (!m_pBlob)
 		{
@@ -424,6 +417,8 @@ namespace wg
 
 	bool StreamSurface::fill(Color col, const Rect& region)
 	{
+		markDirty(region);
+
 		// Stream the call
 
 		*m_pStream << GfxStream::Header{ GfxChunkId::FillSurface, 14 };
@@ -511,10 +506,12 @@ namespace wg
 
 	bool StreamSurface::copyFrom(Surface * pSrcSurf, const Rect& srcRect, Coord dst)
 	{
-		//TODO: Implement!!!
+		//TODO: Stream a CopySurface chunk when both are StreamSurfaces, as outlined below.
 
-		assert(false);
-		return true;
+		// Until then we copy through locks like any other surface, which streams
+		// the modified region when we unlock.
+
+		return Surface::copyFrom(pSrcSurf, srcRect, dst);
 /*
 		// First we update local data without streaming anything (no lock/unlock)
 
@@ -557,21 +554,20 @@ namespace wg
 
 	//____ _sendCreateSurface() _______________________________________________
 
-	short StreamSurface::_sendCreateSurface(Size size, PixelFormat format, int flags, const Color * pClut )
+	short StreamSurface::_sendCreateSurface(Size size, PixelFormat format, int flags )
 	{
 		uint16_t surfaceId = m_pStream->allocObjectId();
 
-		int blockSize = 10 + (pClut ? 4096 : 0);
+		// Palette goes first, unless already in the stream for another surface.
+
+		uint16_t paletteId = m_pPalette ? m_pStream->retainPalette(m_pPalette) : 0;
 
-		*m_pStream << GfxStream::Header{ GfxChunkId::CreateSurface, blockSize };
+		*m_pStream << GfxStream::Header{ GfxChunkId::CreateSurface, 12 };
 		*m_pStream << surfaceId;
 		*m_pStream << format;
 		*m_pStream << size;
 		*m_pStream << (uint16_t) flags;
-
-
-		if(pClut)
-			*m_pStream << GfxStream::DataChunk{ 4096, pClut };
+		*m_pStream << paletteId;
 
 		return surfaceId;
 	}
@@ -648,6 +644,9 @@ namespace wg
 	{
 		*m_pStream << GfxStream::Header{ GfxChunkId::DeleteSurface, 2 };
 		*m_pStream << m_inStreamId;
+
+		if (m_pPalette)
+			m_pStream->releasePalette(m_pPalette);
 	}
 
 } // namespace wg
@@ -97,7 +97,7 @@ namespace wg
 		StreamSurface( GfxOutStream& stream, Surface * pOther, int flags = SurfaceFlag::Static );
 		~StreamSurface();
 
-		short		_sendCreateSurface(Size size, PixelFormat format, int flags, const Color * pClut);
+		short		_sendCreateSurface(Size size, PixelFormat format, int flags);
 		void		_sendPixels(Rect rect, const uint8_t * pSource, int pitch);
 		void		_sendDeleteSurface();
 		uint8_t*	_genAlphaLayer(const char * pSource, int pitch);
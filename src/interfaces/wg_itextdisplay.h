@@ -69,6 +69,9 @@ namespace wg
 		inline int				replace( int ofs, int len, const CharSeq& seq ) { return m_pComponent->replace(ofs,len,seq); }
 		inline int				remove( int ofs, int len ) { return m_pComponent->remove(ofs,len); }
 
+		inline void				setMaxLines( int maxLines ) { m_pComponent->setMaxLines(maxLines); }
+		inline int				maxLines() const { return m_pComponent->maxLines(); }
+
 		//.____ Appearance _____________________________________________
 
 		inline void				setCharStyle( TextStyle * pStyle ) { m_pComponent->setCharStyle(pStyle); }
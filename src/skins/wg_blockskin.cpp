@@ -239,7 +239,10 @@ namespace wg
 		m_bOpaque = false;
 
 		for (int i = 0; i < StateEnum_Nb; i++)
+		{
 			m_stateColors[i] = Color::White;
+			m_bStateOpaque[i] = false;
+		}
 	}
 
 	BlockSkin::BlockSkin(Surface * pSurface, Rect block, Border frame)
@@ -254,6 +257,8 @@ namespace wg
 			m_stateBlocks[i] = block.pos();
 			m_stateColors[i] = Color::White;
 		}
+
+		_updateSectionInfo();
 	}
 
 
@@ -294,6 +299,7 @@ namespace wg
 
 		m_dimensions	= size;
 		m_frame			= frame;
+		_updateSectionInfo();
 		return true;
 	}
 
@@ -347,6 +353,7 @@ namespace wg
 		m_stateBlockMask = 1;
 
 		_updateUnsetStateBlocks();
+		_updateSectionInfo();
 	}
 
 	void BlockSkin::setBlock(State state, Coord ofs)
@@ -356,6 +363,7 @@ namespace wg
 		m_stateBlocks[i] = ofs;
 		m_stateBlockMask.setBit(i);
 		_updateUnsetStateBlocks();
+		_updateSectionInfo();
 	}
 
 	//____ setBlocks() ________________________________________________________
@@ -373,6 +381,7 @@ namespace wg
 			ofs++;
 		}
 		_updateUnsetStateBlocks();
+		_updateSectionInfo();
 	}
 
 	//____ block() ____________________________________________________________
@@ -438,7 +447,25 @@ namespace wg
 	void BlockSkin::setSurface(Surface * pSurf)
 	{
 		m_pSurface = pSurf;
-		_updateOpaqueFlags();
+		m_bDynamicSurface = false;
+		_updateSectionInfo();
+	}
+
+	//____ relocateSurface() __________________________________________________
+
+	bool BlockSkin::relocateSurface( Surface * pOld, Surface * pNew, Coord ofs )
+	{
+		if( m_pSurface != pOld || !pNew )
+			return false;
+
+		// Content of the blocks is unchanged, so section info stays valid.
+
+		m_pSurface = pNew;
+		m_surfaceStamp = pNew->contentStamp();
+		for( int i = 0; i < StateEnum_Nb; i++ )
+			m_stateBlocks[i] += ofs;
+
+		return true;
 	}
 
 	//____ setBlockSize() _____________________________________________________
@@ -446,6 +473,7 @@ namespace wg
 	void BlockSkin::setBlockSize(Size size)
 	{
 		m_dimensions = size;
+		_updateSectionInfo();
 	}
 
 	//____ setFrame() ____________________________________________________________
@@ -453,6 +481,7 @@ namespace wg
 	void BlockSkin::setFrame(Border frame)
 	{
 		m_frame = frame;
+		_updateSectionInfo();
 	}
 
 	//____ render() _______________________________________________________________
@@ -469,9 +498,12 @@ namespace wg
 			pDevice->setBlendMode(m_blendMode);
 		}
 
-		Coord blockOfs = m_stateBlocks[_stateToIndex(state)];
+		_checkSurfaceStamp();
+
+		int idx = _stateToIndex(state);
+		Coord blockOfs = m_stateBlocks[idx];
 		pDevice->setBlitSource(m_pSurface);
-		pDevice->blitNinePatch(_canvas, m_frame, { blockOfs,m_dimensions }, m_frame );
+		renderNinePatch(pDevice, _canvas, m_frame, { blockOfs,m_dimensions }, m_frame, m_stateSectionInfo[idx] );
 
 		if (m_blendMode != BlendMode::Undefined)
 			pDevice->setBlendMode(savedBlendMode);
@@ -574,17 +606,31 @@ namespace wg
 
 	bool BlockSkin::isOpaque() const
 	{
+		_checkSurfaceStamp();
 		return m_bOpaque;
 	}
 
 	bool BlockSkin::isOpaque( State state ) const
 	{
+		_checkSurfaceStamp();
 		return m_bStateOpaque[_stateToIndex(state)];
 	}
 
 	bool BlockSkin::isOpaque( const Rect& rect, const Size& canvasSize, State state ) const
 	{
-		return m_bStateOpaque[_stateToIndex(state)];
+		_checkSurfaceStamp();
+
+		int idx = _stateToIndex(state);
+
+		if( m_bStateOpaque[idx] )
+			return true;
+
+		// Opaque sections might still cover the rectangle, like the center of a block with rounded corners.
+
+		if( !m_pSurface || m_stateColors[idx].a != 255 || (m_blendMode != BlendMode::Blend && m_blendMode != BlendMode::Undefined) )
+			return false;
+
+		return isNinePatchOpaque( m_stateSectionInfo[idx].opaqueSections, rect, canvasSize, m_frame );
 	}
 
 	//____ isStateIdentical() _____________________________________________________
@@ -609,8 +655,18 @@ namespace wg
 			m_bOpaque = true;
 		else if (m_blendMode == BlendMode::Blend || m_blendMode == BlendMode::Undefined )		// Assumes that incoming BlendMide is Blend.
 		{
-			m_bOpaque = m_pSurface->isOpaque();
-			bTintDecides = m_bOpaque;
+			// Opaque if the blocks of all states are, no matter what the rest of the surface looks like.
+
+			m_bOpaque = true;
+			for (int i = 0; i < StateEnum_Nb; i++)
+			{
+				if ((m_stateSectionInfo[i].opaqueSections & 0x1FF) != 0x1FF)
+				{
+					m_bOpaque = false;
+					break;
+				}
+			}
+			bTintDecides = true;
 		}
 		else
 			m_bOpaque = false;
@@ -618,7 +674,7 @@ namespace wg
 		if (bTintDecides)
 		{
 			for (int i = 0; i < StateEnum_Nb; i++)
-				m_bStateOpaque[i] = m_stateColors[i].a == 255;
+				m_bStateOpaque[i] = (m_stateSectionInfo[i].opaqueSections & 0x1FF) == 0x1FF && m_stateColors[i].a == 255;
 		}
 		else
 		{
@@ -627,6 +683,42 @@ namespace wg
 		}
 	}
 
+	//____ _updateSectionInfo() ___________________________________________________
+
+	void BlockSkin::_updateSectionInfo()
+	{
+		for (int i = 0; i < StateEnum_Nb; i++)
+		{
+			// States often share blocks, so we only analyse each block once.
+
+			int j = 0;
+			while (j < i && m_stateBlocks[j] != m_stateBlocks[i])
+				j++;
+
+			if (j < i)
+				m_stateSectionInfo[i] = m_stateSectionInfo[j];
+			else
+				analyzeNinePatch(m_pSurface, { m_stateBlocks[i], m_dimensions }, m_frame, m_stateSectionInfo[i], !m_bDynamicSurface);
+		}
+
+		m_surfaceStamp = m_pSurface ? m_pSurface->contentStamp() : 0;
+		_updateOpaqueFlags();
+	}
+
+	//____ _checkSurfaceStamp() ___________________________________________________
+	// Section info is stale if our surface has been modified since it was analyzed.
+	// Such a surface is likely to be modified again, so from now on we don't read its pixels.
+
+	void BlockSkin::_checkSurfaceStamp() const
+	{
+		if( m_pSurface && m_pSurface->contentStamp() != m_surfaceStamp )
+		{
+			BlockSkin * p = const_cast<BlockSkin*>(this);
+			p->m_bDynamicSurface = true;
+			p->_updateSectionInfo();
+		}
+	}
+
 	//____ _updateUnsetStateBlocks() _______________________________________________
 
 	void BlockSkin::_updateUnsetStateBlocks()
@@ -25,6 +25,7 @@
 
 #include <wg_extendedskin.h>
 #include <wg_surface.h>
+#include <wg_util.h>
 
 namespace wg
 {
@@ -37,7 +38,6 @@ namespace wg
 	class BlockSkin : public ExtendedSkin
 	{
 		//TODO: Add sanity-checking to all Set-methods.
-		//TODO: Optimize rendering based on invisibleSections and opaqueSections!
 
 	public:
 
@@ -103,6 +103,8 @@ namespace wg
 
 		bool	isStateIdentical( State state, State comparedTo ) const override;
 
+		bool	relocateSurface( Surface * pOld, Surface * pNew, Coord ofs ) override;
+
 		//.____ Deprecated ____________________________________________________
 
 		static BlockSkin_p createStatic(Surface * pSurface, Rect block, Border frame = Border(0));
@@ -135,6 +137,8 @@ namespace wg
 		~BlockSkin() {};
 
 		void		_updateOpaqueFlags();
+		void		_updateSectionInfo();
+		void		_checkSurfaceStamp() const;
 		void		_updateUnsetStateBlocks();
 		void		_updateUnsetStateColors();
 
@@ -152,6 +156,10 @@ namespace wg
 		Coord	m_stateBlocks[StateEnum_Nb];
 		Color	m_stateColors[StateEnum_Nb];
 		bool	m_bStateOpaque[StateEnum_Nb];
+
+		Util::NinePatchInfo	m_stateSectionInfo[StateEnum_Nb];	// Content of the sections of each state's block.
+		uint32_t			m_surfaceStamp = 0;					// Content stamp of surface when section info was updated.
+		bool				m_bDynamicSurface = false;			// Surface has been modified after analysis, don't read its pixels.
 	};
 
 
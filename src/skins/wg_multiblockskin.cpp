@@ -99,17 +99,16 @@ namespace wg
 		layer.pSurface = pSurf;
 		layer.stateBlockMask = 1;               // Only normal state is set.
 
-		if (pSurf->isOpaque())
-			m_bIsOpaque = true;
-
-
 		for (int i = 0; i < StateEnum_Nb; i++)
 		{
 			layer.blockOfs[i] = ofs;
 			layer.tintColor[i] = Color::White;
+		}
+
+		_updateSectionInfo(layer);
 
+		for (int i = 0; i < StateEnum_Nb; i++)
 			_updateStateOpacity(i);
-		}
 
 
 		return (int) m_layers.size();
@@ -132,9 +131,6 @@ namespace wg
 		layer.pSurface = pSurf;
 		layer.stateBlockMask = 0;
 
-		if (pSurf->isOpaque())
-			m_bIsOpaque = true;
-
 		//
 
 		for (int i = 0; i < StateEnum_Nb; i++)
@@ -156,7 +152,7 @@ namespace wg
 
 		assert(layer.stateBlockMask.bit(0) == true);				// A block for state normal is required.
 
-		// Fill in fallback states and update opacity flag
+		// Fill in fallback states, analyze blocks and update opacity flag
 
 		for (int i = 0; i < StateEnum_Nb; i++)
 		{
@@ -165,9 +161,12 @@ namespace wg
 				int fallbackIndex = bestStateIndexMatch(i, layer.stateBlockMask);
 				layer.blockOfs[i] = layer.blockOfs[fallbackIndex];
 			}
+		}
+
+		_updateSectionInfo(layer);
 
+		for (int i = 0; i < StateEnum_Nb; i++)
 			_updateStateOpacity(i);
-		}
 
 		//
 
@@ -280,6 +279,8 @@ namespace wg
 
 		int stateIndex = _stateToIndex(state);
 
+		_checkSurfaceStamps();
+
 		BlendMode orgBlendMode = pDevice->blendMode();
 		Color		orgTintColor = pDevice->tintColor();
 
@@ -306,26 +307,12 @@ namespace wg
 
 			const Rect&	src = Rect(layer.blockOfs[stateIndex], m_blockSize);
 
-			// Shortcuts & optimizations for common special cases.
-
-			if (src.w == _canvas.w && src.h == _canvas.h /*&& scale == m_scale */)
-			{
-				pDevice->blit( _canvas.pos(), src );
-				continue;
-			}
-
-			if (m_frame.left + m_frame.top + m_frame.right + m_frame.bottom == 0)
-			{
-				pDevice->stretchBlit( _canvas, src );
-				continue;
-			}
-
 //			const Border&    sourceBorders = m_frame.scale(m_scale);
 //			const Border     canvasBorders = m_frame.scale(scale);
 			const Border&    sourceBorders = m_frame;
 			const Border     canvasBorders = m_frame;
 
-			pDevice->blitNinePatch( _canvas, canvasBorders, src, sourceBorders );
+			renderNinePatch( pDevice, _canvas, canvasBorders, src, sourceBorders, layer.sectionInfo[stateIndex] );
 		}
 
 		if (mixedTint != orgTintColor)
@@ -465,17 +452,35 @@ namespace wg
 
 	bool MultiBlockSkin::isOpaque() const
 	{
+		_checkSurfaceStamps();
 		return m_bIsOpaque;
 	}
 
 	bool MultiBlockSkin::isOpaque( State state ) const
 	{
-		return m_bIsOpaque;
+		_checkSurfaceStamps();
+		return m_bStateOpaque[_stateToIndex(state)];
 	}
 
 	bool MultiBlockSkin::isOpaque( const Rect& rect, const Size& canvasSize, State state ) const
 	{
-		return m_bIsOpaque;
+		_checkSurfaceStamps();
+
+		int idx = _stateToIndex(state);
+
+		if (m_bStateOpaque[idx])
+			return true;
+
+		// Any single layer with opaque sections covering the rectangle will do.
+
+		for (auto& layer : m_layers)
+		{
+			if (layer.blendMode == BlendMode::Blend && layer.tintColor[idx].a == 255 &&
+				isNinePatchOpaque(layer.sectionInfo[idx].opaqueSections, rect, canvasSize, m_frame))
+				return true;
+		}
+
+		return false;
 	}
 
 	//____ isStateIdentical() _____________________________________________________
@@ -494,6 +499,29 @@ namespace wg
 		return ExtendedSkin::isStateIdentical(state, comparedTo);
 	}
 
+	//____ relocateSurface() ______________________________________________________
+
+	bool MultiBlockSkin::relocateSurface( Surface * pOld, Surface * pNew, Coord ofs )
+	{
+		if( !pNew )
+			return false;
+
+		bool bRelocated = false;
+
+		for( auto& layer : m_layers )
+		{
+			if( layer.pSurface == pOld )
+			{
+				layer.pSurface = pNew;
+				layer.surfaceStamp = pNew->contentStamp();
+				for( int i = 0; i < StateEnum_Nb; i++ )
+					layer.blockOfs[i] += ofs;
+				bRelocated = true;
+			}
+		}
+		return bRelocated;
+	}
+
 	//____ _updateStateOpacity() __________________________________________________
 
 	void MultiBlockSkin::_updateStateOpacity(int stateIdx)
@@ -502,7 +530,7 @@ namespace wg
 
 		for (auto& layer : m_layers)
 		{
-			if (layer.blendMode == BlendMode::Replace || (layer.blendMode == BlendMode::Blend && layer.pSurface->isOpaque() && layer.tintColor[stateIdx].a == 255) )
+			if (_isLayerOpaque(layer, stateIdx))
 			{
 				bOpaque = true;
 				break;
@@ -513,17 +541,72 @@ namespace wg
 		{
 			m_bStateOpaque[stateIdx] = bOpaque;
 
-			if (bOpaque != m_bIsOpaque)
+			m_bIsOpaque = true;
+			for( int i = 0 ; i < StateEnum_Nb ; i++ )
+				if (!m_bStateOpaque[i] )
+				{
+					m_bIsOpaque = false;
+					break;
+				}
+		}
+	}
+
+	//____ _isLayerOpaque() _______________________________________________________
+
+	bool MultiBlockSkin::_isLayerOpaque(const LayerData& layer, int stateIdx) const
+	{
+		if (layer.blendMode == BlendMode::Replace)
+			return true;
+
+		return layer.blendMode == BlendMode::Blend && layer.tintColor[stateIdx].a == 255 &&
+				(layer.sectionInfo[stateIdx].opaqueSections & 0x1FF) == 0x1FF;
+	}
+
+	//____ _updateSectionInfo() ___________________________________________________
+
+	void MultiBlockSkin::_updateSectionInfo(LayerData& layer)
+	{
+		for (int i = 0; i < StateEnum_Nb; i++)
+		{
+			// States often share blocks, so we only analyse each block once.
+
+			int j = 0;
+			while (j < i && layer.blockOfs[j] != layer.blockOfs[i])
+				j++;
+
+			if (j < i)
+				layer.sectionInfo[i] = layer.sectionInfo[j];
+			else
+				analyzeNinePatch(layer.pSurface, { layer.blockOfs[i], m_blockSize }, m_frame, layer.sectionInfo[i], !layer.bDynamicSurface);
+		}
+
+		layer.surfaceStamp = layer.pSurface ? layer.pSurface->contentStamp() : 0;
+	}
+
+	//____ _checkSurfaceStamps() __________________________________________________
+	// Section info of a layer is stale if its surface has been modified since it was analyzed.
+	// Such a surface is likely to be modified again, so from now on we don't read its pixels.
+
+	void MultiBlockSkin::_checkSurfaceStamps() const
+	{
+		MultiBlockSkin * p = const_cast<MultiBlockSkin*>(this);
+		bool bChanged = false;
+
+		for( auto& layer : p->m_layers )
+		{
+			if( layer.pSurface && layer.pSurface->contentStamp() != layer.surfaceStamp )
 			{
-				m_bIsOpaque = true;
-				for( int i = 0 ; i < StateEnum_Nb ; i++ )
-					if (m_bStateOpaque[i] )
-					{
-						m_bIsOpaque = false;
-						break;
-					}
+				layer.bDynamicSurface = true;
+				p->_updateSectionInfo(layer);
+				bChanged = true;
 			}
 		}
+
+		if( bChanged )
+		{
+			for( int i = 0; i < StateEnum_Nb; i++ )
+				p->_updateStateOpacity(i);
+		}
 	}
 
 }
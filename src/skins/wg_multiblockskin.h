@@ -25,6 +25,7 @@
 
 #include <wg_extendedskin.h>
 #include <wg_surface.h>
+#include <wg_util.h>
 
 #include <initializer_list>
 #include <utility>
@@ -41,7 +42,6 @@ namespace wg
 	class MultiBlockSkin : public ExtendedSkin
 	{
 		//TODO: Add sanity-checking to all Set-methods.
-		//TODO: Optimize rendering based on invisibleSections and opaqueSections!
 
 	public:
 
@@ -88,6 +88,8 @@ namespace wg
 
 		bool	isStateIdentical( State state, State comparedTo ) const override;
 
+		bool	relocateSurface( Surface * pOld, Surface * pNew, Coord ofs ) override;
+
 	private:
 
 		struct LayerData
@@ -99,6 +101,9 @@ namespace wg
 
 			Coord				blockOfs[StateEnum_Nb];		// Block for each state
 			Color				tintColor[StateEnum_Nb];
+			Util::NinePatchInfo	sectionInfo[StateEnum_Nb];	// Content of the sections of each state's block.
+			uint32_t			surfaceStamp = 0;			// Content stamp of surface when section info was updated.
+			bool				bDynamicSurface = false;	// Surface has been modified after analysis, don't read its pixels.
 	//		Origo			placementOrigo;
 	//		Coord			placementOfs;
 	//		Size			dimensions;                   // Stored in pixels
@@ -110,6 +115,9 @@ namespace wg
 		~MultiBlockSkin() {};
 
 		void			_updateStateOpacity( int stateIdx );
+		void			_updateSectionInfo( LayerData& layer );
+		void			_checkSurfaceStamps() const;
+		bool			_isLayerOpaque( const LayerData& layer, int stateIdx ) const;
 
 		Size			m_blockSizePoints;					// Stored in pixels
 
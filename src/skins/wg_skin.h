@@ -32,6 +32,7 @@ namespace wg
 
 	class Skin;
 	class GfxDevice;
+	class Surface;
 
 	typedef	StrongPtr<Skin>	Skin_p;
 
@@ -73,6 +74,10 @@ namespace wg
 
 		virtual bool	isStateIdentical( State state, State comparedTo ) const = 0;
 
+		/// @brief Switch to a copy of the graphics placed at ofs in another surface, like a SurfaceAtlas page.
+		/// @return True if the skin used pOld and now uses pNew.
+		virtual bool	relocateSurface( Surface * pOld, Surface * pNew, Coord ofs ) { return false; }
+
 	protected:
 		Skin() {};
 	};
@@ -26,8 +26,11 @@
 #include <wg_gfxdevice.h>
 #include <wg_char.h>
 #include <wg_msgrouter.h>
+#include <wg_scheduler.h>
+#include <wg_trace.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
 
 namespace wg
@@ -38,19 +41,23 @@ namespace wg
 	//____ Constructor _____________________________________________________________
 
 	StdTextMapper::StdTextMapper() : m_alignment(Origo::NorthWest), m_bLineWrap(false), m_selectionBackColor(Color::White), m_selectionBackRenderMode(BlendMode::Invert),
-		m_selectionCharColor(Color::White), m_selectionCharBlend(BlendMode::Invert), m_pFocusedComponent(nullptr), m_tickRouteId(0)
+		m_selectionCharColor(Color::White), m_selectionCharBlend(BlendMode::Invert), m_pFocusedComponent(nullptr), m_caretTask(0)
 	{
+		for( int i = 0 ; i < c_glyphRunCacheSize ; i++ )
+			m_glyphRunCache[i] = nullptr;
 	}
 
 	//____ Destructor ______________________________________________________________
 
 	StdTextMapper::~StdTextMapper()
 	{
-		if( m_tickRouteId )
+		if( m_caretTask )
 		{
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;
+			Base::scheduler()->removeTask( m_caretTask );
+			m_caretTask = 0;
 		}
+
+		clearGlyphRunCache();
 	}
 
 
@@ -104,8 +111,8 @@ namespace wg
 		if( pText == m_pFocusedComponent )
 		{
 			m_pFocusedComponent = 0;
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;
+			Base::scheduler()->removeTask( m_caretTask );
+			m_caretTask = 0;
 		}
 	}
 
@@ -146,6 +153,24 @@ namespace wg
 		}
 	}
 
+	//____ clearGlyphRunCache() ____________________________________________________
+	/**
+	 * Releases all cached glyph runs.
+	 *
+	 * Glyphs and kerning of text that has been measured or rendered are cached per font and size
+	 * and reused as long as the characters are the same. The cache needs to be cleared if a font
+	 * used by the texts changes the metrics of its glyphs, for example by a change of render mode.
+	 */
+
+	void StdTextMapper::clearGlyphRunCache()
+	{
+		for( int i = 0 ; i < c_glyphRunCacheSize ; i++ )
+		{
+			delete m_glyphRunCache[i];
+			m_glyphRunCache[i] = nullptr;
+		}
+	}
+
 	//____ setSelectionBackColor() _________________________________________________
 
 	void StdTextMapper::setSelectionBack(Color color, BlendMode renderMode )
@@ -317,6 +342,7 @@ namespace wg
 
 		Glyph_p	pGlyph;
 		Glyph_p	pPrevGlyph =  0;
+		GlyphRunCursor	runs( this, baseAttr, state );
 		const Char * pChar = pFirst;
 
 		int distance = 0;
@@ -340,14 +366,16 @@ namespace wg
 					pFont->setSize(attr.size);
 					pPrevGlyph = 0;								// No kerning against across different fonts or characters of different size.
 				}
+
+				hStyle = pChar->styleHandle();
 			}
 
-			pGlyph = _getGlyph( pFont.rawPtr(), pChar->code() );
+			pGlyph = runs.glyph( pChar, pFont.rawPtr(), attr.size );
 
 			if( pGlyph )
 			{
 				if( pPrevGlyph )
-					distance += pFont->kerning(pPrevGlyph, pGlyph);
+					distance += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				if( pChar != pLast )
 					distance += pGlyph->advance();				// Do not advance for last, just apply kerning.
@@ -362,19 +390,102 @@ namespace wg
 		return distance;
 	}
 
-	//____ receive() ___________________________________________________________
+	//____ _glyphRun() _________________________________________________________
+
+	// Returns glyphs and kerning for the characters from pChars that use the given font and size,
+	// up to and including the end of the line. The run is taken from the cache if we have it there,
+	// otherwise glyphs are looked up from the font and the cache slot is replaced.
+
+	const StdTextMapper::GlyphRun * StdTextMapper::_glyphRun( const Char * pChars, Font * pFont, int size, const TextAttr& baseAttr, State state ) const
+	{
+		// Find end of run and calculate its hash.
+
+		uint32_t hash = 2166136261U;
+		hash = (hash ^ (uint32_t) (uintptr_t) pFont) * 16777619U;
+		hash = (hash ^ (uint32_t) size) * 16777619U;
+
+		TextStyle_h	hStyle = pChars->styleHandle();
+		const Char * p = pChars;
+
+		while( p - pChars < c_maxGlyphRunLength )
+		{
+			if( p->styleHandle() != hStyle )
+			{
+				hStyle = p->styleHandle();
+
+				TextAttr attr = baseAttr;
+				if( hStyle != 0 )
+					p->stylePtr()->addToAttr( state, &attr );
+
+				if( attr.pFont.rawPtr() != pFont || attr.size != size )
+					break;
+			}
+
+			hash = (hash ^ p->code()) * 16777619U;
+
+			if( p++->isEndOfLine() )
+				break;
+		}
+
+		int nChars = int(p - pChars);
+
+		// Check the cache
+
+		GlyphRun *& pSlot = m_glyphRunCache[hash & (c_glyphRunCacheSize-1)];
+
+		if( pSlot && pSlot->hash == hash && pSlot->pFont.rawPtr() == pFont && pSlot->size == size && (int) pSlot->codes.size() == nChars )
+		{
+			int i = 0;
+			while( i < nChars && pSlot->codes[i] == pChars[i].code() )
+				i++;
+
+			if( i == nChars )
+				return pSlot;
+		}
+
+		// Not in cache, get glyphs and kerning from the font.
+
+		if( !pSlot )
+			pSlot = new GlyphRun();
+
+		GlyphRun * pRun = pSlot;
+		pRun->pFont = pFont;
+		pRun->size = size;
+		pRun->hash = hash;
+		pRun->codes.resize(nChars);
+		pRun->glyphs.resize(nChars);
+		pRun->kerning.resize(nChars);
+
+		pFont->setSize(size);
+
+		Glyph_p pPrevGlyph = nullptr;
+		for( int i = 0 ; i < nChars ; i++ )
+		{
+			uint16_t code = pChars[i].code();
+			Glyph_p pGlyph = _getGlyph( pFont, code );
+
+			pRun->codes[i] = code;
+			pRun->glyphs[i] = pGlyph;
+			pRun->kerning[i] = (pGlyph && pPrevGlyph) ? pFont->kerning( pPrevGlyph, pGlyph ) : 0;
+
+			pPrevGlyph = pGlyph;
+		}
+
+		return pRun;
+	}
+
+	//____ _caretTick() ________________________________________________________
+	// Scheduler task animating the caret. Runs every tick while a component is focused.
 
-	void StdTextMapper::receive( Msg * pMsg )
+	int StdTextMapper::_caretTick( int ms )
 	{
-		if( pMsg->type() == MsgType::Tick && m_pFocusedComponent )
+		if( m_pFocusedComponent )
 		{
 			const EditState * pEditState = m_pFocusedComponent->_editState();
 
 			Caret * pCaret = m_pCaret ? m_pCaret : Base::defaultCaret();
 			if( pEditState && pEditState->bCaret && pCaret )
 			{
-				int ms = static_cast<TickMsg*>(pMsg)->timediff();
-
 				bool bDirty = pCaret->tick( ms );
 				if( bDirty )
 				{
@@ -382,6 +493,7 @@ namespace wg
 				}
 			}
 		}
+		return 0;
 	}
 
 	//____ _render()___________________________________________________________
@@ -403,6 +515,7 @@ namespace wg
 		TextAttr		attr;
 		Font_p 			pFont;
 		TextStyle_h		hStyle = 0xFFFF;
+		GlyphRunCursor	runs( this, baseAttr, _state(pText) );
 
 		Color	baseTint = pDevice->tintColor();
 		Color	localTint = Color::White;
@@ -494,6 +607,8 @@ namespace wg
 							localTint = attr.color;
 							bRecalcColor = true;
 						}
+
+						hStyle = pChar->styleHandle();
 					}
 
 					//
@@ -521,12 +636,12 @@ namespace wg
 
 					//
 
-					pGlyph = _getGlyph( pFont.rawPtr(), pChar->code());
+					pGlyph = runs.glyph( pChar, pFont.rawPtr(), attr.size );
 
 					if( pGlyph )
 					{
 						if( pPrevGlyph )
-							pos.x += pFont->kerning(pPrevGlyph, pGlyph);
+							pos.x += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 						const GlyphBitmap * pBitmap = pGlyph->getBitmap();
 						pDevice->setBlitSource(pBitmap->pSurface);
@@ -722,13 +837,103 @@ namespace wg
 
 	void StdTextMapper::onTextModified( CText * pText, int ofs, int charsRemoved, int charsAdded )
 	{
+		// Appending text and removing whole lines from the front are common for logs
+		// and can be handled without laying out the whole text again.
+
+		if( _dataBlock(pText) && !m_bLineWrap )
+		{
+			if( charsRemoved == 0 && charsAdded > 0 && ofs + charsAdded == _charBuffer(pText)->length() )
+			{
+				_onTextAppended( pText, charsAdded );
+				return;
+			}
+
+			if( ofs == 0 && charsAdded == 0 && charsRemoved > 0 && _onLinesRemovedFromFront( pText, charsRemoved ) )
+				return;
+		}
+
 		onRefresh(pText);
 	}
 
+	//____ _onTextAppended() _____________________________________________________
+	//
+	// Updates line info for text appended to the end, only laying out the last line
+	// and the new ones.
+
+	void StdTextMapper::_onTextAppended( CText * pText, int charsAdded )
+	{
+		CharBuffer * pBuffer = _charBuffer(pText);
+
+		int firstLine = _header(_dataBlock(pText))->nbLines - 1;
+		int nLines = firstLine + 1;
+
+		const Char * pChar = pBuffer->chars() + pBuffer->length() - charsAdded;
+		const Char * pEnd = pBuffer->chars() + pBuffer->length();
+		while( pChar != pEnd )
+		{
+			if( pChar->code() == '\n' )
+				nLines++;
+			pChar++;
+		}
+
+		void * pBlock = _reallocBlock(pText, nLines);
+		_updateLineInfo( pText, pBlock, pBuffer, firstLine );
+
+		// Only the modified last line and the new lines need to be rerendered,
+		// unless the text is aligned to anything but the top.
+
+		if( _textPosY( _header(pBlock), pText->size().h ) == 0 )
+		{
+			int y = _linePosY( pBlock, firstLine, pText->size().h );
+			_setComponentDirty( pText, Rect( 0, y, pText->size().w, pText->size().h - y ) );
+		}
+		else
+			_setComponentDirty( pText );
+	}
+
+	//____ _onLinesRemovedFromFront() ____________________________________________
+	//
+	// Updates line info for whole lines removed from the beginning of the text by just
+	// dropping their info. Returns false if the removal didn't end on a line break.
+
+	bool StdTextMapper::_onLinesRemovedFromFront( CText * pText, int charsRemoved )
+	{
+		void * pBlock = _dataBlock(pText);
+		BlockHeader * pHeader = _header(pBlock);
+		LineInfo * pLines = _lineInfo(pBlock);
+
+		int nDropped = 0;
+		int nChars = 0;
+		while( nChars < charsRemoved && nDropped < pHeader->nbLines - 1 )
+			nChars += pLines[nDropped++].length;
+
+		if( nChars != charsRemoved )
+			return false;
+
+		pHeader->nbLines -= nDropped;
+		memmove( pLines, pLines + nDropped, sizeof(LineInfo)*pHeader->nbLines );
+
+		Size size;
+		for( int i = 0 ; i < pHeader->nbLines ; i++ )
+		{
+			pLines[i].offset -= charsRemoved;
+
+			if( pLines[i].width > size.w )
+				size.w = pLines[i].width;
+			size.h += i == pHeader->nbLines - 1 ? pLines[i].height : pLines[i].spacing;
+		}
+
+		_updateTextSize( pText, size );
+		_setComponentDirty( pText );
+		return true;
+	}
+
 	//____ onResized() ___________________________________________________________
 
 	void StdTextMapper::onResized( CText * pText, Size newSize, Size oldSize )
 	{
+		WG_TRACE_SCOPE("StdTextMapper::onResized");
+
 		if (m_bLineWrap)
 			onRefresh(pText);
 
@@ -747,16 +952,16 @@ namespace wg
 			if( newState.isFocused() )
 			{
 				m_pFocusedComponent = pText;
-				if( !m_tickRouteId )
-					m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+				if( !m_caretTask )
+					m_caretTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _caretTick(timediff); } );
 			}
 			else
 			{
 				m_pFocusedComponent = 0;
-				if( m_tickRouteId )
+				if( m_caretTask )
 				{
-					Base::msgRouter()->deleteRoute( m_tickRouteId );
-					m_tickRouteId = 0;
+					Base::scheduler()->removeTask( m_caretTask );
+					m_caretTask = 0;
 				}
 			}
 		}
@@ -1074,6 +1279,7 @@ namespace wg
 
 		Glyph_p	pGlyph = nullptr;
 		Glyph_p	pPrevGlyph = nullptr;
+		GlyphRunCursor	runs( this, baseAttr, state );
 
 		int spaceAdv = 0;
 		int width = 0;
@@ -1116,17 +1322,18 @@ namespace wg
 				else
 					eolCaretWidth = 0;
 
+				hCharStyle = pChars->styleHandle();
 			}
 
 			// TODO: Include handling of special characters
 			// TODO: Support sub/superscript.
 
-			pGlyph = _getGlyph(pFont.rawPtr(), pChars->code());
+			pGlyph = runs.glyph( pChars, pFont.rawPtr(), attr.size );
 
 			if (pGlyph)
 			{
 				if (pPrevGlyph)
-					width += pFont->kerning(pPrevGlyph, pGlyph);
+					width += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				potentialWidth += pGlyph->advance();
 				width = potentialWidth;
@@ -1209,6 +1416,7 @@ namespace wg
 
 		Glyph_p	pGlyph = nullptr;
 		Glyph_p	pPrevGlyph = nullptr;
+		GlyphRunCursor	runs( this, baseAttr, state );
 
 		int maxAscend = 0;
 		int maxDescend = 0;
@@ -1273,12 +1481,12 @@ namespace wg
 			// TODO: Include handling of special characters
 			// TODO: Support sub/superscript.
 
-			pGlyph = _getGlyph(pFont.rawPtr(), pChars->code());
+			pGlyph = runs.glyph( pChars, pFont.rawPtr(), attr.size );
 
 			if (pGlyph)
 			{
 				if (pPrevGlyph)
-					width += pFont->kerning(pPrevGlyph, pGlyph);
+					width += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				potentialWidth += pGlyph->advance();
 				width = potentialWidth;
@@ -1392,11 +1600,9 @@ namespace wg
 
 	void * StdTextMapper::_reallocBlock( CText* pText, int nLines )
 	{
-		void * pBlock = _dataBlock(pText);
-		if( pBlock )
-			free( pBlock );
+		// Content is kept, so line info can be updated incrementally.
 
-		pBlock = malloc( sizeof(BlockHeader) + sizeof(LineInfo)*nLines);
+		void * pBlock = realloc( _dataBlock(pText), sizeof(BlockHeader) + sizeof(LineInfo)*nLines );
 		_setComponentDataBlock(pText, pBlock);
 		((BlockHeader *)pBlock)->nbLines = nLines;
 
@@ -1406,8 +1612,10 @@ namespace wg
 
 	//____ _updateLineInfo() _______________________________________________________
 
-	void StdTextMapper::_updateLineInfo( CText * pText, void * pBlock, const CharBuffer * pBuffer )
+	void StdTextMapper::_updateLineInfo( CText * pText, void * pBlock, const CharBuffer * pBuffer, int firstLine )
 	{
+		WG_TRACE_SCOPE("StdTextMapper::_updateLineInfo");
+
 		BlockHeader * pHeader = _header(_dataBlock(pText));
 		Size preferredSize;
 
@@ -1421,7 +1629,7 @@ namespace wg
 		}
 		else
 		{
-			preferredSize = _updateFixedLineInfo(_header(pBlock), _lineInfo(pBlock), pBuffer, _baseStyle(pText), _state(pText));
+			preferredSize = _updateFixedLineInfo(_header(pBlock), _lineInfo(pBlock), pBuffer, _baseStyle(pText), _state(pText), firstLine);
 			pHeader->textSize = preferredSize;
 		}
 
@@ -1433,6 +1641,21 @@ namespace wg
 		}
 	}
 
+	//____ _updateTextSize() _____________________________________________________
+
+	void StdTextMapper::_updateTextSize( CText * pText, Size preferredSize )
+	{
+		BlockHeader * pHeader = _header(_dataBlock(pText));
+
+		pHeader->textSize = preferredSize;
+
+		if (preferredSize != pHeader->preferredSize)
+		{
+			pHeader->preferredSize = preferredSize;
+			_requestComponentResize(pText);
+		}
+	}
+
 	//____ _updateWrapLineInfo() ________________________________________________
 
 	Size StdTextMapper::_updateWrapLineInfo(BlockHeader * pHeader, LineInfo * pLines, const CharBuffer * pBuffer, const TextStyle * pBaseStyle, State state, int maxLineWidth )
@@ -1452,6 +1675,7 @@ namespace wg
 
 		Glyph_p	pGlyph = nullptr;
 		Glyph_p	pPrevGlyph = nullptr;
+		GlyphRunCursor	runs( this, baseAttr, state );
 
 		int maxAscend = 0;
 		int maxDescend = 0;
@@ -1518,12 +1742,12 @@ namespace wg
 			// TODO: Include handling of special characters
 			// TODO: Support sub/superscript.
 
-			pGlyph = _getGlyph(pFont.rawPtr(), pChars->code());
+			pGlyph = runs.glyph( pChars, pFont.rawPtr(), attr.size );
 
 			if (pGlyph)
 			{
 				if (pPrevGlyph)
-					width += pFont->kerning(pPrevGlyph, pGlyph);
+					width += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				potentialWidth += pGlyph->advance();
 				width = potentialWidth;
@@ -1664,13 +1888,24 @@ namespace wg
 	//____ _updateFixedLineInfo() ________________________________________________
 
 	Size StdTextMapper::_updateFixedLineInfo( BlockHeader * pHeader, LineInfo * pLines, const CharBuffer * pBuffer, const TextStyle * pBaseStyle,
-												State state )
+												State state, int firstLine )
 	{
 		Caret * pCaret = m_pCaret ? m_pCaret : Base::defaultCaret();
-		const Char * pChars = pBuffer->chars();
 
 		Size		size;
 
+		// Lines before firstLine are kept as they are, we just include them in the size.
+
+		for( int i = 0 ; i < firstLine ; i++ )
+		{
+			if( pLines->width > size.w )
+				size.w = pLines->width;
+			size.h += pLines->spacing;
+			pLines++;
+		}
+
+		const Char * pChars = pBuffer->chars() + (firstLine > 0 ? pLines->offset : 0);
+
 		TextAttr		baseAttr;
 		pBaseStyle->exportAttr( state, &baseAttr );
 
@@ -1681,6 +1916,7 @@ namespace wg
 
 		Glyph_p	pGlyph = nullptr;
 		Glyph_p	pPrevGlyph = nullptr;
+		GlyphRunCursor	runs( this, baseAttr, state );
 
 		int maxAscend = 0;
 		int maxDescend = 0;
@@ -1730,12 +1966,12 @@ namespace wg
 			// TODO: Include handling of special characters
 			// TODO: Support sub/superscript.
 
-			pGlyph = _getGlyph( pFont.rawPtr(), pChars->code() );
+			pGlyph = runs.glyph( pChars, pFont.rawPtr(), attr.size );
 
 			if( pGlyph )
 			{
 				if( pPrevGlyph )
-					width += pFont->kerning(pPrevGlyph, pGlyph);
+					width += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				width += pGlyph->advance();
 			}
@@ -2005,6 +2241,7 @@ namespace wg
 
 		Glyph_p	pGlyph;
 		Glyph_p	pPrevGlyph =  0;
+		GlyphRunCursor	runs( this, baseAttr, state );
 
 		const Char * pChar = pTextBegin + pLine->offset;
 
@@ -2026,17 +2263,19 @@ namespace wg
 					pFont->setSize(attr.size);
 					pPrevGlyph = 0;								// No kerning against across different fonts or characters of different size.
 				}
+
+				hStyle = pChar->styleHandle();
 			}
 
 			// Forward distance with the glyph
 
-			pGlyph = _getGlyph( pFont.rawPtr(), pChar->code() );
+			pGlyph = runs.glyph( pChar, pFont.rawPtr(), attr.size );
 			int pCharBeg = distance;
 
 			if( pGlyph )
 			{
 				if( pPrevGlyph )
-					distance += pFont->kerning(pPrevGlyph, pGlyph);
+					distance += runs.kerning( pFont.rawPtr(), pPrevGlyph );
 
 				distance += pGlyph->advance();
 			}
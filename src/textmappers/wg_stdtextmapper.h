@@ -28,6 +28,8 @@
 #include <wg_textstyle.h>
 #include <wg_caret.h>
 
+#include <vector>
+
 namespace wg
 {
 
@@ -63,6 +65,8 @@ namespace wg
 		void			setCaret( Caret * pCaret );
 		Caret_p			caret() const { return m_pCaret; }
 
+		void			clearGlyphRunCache();
+
 		//.____ Appearance _________________________________________________
 
 		void			setSelectionBack(Color color, BlendMode renderMode = BlendMode::Replace );
@@ -101,7 +105,6 @@ namespace wg
 		virtual int		wordEnd( const CText * pText, int charOfs ) const;
 
 
-		virtual void 	receive( Msg * pMsg );
 		virtual void 	render( CText * pText, GfxDevice * pDevice, const Rect& canvas );
 
 		virtual void	caretMove( CText * pText, int newOfs );
@@ -143,6 +146,7 @@ namespace wg
 		StdTextMapper();
 		virtual ~StdTextMapper();
 
+		int				_caretTick( int ms );
 
 		struct BlockHeader
 		{
@@ -163,6 +167,43 @@ namespace wg
 
 		inline Glyph_p	_getGlyph( Font * pFont, uint16_t charCode ) const;
 
+		// Glyphs and kerning for a run of characters using the same font and size, up to and including
+		// the end of the line. Runs are cached, so measuring and rendering the same text again
+		// doesn't need to look up every glyph and kerning pair from the font.
+
+		struct GlyphRun
+		{
+			Font_p					pFont;
+			int						size;
+			uint32_t				hash;			// Hash of font, size and character codes.
+			std::vector<uint16_t>	codes;
+			std::vector<Glyph_p>	glyphs;
+			std::vector<int>		kerning;		// Kerning against previous glyph in run.
+		};
+
+		const GlyphRun * _glyphRun( const Char * pChars, Font * pFont, int size, const TextAttr& baseAttr, State state ) const;
+
+		// Steps through the glyph runs for characters visited in order, fetching a new run from the
+		// cache when we leave the current one.
+
+		class GlyphRunCursor
+		{
+		public:
+			GlyphRunCursor( const StdTextMapper * pMapper, const TextAttr& baseAttr, State state )
+				: m_pMapper(pMapper), m_baseAttr(baseAttr), m_state(state), m_pRun(nullptr), m_pRunBeg(nullptr), m_ofs(0) {}
+
+			inline Glyph_p	glyph( const Char * pChar, Font * pFont, int size );
+			inline int		kerning( Font * pFont, Glyph_p pPrevGlyph ) const;		// Kerning for glyph of last call to glyph().
+
+		private:
+			const StdTextMapper *	m_pMapper;
+			const TextAttr&			m_baseAttr;
+			State					m_state;
+			const GlyphRun *		m_pRun;
+			const Char *			m_pRunBeg;
+			int						m_ofs;
+		};
+
 		int				_countLines( CText * pText, const CharBuffer * pBuffer ) const;
 
 		int				_countFixedLines(const CharBuffer * pBuffer) const;
@@ -171,9 +212,12 @@ namespace wg
 
 		void *			_reallocBlock( CText * pText, int lines );
 
-		void			_updateLineInfo(CText * pText, void * pBlock, const CharBuffer * pBuffer );
+		void			_updateLineInfo(CText * pText, void * pBlock, const CharBuffer * pBuffer, int firstLine = 0 );
+		void			_onTextAppended( CText * pText, int charsAdded );
+		bool			_onLinesRemovedFromFront( CText * pText, int charsRemoved );
+		void			_updateTextSize( CText * pText, Size preferredSize );
 
-		Size			_updateFixedLineInfo(BlockHeader * pHeader, LineInfo * pLines, const CharBuffer * pBuffer, const TextStyle * pBaseStyle, State state);
+		Size			_updateFixedLineInfo(BlockHeader * pHeader, LineInfo * pLines, const CharBuffer * pBuffer, const TextStyle * pBaseStyle, State state, int firstLine = 0);
 		Size			_updateWrapLineInfo(BlockHeader * pHeader, LineInfo * pLines, const CharBuffer * pBuffer, const TextStyle * pBaseStyle, State state, int maxLineWidth);
 
 
@@ -217,7 +261,12 @@ namespace wg
 
 
 		CText *	m_pFocusedComponent;
-		RouteId			m_tickRouteId;
+		TaskId			m_caretTask;
+
+		const static int	c_glyphRunCacheSize = 256;		// Must be a power of two.
+		const static int	c_maxGlyphRunLength = 1024;
+
+		mutable GlyphRun *	m_glyphRunCache[c_glyphRunCacheSize];
 	};
 
 
@@ -242,5 +291,27 @@ inline Glyph_p	StdTextMapper::_getGlyph( Font * pFont, uint16_t charCode ) const
 }
 
 
+inline Glyph_p StdTextMapper::GlyphRunCursor::glyph( const Char * pChar, Font * pFont, int size )
+{
+	if( !m_pRun || pChar < m_pRunBeg || pChar >= m_pRunBeg + m_pRun->codes.size() || m_pRun->pFont.rawPtr() != pFont || m_pRun->size != size )
+	{
+		m_pRun = m_pMapper->_glyphRun( pChar, pFont, size, m_baseAttr, m_state );
+		m_pRunBeg = pChar;
+	}
+
+	m_ofs = int(pChar - m_pRunBeg);
+	return m_pRun->glyphs[m_ofs];
+}
+
+inline int StdTextMapper::GlyphRunCursor::kerning( Font * pFont, Glyph_p pPrevGlyph ) const
+{
+	// Previous glyph is only in our run if we are not at its beginning.
+
+	if( m_ofs > 0 )
+		return m_pRun->kerning[m_ofs];
+
+	return pFont->kerning( pPrevGlyph, m_pRun->glyphs[0] );
+}
+
 } // namespace wg
 #endif //WG_STDTEXTMAPPER_DOT_H
@@ -29,7 +29,7 @@
 #include <wg_geo.h>
 #include <wg_string.h>
 #include <wg_key.h>
-#include <wg_receiver.h>
+#include <wg_object.h>
 
 namespace wg
 {
@@ -44,7 +44,7 @@ namespace wg
 	typedef	StrongPtr<TextMapper>	TextMapper_p;
 	typedef	WeakPtr<TextMapper>	TextMapper_wp;
 
-	class TextMapper : public Receiver
+	class TextMapper : public Object
 	{
 	public:
 		//.____ Identification __________________________________________
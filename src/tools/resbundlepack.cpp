@@ -0,0 +1,335 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+// Packs PNG images, colors and bitmap fonts into a ResBundle, optionally comparing
+// the time it takes to get the surfaces from the bundle against decoding the PNGs.
+//
+// Usage: resbundlepack [-bench] output.wgrb item...
+//
+// Items:
+//		surface:<id>=<file.png>[@<PixelFormat>]		Default format is BGRA_8.
+//		color:<id>=<AARRGGBB>
+//		font:<id>=<surface id>@<glyph spec file>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <png.h>
+
+#include <wg_base.h>
+#include <wg_resbundle.h>
+#include <wg_enumextras.h>
+#include <wg_util.h>
+#include <wg_softsurface.h>
+#include <wg_softsurfacefactory.h>
+
+using namespace wg;
+
+struct SurfaceItem
+{
+	std::string		id;
+	std::string		file;
+	PixelFormat		format;
+};
+
+//____ decodePNG() ____________________________________________________________
+//
+// Decodes with libpng and converts to format the way a loader would at startup.
+
+static Surface_p decodePNG( const char * pPath, PixelFormat format )
+{
+	png_image image;
+	memset( &image, 0, sizeof(image) );
+	image.version = PNG_IMAGE_VERSION;
+
+	if( !png_image_begin_read_from_file( &image, pPath ) )
+		return nullptr;
+
+	Size size( image.width, image.height );
+	Surface_p pSurface;
+
+	if( format == PixelFormat::I8 )
+	{
+		image.format = PNG_FORMAT_BGRA_COLORMAP;
+
+		std::vector<uint8_t>	pixels( PNG_IMAGE_SIZE(image) );
+		std::vector<Color>		clut( 256, Color::Black );
+
+		if( !png_image_finish_read( &image, nullptr, pixels.data(), 0, clut.data() ) )
+			return nullptr;
+
+		PixelDescription desc;
+		Util::pixelFormatToDescription( PixelFormat::I8, desc );
+		pSurface = SoftSurface::create( size, PixelFormat::I8, pixels.data(), PNG_IMAGE_ROW_STRIDE(image), &desc, SurfaceFlag::Static, clut.data() );
+	}
+	else
+	{
+		image.format = PNG_FORMAT_BGRA;
+
+		std::vector<uint8_t>	pixels( PNG_IMAGE_SIZE(image) );
+
+		if( !png_image_finish_read( &image, nullptr, pixels.data(), 0, nullptr ) )
+			return nullptr;
+
+		PixelDescription desc;
+		Util::pixelFormatToDescription( PixelFormat::BGRA_8, desc );
+		pSurface = SoftSurface::create( size, format, pixels.data(), PNG_IMAGE_ROW_STRIDE(image), &desc );
+	}
+
+	return pSurface;
+}
+
+//____ parsePixelFormat() _____________________________________________________
+
+static PixelFormat parsePixelFormat( const char * pName )
+{
+	for( int i = (int) PixelFormat::BGR_8 ; i < PixelFormat_size ; i++ )
+		if( strcmp( toString( (PixelFormat) i ), pName ) == 0 )
+			return (PixelFormat) i;
+
+	return PixelFormat::Unknown;
+}
+
+//____ readFile() _____________________________________________________________
+
+static bool readFile( const char * pPath, std::string& content )
+{
+	FILE * fp = fopen( pPath, "rb" );
+	if( !fp )
+		return false;
+
+	char buffer[4096];
+	size_t n;
+	while( (n = fread( buffer, 1, sizeof(buffer), fp )) > 0 )
+		content.append( buffer, n );
+
+	fclose( fp );
+	return true;
+}
+
+//____ timeMs() _______________________________________________________________
+
+static double timeMs( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
+//____ sumPixels() ____________________________________________________________
+//
+// Reads every byte of the pixels, so that pages of a mapped bundle actually are
+// brought in and both ways of loading are timed until the pixels can be used.
+
+static uint32_t sumPixels( Surface * pSurface )
+{
+	if( !pSurface )
+		return 0;
+
+	const uint8_t * pPixels = pSurface->lock( AccessMode::ReadOnly );
+	if( !pPixels )
+		return 0;
+
+	int rowBytes = pSurface->width() * pSurface->pixelDescription()->bits / 8;
+	int pitch = pSurface->pitch();
+
+	uint32_t sum = 0;
+	for( int y = 0 ; y < pSurface->height() ; y++ )
+	{
+		const uint8_t * p = pPixels + y * pitch;
+		for( int x = 0 ; x < rowBytes ; x++ )
+			sum += p[x];
+	}
+
+	pSurface->unlock();
+	return sum;
+}
+
+//____ bench() ________________________________________________________________
+
+static void bench( const char * pBundlePath, const std::vector<SurfaceItem>& surfaces )
+{
+	const int nRounds = 5;
+
+	SoftSurfaceFactory_p pFactory = SoftSurfaceFactory::create();
+
+	double	firstDecode = 0, firstBundle = 0;
+	double	bestDecode = 1e30;
+	double	bestBundle = 1e30;
+
+	uint32_t	decodeSum = 0;
+	uint32_t	bundleSum = 0;
+
+	for( int round = 0 ; round < nRounds ; round++ )
+	{
+		decodeSum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for( auto& item : surfaces )
+		{
+			Surface_p pSurface = decodePNG( item.file.c_str(), item.format );
+			decodeSum += sumPixels( pSurface );
+		}
+		double decodeTime = timeMs(start);
+
+		bundleSum = 0;
+		start = std::chrono::steady_clock::now();
+		ResBundle_p pBundle = ResBundle::open( pBundlePath );
+		for( int i = 0 ; i < pBundle->nbEntries() ; i++ )
+		{
+			if( pBundle->entryType(i) == ResBundle::EntryType::Surface )
+			{
+				Surface_p pSurface = pBundle->createSurface( i, pFactory );
+				bundleSum += sumPixels( pSurface );
+			}
+		}
+		double bundleTime = timeMs(start);
+
+		if( round == 0 )
+		{
+			firstDecode = decodeTime;
+			firstBundle = bundleTime;
+		}
+		bestDecode = std::min( bestDecode, decodeTime );
+		bestBundle = std::min( bestBundle, bundleTime );
+	}
+
+	printf( "%d surfaces, until every pixel has been read:\n", (int) surfaces.size() );
+	printf( "                   first round    best of %d\n", nRounds );
+	printf( "  PNG decode:  %10.3f ms  %10.3f ms\n", firstDecode, bestDecode );
+	printf( "  Bundle:      %10.3f ms  %10.3f ms\n", firstBundle, bestBundle );
+	printf( "  Pixel checksums %s.\n", decodeSum == bundleSum ? "match" : "DIFFER" );
+}
+
+//____ main() _________________________________________________________________
+
+int main( int argc, char * argv[] )
+{
+	bool	bBench = false;
+	int		arg = 1;
+
+	if( arg < argc && strcmp( argv[arg], "-bench" ) == 0 )
+	{
+		bBench = true;
+		arg++;
+	}
+
+	if( argc - arg < 2 )
+	{
+		printf( "Usage: resbundlepack [-bench] output.wgrb item...\n\n" );
+		printf( "Items:\n" );
+		printf( "  surface:<id>=<file.png>[@<PixelFormat>]\n" );
+		printf( "  color:<id>=<AARRGGBB>\n" );
+		printf( "  font:<id>=<surface id>@<glyph spec file>\n" );
+		return 1;
+	}
+
+	const char * pOutput = argv[arg++];
+
+	Base::init();
+
+	ResBundleWriter				writer;
+	std::vector<SurfaceItem>	surfaces;
+	int							ret = 0;
+
+	for( ; arg < argc ; arg++ )
+	{
+		std::string item = argv[arg];
+
+		size_t colon = item.find( ':' );
+		size_t equal = item.find( '=' );
+		if( colon == std::string::npos || equal == std::string::npos || equal < colon )
+		{
+			printf( "Malformed item: %s\n", item.c_str() );
+			ret = 1;
+			break;
+		}
+
+		std::string type = item.substr( 0, colon );
+		std::string id = item.substr( colon + 1, equal - colon - 1 );
+		std::string value = item.substr( equal + 1 );
+
+		size_t at = value.rfind( '@' );
+		std::string valueArg = at == std::string::npos ? "" : value.substr( at + 1 );
+		std::string valueMain = at == std::string::npos ? value : value.substr( 0, at );
+
+		bool bOk = false;
+
+		if( type == "surface" )
+		{
+			PixelFormat format = valueArg.empty() ? PixelFormat::BGRA_8 : parsePixelFormat( valueArg.c_str() );
+			if( format == PixelFormat::Unknown )
+				printf( "Unknown pixel format: %s\n", valueArg.c_str() );
+			else
+			{
+				Surface_p pSurface = decodePNG( valueMain.c_str(), format );
+				if( !pSurface )
+					printf( "Could not decode %s\n", valueMain.c_str() );
+				else
+				{
+					bOk = writer.addSurface( id, pSurface );
+					surfaces.push_back( { id, valueMain, format } );
+				}
+			}
+		}
+		else if( type == "color" )
+		{
+			char * pEnd;
+			uint32_t argb = (uint32_t) strtoul( value.c_str(), &pEnd, 16 );
+			bOk = *pEnd == 0 && writer.addColor( id, Color(argb) );
+		}
+		else if( type == "font" )
+		{
+			std::string spec;
+			if( !readFile( valueArg.c_str(), spec ) )
+				printf( "Could not read %s\n", valueArg.c_str() );
+			else
+				bOk = writer.addBitmapFont( id, valueMain, spec );
+		}
+
+		if( !bOk )
+		{
+			printf( "Failed to add item: %s\n", item.c_str() );
+			ret = 1;
+			break;
+		}
+	}
+
+	if( ret == 0 )
+	{
+		if( !writer.save( pOutput ) )
+		{
+			printf( "Could not write %s\n", pOutput );
+			ret = 1;
+		}
+		else
+		{
+			printf( "Wrote %d entries to %s\n", writer.nbEntries(), pOutput );
+			if( bBench )
+				bench( pOutput, surfaces );
+		}
+	}
+
+	Base::exit();
+	return ret;
+}
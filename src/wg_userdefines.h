@@ -32,6 +32,8 @@
 	//#define	SAFE_UTF8		// Use slower, but more robust UTF-8 decoding
 								// that better handles broken unicode strings.
 
+	//#define	WG_NO_TRACING	// Compile out all WG_TRACE_SCOPE() markers.
+
 
 namespace wg
 {
@@ -108,6 +108,8 @@ namespace wg
 
 		if( m_pSkin )
 			Capsule::_renderPatches( pDevice, _canvas, _window, _patches );
+		else if( s_pRenderStats )
+			s_pRenderStats->widgetsVisited++;
 
 		if (!m_child.pWidget)
 			return;
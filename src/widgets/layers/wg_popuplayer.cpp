@@ -24,6 +24,7 @@
 #include <wg_util.h>
 #include <wg_patches.h>
 #include <wg_msgrouter.h>
+#include <wg_scheduler.h>
 #include <wg_panel.h>
 #include <wg_base.h>
 #include <wg_inputhandler.h>
@@ -121,6 +122,8 @@ namespace wg
 
 	PopupLayer::~PopupLayer()
 	{
+		if( m_tickTask )
+			Base::scheduler()->removeTask( m_tickTask );
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -547,76 +550,88 @@ namespace wg
 		Layer::_cloneContent( _pOrg );
 	}
 
-	//____ _receive() ______________________________________________________________
+	//____ _onTick() ______________________________________________________________
+	// Scheduler task updating popups that are opening or closing. Sleeps while
+	// all popups are fully open and is woken by pointer movement.
 
-	void PopupLayer::_receive( Msg * _pMsg )
+	int PopupLayer::_onTick( int ms )
 	{
-		Layer::_receive(_pMsg);
-
-		int ms = static_cast<TickMsg*>(_pMsg)->timediff();
+		// Update state for all open popups
 
-		switch( _pMsg->type() )
+		for (auto& popup : m_popups)
 		{
-			case MsgType::Tick:
-
-				// Update state for all open popups
+			switch (popup.state)
+			{
+			case PopupSlot::State::OpeningDelay:
+				if (popup.stateCounter + ms < m_openingDelayMs)
+				{
+					popup.stateCounter += ms;
+					break;
+				}
+				else
+				{
+					popup.state = PopupSlot::State::Opening;
+					popup.stateCounter -= m_openingDelayMs;
+					// No break here, let's continue down to opening...
+				}
+			case PopupSlot::State::Opening:
+				popup.stateCounter += ms;
+				_requestRender(popup.geo);
+				if (popup.stateCounter >= m_openingFadeMs)
+				{
+					popup.stateCounter = 0;
+					popup.state = popup.bAutoClose ? PopupSlot::State::PeekOpen : PopupSlot::State::FixedOpen;
+				}
+				break;
 
-				for (auto& popup : m_popups)
+			case PopupSlot::State::ClosingDelay:
+				if (popup.stateCounter + ms < m_closingDelayMs)
 				{
-					switch (popup.state)
-					{
-					case PopupSlot::State::OpeningDelay:
-						if (popup.stateCounter + ms < m_openingDelayMs)
-						{
-							popup.stateCounter += ms;
-							break;
-						}
-						else
-						{
-							popup.state = PopupSlot::State::Opening;
-							popup.stateCounter -= m_openingDelayMs;
-							// No break here, let's continue down to opening...
-						}
-					case PopupSlot::State::Opening:
-						popup.stateCounter += ms;
-						_requestRender(popup.geo);
-						if (popup.stateCounter >= m_openingFadeMs)
-						{
-							popup.stateCounter = 0;
-							popup.state = popup.bAutoClose ? PopupSlot::State::PeekOpen : PopupSlot::State::FixedOpen;
-						}
-						break;
+					popup.stateCounter += ms;
+					break;
+				}
+				else
+				{
+					popup.state = PopupSlot::State::Closing;
+					popup.stateCounter -= m_closingDelayMs;
+					// No break here, let's continue down to closing...
+				}
+			case PopupSlot::State::Closing:
+				popup.stateCounter += ms;
+				_requestRender(popup.geo);
+				// Removing any closed popups is done in next loop
+				break;
+			default:
+				break;
+			}
 
-					case PopupSlot::State::ClosingDelay:
-						if (popup.stateCounter + ms < m_closingDelayMs)
-						{
-							popup.stateCounter += ms;
-							break;
-						}
-						else
-						{
-							popup.state = PopupSlot::State::Closing;
-							popup.stateCounter -= m_closingDelayMs;
-							// No break here, let's continue down to closing...
-						}
-					case PopupSlot::State::Closing:
-						popup.stateCounter += ms;
-						_requestRender(popup.geo);
-						// Removing any closed popups is done in next loop
-						break;
-					default:
-						break;
-					}
+		}
 
-				}
+		// Close any popup that is due for closing.
 
-				// Close any popup that is due for closing.
+		while (!m_popups.isEmpty() && m_popups.first()->state == PopupSlot::State::Closing && m_popups.first()->stateCounter >= m_closingFadeMs)
+			_removeSlots(0, 1);
 
-				while (!m_popups.isEmpty() && m_popups.first()->state == PopupSlot::State::Closing && m_popups.first()->stateCounter >= m_closingFadeMs)
-					_removeSlots(0, 1);
+		// Keep ticking while any popup is waiting or fading.
 
-			break;
+		for (auto& popup : m_popups)
+		{
+			if (popup.state == PopupSlot::State::OpeningDelay || popup.state == PopupSlot::State::Opening ||
+				popup.state == PopupSlot::State::ClosingDelay || popup.state == PopupSlot::State::Closing)
+				return 0;
+		}
+
+		return -1;
+	}
+
+	//____ _receive() ______________________________________________________________
+
+	void PopupLayer::_receive( Msg * _pMsg )
+	{
+		Layer::_receive(_pMsg);
 
+		switch( _pMsg->type() )
+		{
 			case MsgType::MouseEnter:
 			case MsgType::MouseMove:
 			{
@@ -699,7 +714,7 @@ namespace wg
 					}
 				}
 
-
+				Base::scheduler()->wakeTask( m_tickTask );
 			}
 			break;
 
@@ -867,8 +882,10 @@ namespace wg
 		_updateGeo(pSlot, true);
 		_stealKeyboardFocus();
 
-		if (m_tickRouteId == 0)
-			m_tickRouteId = Base::msgRouter()->addRoute(MsgType::Tick, this);
+		if (m_tickTask == 0)
+			m_tickTask = Base::scheduler()->addTask([this](int64_t timestamp, int timediff) { return _onTick(timediff); });
+		else
+			Base::scheduler()->wakeTask(m_tickTask);
 	}
 
 
@@ -894,8 +911,8 @@ namespace wg
 
 		if (m_popups.isEmpty())
 		{
-			Base::msgRouter()->deleteRoute(m_tickRouteId);
-			m_tickRouteId = 0;
+			Base::scheduler()->removeTask(m_tickTask);
+			m_tickTask = 0;
 		}
 	}
 
@@ -172,11 +172,12 @@ namespace wg
 		void			_setSize( const Size& size );
 		void			_receive( Msg * pMsg );
 
+		int				_onTick( int ms );
 
 		SlotArray<PopupSlot>m_popups;		// First popup lies at the bottom.
 		Widget_wp			m_pKeyFocus;	// Pointer at child that held focus before any menu was opened.
 
-		RouteId			m_tickRouteId = 0;
+		TaskId			m_tickTask = 0;
 
 		int				m_openingDelayMs = 100;
 		int				m_openingFadeMs = 100;
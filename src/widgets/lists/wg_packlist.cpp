@@ -294,18 +294,7 @@ namespace wg
 				patches.sub( Rect( Rect( geo.x, geo.y, geo.w, wg::min(geo.h,m_contentLength) ), clip ) );
 		}
 		else
-		{
-			Rect	myClip(geo, clip);				// Need to limit clip to our geo. Otherwise children outside might mask what they shouldn't.
-			SlotWithGeo child;
-			_firstSlotWithGeo( child );
-
-			while(child.pSlot)
-			{
-				child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), myClip, blendMode );
-				_nextSlotWithGeo( child );
-			}
-		}
-
+			_maskOpaqueRegion( patches, geo, clip, blendMode );
 	}
 
 	//____ _cloneContent() ______________________________________________________
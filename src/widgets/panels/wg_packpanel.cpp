@@ -24,6 +24,7 @@
 
 #include <wg_packpanel.h>
 #include <wg_base.h>
+#include <wg_trace.h>
 
 
 #include <wg_slotarray.impl.h>
@@ -625,6 +626,8 @@ namespace wg
 
 	void PackPanel::_refreshChildGeo( bool bRequestRender )
 	{
+		WG_TRACE_SCOPE("PackPanel::_refreshChildGeo");
+
 		if( m_children.isEmpty() )
 			return;
 
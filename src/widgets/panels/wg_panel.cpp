@@ -111,18 +111,8 @@ namespace wg
 		switch( m_maskOp )
 		{
 			case MaskOp::Recurse:
-			{
-				Rect	myClip(geo, clip);				// Need to limit clip to our geo. Otherwise children outside might mask what they shouldn't (for panels where children can go outside parent).
-				SlotWithGeo child;
-				_firstSlotWithGeo( child );
-
-				while(child.pSlot)
-				{
-					child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), myClip, blendMode );
-					_nextSlotWithGeo( child );
-				}
+				_maskOpaqueRegion( patches, geo, clip, blendMode );
 				break;
-			}
 			case MaskOp::Skip:
 				break;
 			case MaskOp::Mask:
@@ -25,6 +25,7 @@
 #include <wg_container.h>
 #include <wg_boxskin.h>
 #include <wg_inputhandler.h>
+#include <wg_trace.h>
 
 #include <new>
 
@@ -137,16 +138,20 @@ namespace wg
 
 	void RootPanel::_setWidget( Slot * pSlot, Widget * pNewWidget )
 	{
+		Patches patches;
+
 		if( pSlot->pWidget )
-			pSlot->pWidget->_collectPatches( m_dirtyPatches, geo(), geo() );
+			pSlot->pWidget->_collectPatches( patches, geo(), geo() );
 
 		pSlot->replaceWidget( this, pNewWidget );
 
 		if( pNewWidget )
 		{
 			pNewWidget->_setSize(m_geo.size());
-			pNewWidget->_collectPatches( m_dirtyPatches, geo(), geo() );
+			pNewWidget->_collectPatches( patches, geo(), geo() );
 		}
+
+		m_dirtyPatches.add( patches );
 	}
 
 	//____ _object() ____________________________________________________________
@@ -184,7 +189,7 @@ namespace wg
 		if( m_bDebugMode == false )
 		{
 			for( auto it = m_afterglowRects.begin() ; it != m_afterglowRects.end() ; it++ )
-				m_dirtyPatches.add( &(*it) );
+				m_dirtyPatches.add( *it );
 
 			m_afterglowRects.clear();
 		}
@@ -231,10 +236,27 @@ namespace wg
 		return true;
 	}
 
+	//____ setRenderStatsEnabled() ___________________________________________________
+	/**
+	 * @brief Enable or disable collection of render statistics.
+	 *
+	 * When enabled, the number of dirty patches and widgets visited and rendered are
+	 * counted for each render() and can be read through renderStats() afterwards. Statistics for
+	 * the drawing itself are collected by the GfxDevice, see GfxDevice::setStatsEnabled().
+	 */
+
+	void RootPanel::setRenderStatsEnabled( bool bEnabled )
+	{
+		m_bRenderStats = bEnabled;
+		m_renderStats = RenderStats();
+	}
+
 	//____ beginRender() __________________________________________________________
 
 	bool RootPanel::beginRender()
 	{
+		WG_TRACE_SCOPE("RootPanel::beginRender");
+
 		if( !m_pGfxDevice || !m_child.pWidget )
 			return false;						// No GFX-device or no widgets to render.
 
@@ -244,20 +266,19 @@ namespace wg
 		{
 			// Remove from afterglow queue patches that are overlapped by our new dirty patches.
 
-			for( std::deque<Patches>::iterator it = m_afterglowRects.begin() ; it != m_afterglowRects.end() ; ++it )
-				it->sub(&m_dirtyPatches);
+			for( auto it = m_afterglowRects.begin() ; it != m_afterglowRects.end() ; ++it )
+				it->sub(m_dirtyPatches);
 
 			// Add our new dirty patches to the top of the afterglow queue.
 
 
-			m_afterglowRects.push_front(Patches());
-			m_afterglowRects.front().add(&m_dirtyPatches);
+			m_afterglowRects.push_front(m_dirtyPatches);
 
 			// Possibly remove overlays from the back, put them into dirty rects for re-render
 
 			while( (int) m_afterglowRects.size() > m_afterglowFrames+1 )
 			{
-				m_dirtyPatches.add( &m_afterglowRects.back() );
+				m_dirtyPatches.add( m_afterglowRects.back() );
 				m_afterglowRects.pop_back();
 			}
 
@@ -265,10 +286,13 @@ namespace wg
 
 			if( m_afterglowRects.size() > 1 )
 			{
-				m_dirtyPatches.add( &m_afterglowRects[1] );
+				m_dirtyPatches.add( m_afterglowRects[1] );
 			}
 		}
 
+		if( m_bRenderStats )
+			m_renderStats = RenderStats();
+
 		// Initialize GFX-device.
 
 		return m_pGfxDevice->beginRender();
@@ -279,6 +303,8 @@ namespace wg
 
 	bool RootPanel::renderSection( const Rect& _clip )
 	{
+		WG_TRACE_SCOPE("RootPanel::renderSection");
+
 		if( !m_pGfxDevice || !m_child.pWidget )
 			return false;						// No GFX-device or no widgets to render.
 
@@ -302,7 +328,24 @@ namespace wg
 
 		if( dirtyPatches.size() > 0 )
 		{
+			if( m_bRenderStats )
+			{
+				m_renderStats.dirtyPatches += dirtyPatches.size();
+				for( const Rect * pRect = dirtyPatches.begin() ; pRect != dirtyPatches.end() ; pRect++ )
+					m_renderStats.dirtyPixels += pRect->w * pRect->h;
+
+				Widget::s_pRenderStats = &m_renderStats;
+			}
+
+			// Bring the cached opaque regions of all containers up to date in one pass, front to back,
+			// before they are used for masking patches while rendering.
+
+			if( m_child.pWidget->isContainer() )
+				static_cast<Container*>(m_child.pWidget)->_updateOpaqueRegion();
+
 			m_child.pWidget->_renderPatches( m_pGfxDevice.rawPtr(), canvas, canvas, dirtyPatches );
+
+			Widget::s_pRenderStats = nullptr;
 		}
 
 		// Handle updated rect overlays
@@ -338,14 +381,14 @@ namespace wg
 
 	bool RootPanel::endRender( void )
 	{
+		WG_TRACE_SCOPE("RootPanel::endRender");
+
 		if( !m_pGfxDevice || !m_child.pWidget )
 			return false;						// No GFX-device or no widgets to render.
 
 		// Turn dirty patches into update patches
-		//TODO: Optimize by just making a swap.
 
-		m_updatedPatches.clear();
-		m_updatedPatches.add(&m_dirtyPatches);
+		m_updatedPatches.swap(m_dirtyPatches);
 		m_dirtyPatches.clear();
 
 		return m_pGfxDevice->endRender();
@@ -27,6 +27,7 @@
 #include <wg_widgetholder.h>
 #include <wg_geo.h>
 #include <wg_patches.h>
+#include <wg_bandedpatches.h>
 #include <wg_msgrouter.h>
 #include <wg_gfxdevice.h>
 #include <wg_ichild.h>
@@ -99,6 +100,10 @@ namespace wg
 		bool				endRender();
 
 
+		void				setRenderStatsEnabled( bool bEnabled );
+		inline bool			isRenderStatsEnabled() const { return m_bRenderStats; }
+		inline const RenderStats&	renderStats() const { return m_renderStats; }	///< @brief Statistics since beginRender(), only updated when enabled.
+
 		//.____ Debug __________________________________________________________
 
 		void				setDebugMode( bool onOff );
@@ -174,14 +179,14 @@ namespace wg
 		Widget *			_focusedChild() const;
 
 
-		Patches				m_dirtyPatches;		// Dirty patches that needs to be rendered.
-		Patches				m_updatedPatches;	// Patches that were updated in last rendering session.
+		BandedPatches		m_dirtyPatches;		// Dirty patches that needs to be rendered. Banded since hundreds of small updates per frame are common.
+		BandedPatches		m_updatedPatches;	// Patches that were updated in last rendering session.
 
 
 		bool				m_bDebugMode;
 		Skin_p				m_pDebugOverlay;
 		int					m_afterglowFrames;
-		std::deque<Patches>	m_afterglowRects;	// Afterglow rects are placed in this queue.
+		std::deque<BandedPatches>	m_afterglowRects;	// Afterglow rects are placed in this queue.
 
 		GfxDevice_p			m_pGfxDevice;
 		Slot				m_child;
@@ -190,6 +195,9 @@ namespace wg
 		bool				m_bVisible;
 
 		Widget_wp			m_pFocusedChild;
+
+		bool				m_bRenderStats = false;
+		RenderStats			m_renderStats = {};
 	};
 
 
@@ -1092,6 +1092,12 @@ namespace wg
 
 	void ScrollPanel::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Patches& patches )
 	{
+		if( s_pRenderStats )
+		{
+			s_pRenderStats->widgetsVisited++;
+			s_pRenderStats->widgetsRendered++;
+		}
+
 		// Set clipping
 
 		pDevice->setClipList(patches.size(), patches.begin());
@@ -1171,41 +1177,53 @@ namespace wg
 		switch( m_maskOp )
 		{
 			case MaskOp::Recurse:
-			{
-				// Mask against view
+				_maskOpaqueRegion( patches, geo, clip, blendMode );
+				break;
+			case MaskOp::Skip:
+				break;
+			case MaskOp::Mask:
+				patches.sub( Rect(geo,clip) );
+				break;
+		}
+	}
 
-				{
-					ViewSlot * p = &m_viewSlot;
+	//____ _maskChildren() _________________________________________________________
 
-					if (m_pSkin && m_pSkin->isOpaque())
-						patches.sub(Rect(p->windowGeo + geo.pos(), clip));
-					else if (p->pWidget)
-						p->pWidget->_maskPatches(patches, p->canvasGeo + geo.pos(), Rect(p->windowGeo + geo.pos(), clip), blendMode);
-				}
+	void ScrollPanel::_maskChildren( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		// Mask against view
 
-				// Mask against dragbars
+		{
+			ViewSlot * p = &m_viewSlot;
 
-				ScrollbarSlot * p = &m_scrollbarSlots[0];
-				if( p->bVisible )
-					p->pWidget->_maskPatches( patches, p->geo + geo.pos(), clip, blendMode );
+			if (p->pWidget)
+				p->pWidget->_maskPatches(patches, p->canvasGeo + geo.pos(), Rect(p->windowGeo + geo.pos(), clip), blendMode);
+		}
 
-				p++;
-				if( p->bVisible )
-					p->pWidget->_maskPatches( patches, p->geo + geo.pos(), clip, blendMode );
+		// Mask against dragbars
 
-				// Maska against corner piece
+		ScrollbarSlot * p = &m_scrollbarSlots[0];
+		if( p->bVisible )
+			p->pWidget->_maskPatches( patches, p->geo + geo.pos(), clip, blendMode );
 
-				if( !m_cornerGeo.isEmpty() && m_pCornerSkin && m_pCornerSkin->isOpaque() )
-					patches.sub( Rect(m_cornerGeo + geo.pos(), clip) );
+		p++;
+		if( p->bVisible )
+			p->pWidget->_maskPatches( patches, p->geo + geo.pos(), clip, blendMode );
+	}
 
-				break;
-			}
-			case MaskOp::Skip:
-				break;
-			case MaskOp::Mask:
-				patches.sub( Rect(geo,clip) );
-				break;
-		}
+	//____ _maskOwnParts() _________________________________________________________
+
+	void ScrollPanel::_maskOwnParts( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		// Mask against view background
+
+		if (m_pSkin && m_pSkin->isOpaque())
+			patches.sub(Rect(m_viewSlot.windowGeo + geo.pos(), clip));
+
+		// Mask against corner piece
+
+		if( !m_cornerGeo.isEmpty() && m_pCornerSkin && m_pCornerSkin->isOpaque() )
+			patches.sub( Rect(m_cornerGeo + geo.pos(), clip) );
 	}
 
 	//____ _alphaTest() ___________________________________________________________
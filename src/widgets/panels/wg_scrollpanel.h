@@ -284,6 +284,8 @@ namespace wg
 		void		_renderPatches(GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Patches& _patches);
 		void		_collectPatches(Patches& container, const Rect& geo, const Rect& clip);
 		void		_maskPatches(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode);
+		void		_maskChildren(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode);
+		void		_maskOwnParts(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode);
 
 		bool		_alphaTest(const Coord& ofs);
 		void		_cloneContent(const Widget * _pOrg);
@@ -496,17 +496,27 @@ namespace wg
 			if ((m_bOpaque && blendMode == BlendMode::Blend) || blendMode == BlendMode::Replace)
 				patches.sub(Rect(geo, clip));
 			else
-			{
-				if (m_firstChild.pWidget)
-					m_firstChild.pWidget->_maskPatches(patches, m_firstChild.geo + geo.pos(), clip, blendMode );
+				_maskOpaqueRegion(patches, geo, clip, blendMode);
+		}
+	}
 
-				if (m_pHandleSkin && m_pHandleSkin->isOpaque() )
-					patches.sub(Rect(m_handleGeo, clip));
+	//____ _maskChildren() _______________________________________________________
 
-				if (m_secondChild.pWidget)
-					m_secondChild.pWidget->_maskPatches(patches, m_secondChild.geo + geo.pos(), clip, blendMode );
-			}
-		}
+	void SplitPanel::_maskChildren(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode)
+	{
+		if (m_firstChild.pWidget)
+			m_firstChild.pWidget->_maskPatches(patches, m_firstChild.geo + geo.pos(), clip, blendMode );
+
+		if (m_secondChild.pWidget)
+			m_secondChild.pWidget->_maskPatches(patches, m_secondChild.geo + geo.pos(), clip, blendMode );
+	}
+
+	//____ _maskOwnParts() _______________________________________________________
+
+	void SplitPanel::_maskOwnParts(Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode)
+	{
+		if (m_pHandleSkin && m_pHandleSkin->isOpaque() )
+			patches.sub(Rect(m_handleGeo + geo.pos(), clip));
 	}
 
 	//____ _alphaTest() _______________________________________________________
@@ -24,6 +24,7 @@
 #include <wg_animplayer.h>
 #include <wg_util.h>
 #include <wg_msgrouter.h>
+#include <wg_scheduler.h>
 #include <wg_gfxdevice.h>
 
 #include <math.h>
@@ -45,15 +46,15 @@ namespace wg
 
 		m_bPlaying		= false;
 		m_speed			= 1.f;
-		m_tickRouteId	= 0;
+		m_tickTask		= 0;
 	}
 
 	//____ ~AnimPlayer() _______________________________________________________
 
 	AnimPlayer::~AnimPlayer()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickTask )
+			Base::scheduler()->removeTask( m_tickTask );
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -210,7 +211,7 @@ namespace wg
 			return false;
 
 		m_bPlaying = true;
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_tickTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onTick(timediff); } );
 		return true;
 	}
 
@@ -222,8 +223,8 @@ namespace wg
 			return true;
 
 		m_bPlaying = false;
-		Base::msgRouter()->deleteRoute( m_tickRouteId );
-		m_tickRouteId = 0;
+		Base::scheduler()->removeTask( m_tickTask );
+		m_tickTask = 0;
 		return true;
 	}
 
@@ -261,28 +262,16 @@ namespace wg
 	}
 
 
-	//____ _receive() ______________________________________________________________
+	//____ _onTick() ______________________________________________________________
 
-	void AnimPlayer::_receive( Msg * pMsg )
+	int AnimPlayer::_onTick( int ms )
 	{
-		Widget::_receive( pMsg );
-
-		switch( pMsg->type() )
+		if( m_pAnim && m_state.isEnabled() )
 		{
-			case MsgType::Tick:
-			{
-				if( !m_pAnim || !m_state.isEnabled() )
-					return;
-
-				m_playPos += TickMsg::cast(pMsg)->timediff() * m_speed;
-				_playPosUpdated();
-
-			}
-			break;
-
-			default:
-				break;
+			m_playPos += ms * m_speed;
+			_playPosUpdated();
 		}
+		return 0;
 	}
 
 
@@ -340,11 +329,11 @@ namespace wg
 		if( state.isEnabled() != m_state.isEnabled() && m_bPlaying )
 		{
 			if( state.isEnabled() )
-				m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+				m_tickTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onTick(timediff); } );
 			else
 			{
-				Base::msgRouter()->deleteRoute( m_tickRouteId );
-				m_tickRouteId = 0;
+				Base::scheduler()->removeTask( m_tickTask );
+				m_tickTask = 0;
 			}
 			_requestRender();
 		}
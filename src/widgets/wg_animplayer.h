@@ -90,17 +90,17 @@ namespace wg
 		void			_cloneContent( const Widget * _pOrg );
 		void			_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window );
 		void			_refresh();
-		void			_receive( Msg * pMsg );
 		bool			_alphaTest( const Coord& ofs );
 		void			_setState( State state );
 
 		void			_playPosUpdated();
+		int				_onTick( int ms );
 
 	private:
 
 		GfxAnim_p	m_pAnim;
 		GfxFrame *	m_pAnimFrame;			// Frame currently used by animation.
-		RouteId		m_tickRouteId;
+		TaskId		m_tickTask;
 
 		bool			m_bPlaying;
 		double			m_playPos;
@@ -25,6 +25,7 @@
 #include <wg_panel.h>
 #include <wg_rootpanel.h>
 #include <wg_patches.h>
+#include <wg_bandedpatches.h>
 #include <wg_gfxdevice.h>
 
 namespace wg
@@ -32,9 +33,11 @@ namespace wg
 
 	const char Container::CLASSNAME[] = {"Container"};
 
+	static const int	c_bandedPatchesThreshold = 32;		// Number of patches from which children are trimmed through BandedPatches.
+
 	//____ Constructor _____________________________________________________________
 
-	Container::Container() : m_bSiblingsOverlap(true)
+	Container::Container() : m_bSiblingsOverlap(true), m_bOpaqueRegionValid(false)
 	{
 	}
 
@@ -257,16 +260,29 @@ namespace wg
 
 	void Container::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Patches& _patches )
 	{
+		if( s_pRenderStats )
+			s_pRenderStats->widgetsVisited++;
+
 		Patches patches( _patches );
 
-		// Render container itself
+		// Render container itself, except where covered by opaque children. Opaque parts
+		// we draw ourselves must not be masked here or they would never be drawn.
+
+		Patches ownPatches( _patches );
+		_maskChildren( ownPatches, _canvas, _canvas, pDevice->blendMode() );
 
-		pDevice->setClipList(patches.size(), patches.begin());
-		_render(pDevice, _canvas, _window );
+		if( !ownPatches.isEmpty() )
+		{
+			if( s_pRenderStats )
+				s_pRenderStats->widgetsRendered++;
+
+			pDevice->setClipList(ownPatches.size(), ownPatches.begin());
+			_render(pDevice, _canvas, _window );
+		}
 
 		// Render children
 
-		Rect	dirtBounds = pDevice->clipBounds();
+		Rect	dirtBounds = patches.getUnion();
 
 		if( m_bSiblingsOverlap )
 		{
@@ -294,7 +310,7 @@ namespace wg
 				WidgetRenderContext * p = &renderList[i];
 
 				p->patches.trimPush( patches, p->geo );
-				p->pWidget->_maskPatches( patches, p->geo, p->geo, pDevice->blendMode() );		//TODO: Need some optimizations here, grandchildren can be called repeatedly! Expensive!
+				p->pWidget->_maskPatches( patches, p->geo, p->geo, pDevice->blendMode() );		// Containers use their cached opaque region, no recursion needed.
 
 				if( patches.isEmpty() )
 					break;
@@ -305,11 +321,22 @@ namespace wg
 			for (int i = int(renderList.size()) - 1; i >= 0; i--)
 			{
 				WidgetRenderContext * p = &renderList[i];
-				p->pWidget->_renderPatches( pDevice, p->geo, p->geo, p->patches );
+
+				if( !p->patches.isEmpty() )											// Skip children completely covered by siblings.
+					p->pWidget->_renderPatches( pDevice, p->geo, p->geo, p->patches );
 			}
 		}
 		else
 		{
+			// Trimming the patches for each child is linear in number of patches, so with
+			// many patches we index them in bands first and only visit the ones within reach.
+
+			BandedPatches	bandedPatches;
+			bool			bBanded = patches.size() > c_bandedPatchesThreshold;
+
+			if( bBanded )
+				bandedPatches.add( patches );
+
 			SlotWithGeo child;
 			_firstSlotWithGeo( child );
 
@@ -318,7 +345,12 @@ namespace wg
 				Rect canvas = child.geo + _canvas.pos();
 				if (canvas.intersectsWith(dirtBounds))
 				{
-					Patches childPatches(patches, canvas);
+					Patches childPatches;
+					if( bBanded )
+						childPatches.trimPush(bandedPatches, canvas);
+					else
+						childPatches.trimPush(patches, canvas);
+
 					if( !childPatches.isEmpty() )
 						child.pSlot->pWidget->_renderPatches(pDevice, canvas, canvas, childPatches);
 				}
@@ -365,16 +397,75 @@ namespace wg
 		if( (m_bOpaque && blendMode == BlendMode::Blend) || blendMode == BlendMode::Replace)
 			patches.sub( Rect(geo,clip) );
 		else
+			_maskOpaqueRegion( patches, geo, clip, blendMode );
+	}
+
+	//____ _maskChildren() _________________________________________________________
+	// Masks patches against our children only. Overridden by containers with children
+	// that don't mask normally.
+
+	void Container::_maskChildren( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		Rect	myClip(geo, clip);				// Need to limit clip to our geo. Otherwise children outside might mask what they shouldn't.
+		SlotWithGeo child;
+		_firstSlotWithGeo( child );
+
+		while(child.pSlot)
 		{
-			SlotWithGeo child;
-			_firstSlotWithGeo( child );
+			child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), myClip, blendMode );
+			_nextSlotWithGeo( child );
+		}
+	}
 
-			while(child.pSlot)
-			{
-				child.pSlot->pWidget->_maskPatches( patches, child.geo + geo.pos(), clip, blendMode );
-				_nextSlotWithGeo( child );
-			}
+	//____ _maskOwnParts() _________________________________________________________
+	// Masks patches against opaque parts that we draw ourselves in _render(), like
+	// handles and corner pieces. Overridden by containers that have any.
+
+	void Container::_maskOwnParts( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+	}
+
+	//____ _maskOpaqueRegion() _____________________________________________________
+	// Masks patches against what our children cover. Uses the cached opaque region for
+	// normal blending so that grandchildren don't need to be visited over and over.
+
+	void Container::_maskOpaqueRegion( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode )
+	{
+		if( blendMode != BlendMode::Blend )
+		{
+			_maskChildren( patches, geo, clip, blendMode );
+			_maskOwnParts( patches, geo, clip, blendMode );
+			return;
 		}
+
+		_updateOpaqueRegion();
+
+		Coord ofs = geo.pos();
+		for( const Rect * pRect = m_opaqueRegion.begin() ; pRect != m_opaqueRegion.end() && !patches.isEmpty() ; pRect++ )
+			patches.sub( Rect( *pRect + ofs, clip ) );
+	}
+
+	//____ _updateOpaqueRegion() ___________________________________________________
+
+	void Container::_updateOpaqueRegion()
+	{
+		if( m_bOpaqueRegionValid )
+			return;
+
+		// Let our children mask a patch covering all of us. Whatever is removed is opaque.
+
+		Rect	myGeo( m_size );
+
+		Patches	transparent;
+		transparent.add( myGeo );
+		_maskChildren( transparent, myGeo, myGeo, BlendMode::Blend );
+		_maskOwnParts( transparent, myGeo, myGeo, BlendMode::Blend );
+
+		m_opaqueRegion.clear();
+		m_opaqueRegion.add( myGeo );
+		m_opaqueRegion.sub( &transparent );
+
+		m_bOpaqueRegionValid = true;
 	}
 
 } // namespace wg
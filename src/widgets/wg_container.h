@@ -25,12 +25,12 @@
 #pragma once
 
 #include <wg_widget.h>
+#include <wg_patches.h>
 
 
 namespace wg
 {
 
-	class Patches;
 	class ModalLayer;
 	class PopupLayer;
 
@@ -47,6 +47,7 @@ namespace wg
 	class Container : public Widget, protected WidgetHolder
 	{
 		friend class MsgRouter;
+		friend class Widget;
 
 
 		friend class Menu;
@@ -151,11 +152,18 @@ namespace wg
 			virtual PopupLayer*		_getPopupLayer() const;
 
 			virtual void			_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
+			virtual void			_maskChildren( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
+			virtual void			_maskOwnParts( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
+			void					_maskOpaqueRegion( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
+			void					_updateOpaqueRegion();
 			virtual void			_collectPatches( Patches& container, const Rect& geo, const Rect& clip );
 			virtual void			_cloneContent( const Widget * _pOrg );
 
 			bool			m_bSiblingsOverlap;	// Set if children (might be) overlapping each other (special considerations to be taken during rendering).
 
+			bool			m_bOpaqueRegionValid;
+			Patches			m_opaqueRegion;		// Area covered by opaque children (and grandchildren etc), relative to our position.
+
 	};
 
 
@@ -28,6 +28,7 @@
 #include	<wg_base.h>
 #include	<wg_stdtextmapper.h>
 #include	<wg_msgrouter.h>
+#include	<wg_scheduler.h>
 
 namespace wg
 {
@@ -59,15 +60,15 @@ namespace wg
 		m_valuesText.setTextMapper(pValueTextMapper);
 
 
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_tickTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onTick(timediff); } );
 	}
 
 	//____ ~FpsDisplay() __________________________________________________________
 
 	FpsDisplay::~FpsDisplay( void )
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickTask )
+			Base::scheduler()->removeTask( m_tickTask );
 		if( m_pTickBuffer )
 		{
 			delete [] m_pTickBuffer;
@@ -146,75 +147,65 @@ namespace wg
 	}
 
 
-	//____ _receive() _____________________________________________________________
+	//____ _onTick() ______________________________________________________________
 
-	void FpsDisplay::_receive( Msg * pMsg )
+	int FpsDisplay::_onTick( int msDiff )
 	{
-		Widget::_receive(pMsg);
+		// Update tick buffer
 
-		switch( pMsg->type() )
+		m_tickBufferOfs = (++m_tickBufferOfs) % c_tickBuffer;
+
+		if( msDiff > 0 )
+			m_pTickBuffer[m_tickBufferOfs] = msDiff;
+		else
+			m_pTickBuffer[m_tickBufferOfs] = 1;
+
+		// Update valueTexts from tick-buffer
+
+		const int	cCurrentFrames = 10;
+		int currOfs = ((int)m_tickBufferOfs) - cCurrentFrames;
+		if( currOfs < 0 )
+			currOfs += c_tickBuffer;
+
+		int	currTotal = 0;
+		for( int i = 0 ; i < cCurrentFrames ; i++ )
 		{
-			case MsgType::Tick:
-			{
-				// Update tick buffer
-
-				m_tickBufferOfs = (++m_tickBufferOfs) % c_tickBuffer;
-
-				int msDiff = TickMsg::cast(pMsg)->timediff();
-				if( msDiff > 0 )
-					m_pTickBuffer[m_tickBufferOfs] = msDiff;
-				else
-					m_pTickBuffer[m_tickBufferOfs] = 1;
-
-				// Update valueTexts from tick-buffer
-
-				const int	cCurrentFrames = 10;
-				int currOfs = ((int)m_tickBufferOfs) - cCurrentFrames;
-				if( currOfs < 0 )
-					currOfs += c_tickBuffer;
-
-				int	currTotal = 0;
-				for( int i = 0 ; i < cCurrentFrames ; i++ )
-				{
-					currTotal += m_pTickBuffer[currOfs++];
-					currOfs %= c_tickBuffer;
-				}
-				float	fpsCurrent = 1000.f / (currTotal / (float) cCurrentFrames);
-
-				//____
-
-				int	avg = 0;
-				for( int i = 0 ; i < c_tickBuffer ; i++ )
-					avg += m_pTickBuffer[i];
-				float fpsAvg = 1000.f / (((float)avg)/c_tickBuffer);
-
-				//____
-
-				int	min = 1000000000;
-				for( int i = 0 ; i < c_tickBuffer ; i++ )
-					if( min > m_pTickBuffer[i] )
-						min = m_pTickBuffer[i];
-				float fpsMax = 1000.f / min;
-
-				//____
-
-				int	max = 0;
-				for( int i = 0 ; i < c_tickBuffer ; i++ )
-					if( max < m_pTickBuffer[i] )
-						max = m_pTickBuffer[i];
-				float fpsMin = 1000.f / max;
-
-				//____
-
-				char	temp[100];
-				snprintf( temp, 100, "%.2f\n%.2f\n%.2f\n%.2f", fpsCurrent, fpsMin, fpsAvg, fpsMax );
-				m_valuesText.set(temp);
-
-				_requestRender();
-			}
-			default:
-				break;
+			currTotal += m_pTickBuffer[currOfs++];
+			currOfs %= c_tickBuffer;
 		}
+		float	fpsCurrent = 1000.f / (currTotal / (float) cCurrentFrames);
+
+		//____
+
+		int	avg = 0;
+		for( int i = 0 ; i < c_tickBuffer ; i++ )
+			avg += m_pTickBuffer[i];
+		float fpsAvg = 1000.f / (((float)avg)/c_tickBuffer);
+
+		//____
+
+		int	min = 1000000000;
+		for( int i = 0 ; i < c_tickBuffer ; i++ )
+			if( min > m_pTickBuffer[i] )
+				min = m_pTickBuffer[i];
+		float fpsMax = 1000.f / min;
+
+		//____
+
+		int	max = 0;
+		for( int i = 0 ; i < c_tickBuffer ; i++ )
+			if( max < m_pTickBuffer[i] )
+				max = m_pTickBuffer[i];
+		float fpsMin = 1000.f / max;
+
+		//____
+
+		char	temp[100];
+		snprintf( temp, 100, "%.2f\n%.2f\n%.2f\n%.2f", fpsCurrent, fpsMin, fpsAvg, fpsMax );
+		m_valuesText.set(temp);
+
+		_requestRender();
+		return 0;
 	}
 
 	//____ _setState() ______________________________________________________
@@ -227,12 +218,12 @@ namespace wg
 		_requestRender();							//TODO: Check if there has been changes to text appearance.
 
 		if( state.isEnabled() && !m_state.isEnabled() )
-			m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+			m_tickTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onTick(timediff); } );
 
 		if( !state.isEnabled() && m_state.isEnabled() )
 		{
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
-			m_tickRouteId = 0;
+			Base::scheduler()->removeTask( m_tickTask );
+			m_tickTask = 0;
 		}
 
 		Widget::_setState(state);
@@ -69,7 +69,7 @@ namespace wg
 		virtual ~FpsDisplay();
 		virtual Widget* _newOfMyType() const { return new FpsDisplay(); };
 
-		void		_receive( Msg * pMsg );
+		int			_onTick( int msDiff );
 		void		_setState( State state );
 		void		_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window );
 		void		_cloneContent( const Widget * _pOrg );
@@ -83,7 +83,7 @@ namespace wg
 		CTextDisplay	m_valuesText;
 		int *			m_pTickBuffer;
 		int				m_tickBufferOfs;
-		RouteId			m_tickRouteId;
+		TaskId			m_tickTask;
 	};
 
 
@@ -28,6 +28,7 @@
 #include <wg_key.h>
 #include <wg_msg.h>
 #include <wg_msgrouter.h>
+#include <wg_scheduler.h>
 
 namespace wg
 {
@@ -48,15 +49,15 @@ namespace wg
 		m_animTimer			= 0;
 		m_refreshProgress	= 0.f;
 		m_bStopping			= false;
-		m_tickRouteId		= 0;
+		m_tickTask			= 0;
 	}
 
 	//____ Destructor _____________________________________________________________
 
 	RefreshButton::~RefreshButton()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		if( m_tickTask )
+			Base::scheduler()->removeTask( m_tickTask );
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -128,7 +129,8 @@ namespace wg
 			m_refreshProgress = 0.f;
 			m_animTimer = 0;
 			m_pRefreshAnim->setPlayMode( AnimMode::Looping );		//UGLY! Should change once the animation system has been updated.
-			m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+			if( !m_tickTask )
+				m_tickTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _onTick(timediff); } );
 			_requestRender();
 		}
 	}
@@ -153,8 +155,8 @@ namespace wg
 	{
 		m_refreshProgress = 1.f;
 		m_bRefreshing = false;
-		Base::msgRouter()->deleteRoute( m_tickRouteId );
-		m_tickRouteId = 0;
+		Base::scheduler()->removeTask( m_tickTask );
+		m_tickTask = 0;
 		_requestRender();
 	}
 
@@ -190,46 +192,46 @@ namespace wg
 	}
 
 
-	//____ _receive() _____________________________________________________________
+	//____ _onTick() ______________________________________________________________
 
-	void RefreshButton::_receive( Msg * pMsg )
+	int RefreshButton::_onTick( int ms )
 	{
-		Button::_receive( pMsg );
-
-		switch( pMsg->type() )
+		if( m_bRefreshing && m_pRefreshAnim )
 		{
-			case MsgType::Tick:
+			if( m_refreshMode != PROGRESS )
 			{
-				if( m_bRefreshing && m_pRefreshAnim )
+				GfxFrame * pOldFrame = m_pRefreshAnim->getFrame( m_animTimer );
+				m_animTimer += ms;
+				GfxFrame * pNewFrame = m_pRefreshAnim->getFrame( m_animTimer );
+
+				// RequestRender if animation has moved.
+
+				if( pOldFrame != pNewFrame )
+					_requestRender();
+
+				// Check if animation has ended.
+
+				if( m_bStopping && pNewFrame == m_pRefreshAnim->getLastFrame() )		//UGLY! Change when we have updated Anim!
 				{
-					if( m_refreshMode != PROGRESS )
-					{
-						TickMsg_p pTick = TickMsg::cast(pMsg);
-
-						GfxFrame * pOldFrame = m_pRefreshAnim->getFrame( m_animTimer );
-						m_animTimer += pTick->timediff();
-						GfxFrame * pNewFrame = m_pRefreshAnim->getFrame( m_animTimer );
-
-						// RequestRender if animation has moved.
-
-						if( pOldFrame != pNewFrame )
-							_requestRender();
-
-						// Check if animation has ended.
-
-						if( m_bStopping && pNewFrame == m_pRefreshAnim->getLastFrame() )		//UGLY! Change when we have updated Anim!
-						{
-							m_bRefreshing = false;
-							m_bStopping = false;
-							Base::msgRouter()->deleteRoute( m_tickRouteId );
-							m_tickRouteId = 0;
-							_requestRender();
-						}
-					}
+					m_bRefreshing = false;
+					m_bStopping = false;
+					Base::scheduler()->removeTask( m_tickTask );
+					m_tickTask = 0;
+					_requestRender();
 				}
-				break;
 			}
+		}
+		return 0;
+	}
+
+	//____ _receive() _____________________________________________________________
 
+	void RefreshButton::_receive( Msg * pMsg )
+	{
+		Button::_receive( pMsg );
+
+		switch( pMsg->type() )
+		{
 			case MsgType::KeyRelease:
 			{
 				KeyReleaseMsg_p pKeyRelease = KeyReleaseMsg::cast(pMsg);
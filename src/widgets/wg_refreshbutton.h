@@ -108,8 +108,10 @@ namespace wg
 		void			_cloneContent( const Widget * _pOrg );
 		virtual void 	_setSize( const Size& size );
 
+		int				_onTick( int ms );
 
-		RouteId			m_tickRouteId;
+
+		TaskId			m_tickTask;
 		GfxAnim_p		m_pRefreshAnim;
 		AnimTarget		m_animTarget;
 		RefreshMode		m_refreshMode;			// Determines if animation is a progressbar or spinner.
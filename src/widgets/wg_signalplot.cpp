@@ -0,0 +1,579 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+
+#include <wg_signalplot.h>
+#include <wg_gfxdevice.h>
+#include <wg_base.h>
+#include <wg_scheduler.h>
+
+#include <algorithm>
+
+namespace wg
+{
+	const char	SignalPlot::CLASSNAME[] = {"SignalPlot"};
+
+	//____ Constructor ____________________________________________________________
+
+	SignalPlot::SignalPlot() : m_queueWrite(0), m_queueRead(0), m_nDropped(0)
+	{
+		m_lineColor = Color::White;
+		m_valueMin = -1.f;
+		m_valueMax = 1.f;
+		m_mode = Mode::Sweep;
+		m_sweepGap = 4;
+		m_samplesPerColumn = 1;
+		m_updateInterval = 0;
+
+		m_nSamples = 0;
+		m_firstSample = 0;
+
+		m_queue.resize(16384);
+		_resizeHistory(65536);
+
+		m_updateTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _update(); } );
+	}
+
+	//____ Destructor _____________________________________________________________
+
+	SignalPlot::~SignalPlot()
+	{
+		Base::scheduler()->removeTask( m_updateTask );
+	}
+
+	//____ isInstanceOf() _________________________________________________________
+
+	bool SignalPlot::isInstanceOf( const char * pClassName ) const
+	{
+		if( pClassName==CLASSNAME )
+			return true;
+
+		return Widget::isInstanceOf(pClassName);
+	}
+
+	//____ className() ____________________________________________________________
+
+	const char * SignalPlot::className( void ) const
+	{
+		return CLASSNAME;
+	}
+
+	//____ cast() _________________________________________________________________
+
+	SignalPlot_p SignalPlot::cast( Object * pObject )
+	{
+		if( pObject && pObject->isInstanceOf(CLASSNAME) )
+			return SignalPlot_p( static_cast<SignalPlot*>(pObject) );
+
+		return 0;
+	}
+
+	//____ preferredSize() ________________________________________________________
+
+	Size SignalPlot::preferredSize() const
+	{
+		Size sz(256,64);
+
+		if( m_pSkin )
+			sz = m_pSkin->sizeForContent(sz);
+
+		return sz;
+	}
+
+	//____ setLineColor() _________________________________________________________
+
+	void SignalPlot::setLineColor( Color color )
+	{
+		if( color != m_lineColor )
+		{
+			m_lineColor = color;
+			_requestRender();
+		}
+	}
+
+	//____ setValueRange() ________________________________________________________
+	/**
+	 * @brief Set values displayed at bottom and top of plot.
+	 *
+	 * Samples outside the range are clipped. Default range is -1.0 to 1.0.
+	 */
+
+	bool SignalPlot::setValueRange( float min, float max )
+	{
+		if( !(min < max) )
+			return false;
+
+		if( min != m_valueMin || max != m_valueMax )
+		{
+			m_valueMin = min;
+			m_valueMax = max;
+			_requestRender();
+		}
+		return true;
+	}
+
+	//____ setMode() ______________________________________________________________
+
+	void SignalPlot::setMode( Mode mode )
+	{
+		if( mode != m_mode )
+		{
+			m_mode = mode;
+			_requestRender();
+		}
+	}
+
+	//____ setSweepGap() __________________________________________________________
+	/**
+	 * @brief Set number of empty columns in front of the cursor in Sweep mode.
+	 *
+	 * The gap separates the newest samples from the oldest ones. Default is 4.
+	 */
+
+	void SignalPlot::setSweepGap( int columns )
+	{
+		columns = std::max( columns, 0 );
+		if( columns != m_sweepGap )
+		{
+			m_sweepGap = columns;
+			if( m_mode == Mode::Sweep )
+				_requestRender();
+		}
+	}
+
+	//____ setSamplesPerColumn() __________________________________________________
+	/**
+	 * @brief Set number of samples displayed by each pixel column.
+	 *
+	 * History is increased if needed to fill the width of the plot.
+	 */
+
+	bool SignalPlot::setSamplesPerColumn( int samples )
+	{
+		if( samples < 1 )
+			return false;
+
+		if( samples != m_samplesPerColumn )
+		{
+			m_samplesPerColumn = samples;
+
+			if( historySize() < _minHistorySize() )
+				_resizeHistory( _minHistorySize() );
+
+			_requestRender();
+		}
+		return true;
+	}
+
+	//____ setHistorySize() _______________________________________________________
+	/**
+	 * @brief Set number of samples to keep.
+	 *
+	 * Size is rounded up to a power of two and never made smaller than needed to fill
+	 * the width of the plot. The latest samples are kept when size is changed.
+	 * Default is 65536 samples.
+	 */
+
+	bool SignalPlot::setHistorySize( int samples )
+	{
+		if( samples < 1 )
+			return false;
+
+		_resizeHistory( std::max( samples, _minHistorySize() ) );
+		_requestRender();
+		return true;
+	}
+
+	//____ setQueueSize() _________________________________________________________
+	/**
+	 * @brief Set number of samples that can be waiting for next update.
+	 *
+	 * Samples pushed while the queue is full are dropped. Size is rounded up to a power
+	 * of two. Samples in the queue are discarded, so this must not be called while
+	 * a producer might be pushing samples. Default is 16384 samples.
+	 */
+
+	bool SignalPlot::setQueueSize( int samples )
+	{
+		if( samples < 1 )
+			return false;
+
+		int size = 1;
+		while( size < samples )
+			size <<= 1;
+
+		m_queue.assign( size, 0.f );
+		m_queueWrite.store( 0, std::memory_order_relaxed );
+		m_queueRead.store( 0, std::memory_order_relaxed );
+		return true;
+	}
+
+	//____ setUpdateInterval() ____________________________________________________
+	/**
+	 * @brief Set milliseconds between moving samples from the queue to the plot.
+	 *
+	 * Default is 0, which updates the plot every tick.
+	 */
+
+	void SignalPlot::setUpdateInterval( int millisec )
+	{
+		m_updateInterval = std::max( millisec, 0 );
+		Base::scheduler()->wakeTask( m_updateTask, m_updateInterval );
+	}
+
+	//____ pushSamples() __________________________________________________________
+	/**
+	 * @brief Add samples to the plot.
+	 *
+	 * Safe to call from a producer thread while the GUI is running. Samples are queued
+	 * and displayed on next update. Samples that don't fit in the queue are dropped and
+	 * counted by samplesDropped().
+	 *
+	 * @return Number of samples queued.
+	 */
+
+	int SignalPlot::pushSamples( const float * pSamples, int nSamples )
+	{
+		uint64_t write = m_queueWrite.load( std::memory_order_relaxed );
+		uint64_t read = m_queueRead.load( std::memory_order_acquire );
+
+		int space = (int) (m_queue.size() - (write - read));
+		int nQueued = std::min( std::max( nSamples, 0 ), space );
+
+		uint64_t mask = m_queue.size() - 1;
+		for( int i = 0 ; i < nQueued ; i++ )
+			m_queue[(write + i) & mask] = pSamples[i];
+
+		m_queueWrite.store( write + nQueued, std::memory_order_release );
+
+		if( nQueued < nSamples )
+			m_nDropped.fetch_add( nSamples - nQueued, std::memory_order_relaxed );
+
+		return nQueued;
+	}
+
+	//____ clear() ________________________________________________________________
+	/**
+	 * @brief Remove all samples from plot, including those waiting in queue.
+	 */
+
+	void SignalPlot::clear()
+	{
+		m_queueRead.store( m_queueWrite.load( std::memory_order_acquire ), std::memory_order_release );
+
+		m_nSamples = 0;
+		m_firstSample = 0;
+		_requestRender();
+	}
+
+	//____ _cloneContent() ________________________________________________________
+
+	void SignalPlot::_cloneContent( const Widget * _pOrg )
+	{
+		Widget::_cloneContent( _pOrg );
+
+		const SignalPlot * pOrg = static_cast<const SignalPlot*>(_pOrg);
+
+		m_lineColor			= pOrg->m_lineColor;
+		m_valueMin			= pOrg->m_valueMin;
+		m_valueMax			= pOrg->m_valueMax;
+		m_mode				= pOrg->m_mode;
+		m_sweepGap			= pOrg->m_sweepGap;
+		m_samplesPerColumn	= pOrg->m_samplesPerColumn;
+		m_updateInterval	= pOrg->m_updateInterval;
+
+		setQueueSize( pOrg->queueSize() );
+		_resizeHistory( pOrg->historySize() );
+	}
+
+	//____ _setSize() _____________________________________________________________
+
+	void SignalPlot::_setSize( const Size& size )
+	{
+		Widget::_setSize( size );
+
+		if( historySize() < _minHistorySize() )
+			_resizeHistory( _minHistorySize() );
+	}
+
+	//____ _render() ______________________________________________________________
+
+	void SignalPlot::_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window )
+	{
+		Widget::_render( pDevice, _canvas, _window );
+
+		Rect canvas = m_pSkin ? m_pSkin->contentRect( _canvas, m_state ) : _canvas;
+		Rect clip( pDevice->clipBounds(), canvas );
+
+		if( m_nSamples == 0 || clip.w <= 0 || clip.h <= 0 )
+			return;
+
+		float scale = (canvas.h - 1) / (m_valueMax - m_valueMin);
+
+		// One vertical line per column, from min to max of its samples.
+
+		for( int x = clip.x ; x < clip.x + clip.w ; x++ )
+		{
+			int64_t	begin, end;
+			MinMax	minMax;
+
+			if( !_columnSamples( x - canvas.x, canvas.w, begin, end ) || !_minMax( begin, end, minMax ) )
+				continue;
+
+			float top = std::min( std::max( m_valueMax - minMax.max, 0.f ), m_valueMax - m_valueMin );
+			float bottom = std::min( std::max( m_valueMax - minMax.min, 0.f ), m_valueMax - m_valueMin );
+
+			int y1 = canvas.y + (int) (top * scale);
+			int y2 = canvas.y + (int) (bottom * scale);
+
+			pDevice->fill( Rect( x, y1, 1, y2 - y1 + 1 ), m_lineColor );
+		}
+	}
+
+	//____ _update() ______________________________________________________________
+	// Scheduler task moving samples from queue to history and requesting render of
+	// the columns affected.
+
+	int SignalPlot::_update()
+	{
+		uint64_t write = m_queueWrite.load( std::memory_order_acquire );
+		uint64_t read = m_queueRead.load( std::memory_order_relaxed );
+
+		if( write == read )
+			return m_updateInterval;
+
+		int64_t nBefore = m_nSamples;
+
+		uint64_t mask = m_queue.size() - 1;
+		while( read != write )
+			_appendSample( m_queue[(read++) & mask] );
+
+		m_queueRead.store( read, std::memory_order_release );
+
+		if( m_mode == Mode::Scroll )
+			_requestRender();
+		else
+		{
+			// Columns of new samples, including a possibly partly filled one, and
+			// the gap in front of them.
+
+			int64_t firstBucket = nBefore / m_samplesPerColumn;
+			int64_t lastBucket = (m_nSamples - 1) / m_samplesPerColumn;
+
+			_requestColumnRender( firstBucket, int( std::min( lastBucket - firstBucket + 1 + m_sweepGap, (int64_t) INT32_MAX ) ) );
+		}
+
+		return m_updateInterval;
+	}
+
+	//____ _appendSample() ________________________________________________________
+
+	void SignalPlot::_appendSample( float value )
+	{
+		if( !(value == value) )
+			value = 0.f;									// NaN
+
+		int64_t index = m_nSamples++;
+		int64_t mask = m_samples.size() - 1;
+
+		m_samples[index & mask] = value;
+
+		// Update every level of pyramid where this sample completes a block.
+
+		int64_t next = index + 1;
+
+		for( int level = 0 ; level < (int) m_pyramid.size() && (next & ((int64_t(2) << level) - 1)) == 0 ; level++ )
+		{
+			int64_t block = (next >> (level+1)) - 1;
+			MinMax first, second;
+
+			if( level == 0 )
+			{
+				first.min = first.max = m_samples[(block*2) & mask];
+				second.min = second.max = m_samples[(block*2+1) & mask];
+			}
+			else
+			{
+				const std::vector<MinMax>& below = m_pyramid[level-1];
+				int64_t belowMask = below.size() - 1;
+				first = below[(block*2) & belowMask];
+				second = below[(block*2+1) & belowMask];
+			}
+
+			std::vector<MinMax>& entries = m_pyramid[level];
+			entries[block & (entries.size()-1)] = { std::min( first.min, second.min ), std::max( first.max, second.max ) };
+		}
+	}
+
+	//____ _resizeHistory() _______________________________________________________
+
+	void SignalPlot::_resizeHistory( int samples )
+	{
+		int size = 1024;
+		while( size < samples )
+			size <<= 1;
+
+		if( size == historySize() )
+			return;
+
+		// Save the samples we can keep and append them again.
+
+		int64_t	first = std::max( m_firstSample, m_nSamples - historySize() );
+		int64_t	nKeep = std::min( m_nSamples - first, (int64_t) size );
+
+		std::vector<float> keep;
+		keep.reserve( (size_t) nKeep );
+
+		int64_t oldMask = m_samples.size() - 1;
+		for( int64_t i = m_nSamples - nKeep ; i < m_nSamples ; i++ )
+			keep.push_back( m_samples[i & oldMask] );
+
+		m_samples.assign( size, 0.f );
+
+		m_pyramid.clear();
+		for( int entries = size / 2 ; entries >= 1 ; entries /= 2 )
+			m_pyramid.push_back( std::vector<MinMax>( entries, { 0.f, 0.f } ) );
+
+		m_nSamples -= nKeep;
+		m_firstSample = m_nSamples;
+
+		for( float value : keep )
+			_appendSample( value );
+	}
+
+	//____ _minMax() ______________________________________________________________
+	// Min and max of samples from begin up to end, limited to the ones still in history.
+
+	bool SignalPlot::_minMax( int64_t begin, int64_t end, MinMax& result ) const
+	{
+		begin = std::max( begin, std::max( m_firstSample, m_nSamples - historySize() ) );
+		end = std::min( end, m_nSamples );
+
+		if( begin >= end )
+			return false;
+
+		result.min = m_samples[begin & (m_samples.size()-1)];
+		result.max = result.min;
+
+		// Step through using the largest aligned blocks that fit.
+
+		while( begin < end )
+		{
+			int level = -1;
+			while( level + 1 < (int) m_pyramid.size() && (begin & ((int64_t(2) << (level+1)) - 1)) == 0 && begin + (int64_t(2) << (level+1)) <= end )
+				level++;
+
+			MinMax value;
+			if( level < 0 )
+			{
+				value.min = value.max = m_samples[begin & (m_samples.size()-1)];
+				begin++;
+			}
+			else
+			{
+				const std::vector<MinMax>& entries = m_pyramid[level];
+				value = entries[(begin >> (level+1)) & (entries.size()-1)];
+				begin += int64_t(2) << level;
+			}
+
+			result.min = std::min( result.min, value.min );
+			result.max = std::max( result.max, value.max );
+		}
+
+		return true;
+	}
+
+	//____ _columnSamples() _______________________________________________________
+	// Range of samples displayed in given column of a plot of given width. Includes the
+	// last sample of previous column, so that neighbouring columns connect.
+
+	bool SignalPlot::_columnSamples( int column, int width, int64_t& begin, int64_t& end ) const
+	{
+		if( m_nSamples == 0 || width <= 0 )
+			return false;
+
+		int64_t lastBucket = (m_nSamples - 1) / m_samplesPerColumn;
+		int64_t bucket;
+
+		if( m_mode == Mode::Sweep )
+		{
+			int cursor = int( lastBucket % width );
+			int distance = (cursor - column + width) % width;
+
+			if( distance > 0 && distance >= width - std::min( m_sweepGap, width - 1 ) )
+				return false;									// In the gap.
+
+			bucket = lastBucket - distance;
+		}
+		else
+			bucket = lastBucket - (width - 1 - column);
+
+		if( bucket < 0 )
+			return false;
+
+		begin = bucket * m_samplesPerColumn;
+		end = std::min( begin + m_samplesPerColumn, m_nSamples );
+
+		if( begin > 0 )
+			begin--;
+
+		return true;
+	}
+
+	//____ _requestColumnRender() _________________________________________________
+
+	void SignalPlot::_requestColumnRender( int64_t firstBucket, int nColumns )
+	{
+		Rect content = _contentRect();
+
+		if( nColumns >= content.w )
+		{
+			_requestRender( content );
+			return;
+		}
+
+		int column = int( firstBucket % content.w );
+
+		if( column + nColumns <= content.w )
+			_requestRender( Rect( content.x + column, content.y, nColumns, content.h ) );
+		else
+		{
+			_requestRender( Rect( content.x + column, content.y, content.w - column, content.h ) );
+			_requestRender( Rect( content.x, content.y, column + nColumns - content.w, content.h ) );
+		}
+	}
+
+	//____ _contentRect() _________________________________________________________
+
+	Rect SignalPlot::_contentRect() const
+	{
+		return m_pSkin ? m_pSkin->contentRect( Rect( 0, 0, m_size ), m_state ) : Rect( 0, 0, m_size );
+	}
+
+	//____ _minHistorySize() ______________________________________________________
+	// Samples needed to fill all columns, plus one column for partly filled one.
+
+	int SignalPlot::_minHistorySize() const
+	{
+		return (_contentRect().w + 1) * m_samplesPerColumn + 1;
+	}
+
+} // namespace wg
@@ -0,0 +1,178 @@
+/*=========================================================================
+
+						 >>> WonderGUI <<<
+
+  This file is part of Tord Jansson's WonderGUI Graphics Toolkit
+  and copyright (c) Tord Jansson, Sweden [tord.jansson@gmail.com].
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is free software; you can redistribute
+  this file and/or modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+							-----------
+
+  The WonderGUI Graphics Toolkit is also available for use in commercial
+  closed-source projects under a separate license. Interested parties
+  should contact Tord Jansson [tord.jansson@gmail.com] for details.
+
+=========================================================================*/
+#ifndef WG_SIGNALPLOT_DOT_H
+#define WG_SIGNALPLOT_DOT_H
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <wg_widget.h>
+
+namespace wg
+{
+	class SignalPlot;
+	typedef	StrongPtr<SignalPlot>	SignalPlot_p;
+	typedef	WeakPtr<SignalPlot>		SignalPlot_wp;
+
+	//____ SignalPlot ____________________________________________________________
+	/**
+	 * @brief	Plots a continuous stream of samples.
+	 *
+	 * SignalPlot displays the latest samples of a signal, such as audio or telemetry, that
+	 * is fed to it while running. Samples are pushed into a lock-free queue by a producer
+	 * thread and moved into the plot's history once per update.
+	 *
+	 * Each pixel column displays the minimum and maximum of the samples it covers. These
+	 * are looked up in a min/max pyramid kept over the history, so rendering costs the
+	 * same no matter how many samples each column covers.
+	 *
+	 * In Sweep mode, new columns are drawn over the oldest ones at a cursor that wraps
+	 * around the plot, just like an analog oscilloscope. Only the columns updated need
+	 * to be rendered again. In Scroll mode the plot scrolls to the left as samples arrive,
+	 * which needs the whole plot to be rendered again on each update.
+	 *
+	 * pushSamples() is the only method that may be called from another thread than the
+	 * one running the GUI, and only from one thread at a time.
+	 */
+
+	class SignalPlot : public Widget
+	{
+	public:
+
+		//____ Enums __________________________________________
+
+		enum class Mode
+		{
+			Sweep,
+			Scroll
+		};
+
+		//.____ Creation __________________________________________
+
+		static SignalPlot_p	create() { return SignalPlot_p(new SignalPlot()); }
+
+		//.____ Identification __________________________________________
+
+		bool				isInstanceOf( const char * pClassName ) const;
+		const char *		className( void ) const;
+		static const char	CLASSNAME[];
+		static SignalPlot_p	cast( Object * pObject );
+
+		//.____ Appearance __________________________________________
+
+		void			setLineColor( Color color );
+		Color			lineColor() const { return m_lineColor; }
+
+		bool			setValueRange( float min, float max );
+		float			valueMin() const { return m_valueMin; }
+		float			valueMax() const { return m_valueMax; }
+
+		void			setMode( Mode mode );
+		Mode			mode() const { return m_mode; }
+
+		void			setSweepGap( int columns );
+		int				sweepGap() const { return m_sweepGap; }
+
+		//.____ Behavior ____________________________________________
+
+		bool			setSamplesPerColumn( int samples );
+		int				samplesPerColumn() const { return m_samplesPerColumn; }
+
+		bool			setHistorySize( int samples );
+		int				historySize() const { return (int) m_samples.size(); }
+
+		bool			setQueueSize( int samples );
+		int				queueSize() const { return (int) m_queue.size(); }
+
+		void			setUpdateInterval( int millisec );
+		int				updateInterval() const { return m_updateInterval; }
+
+		//.____ Control ________________________________________________
+
+		int				pushSamples( const float * pSamples, int nSamples );
+		void			clear();
+
+		//.____ State __________________________________________________
+
+		int64_t			samplesReceived() const { return m_nSamples; }
+		uint64_t		samplesDropped() const { return m_nDropped.load(std::memory_order_relaxed); }
+
+		//.____ Geometry ____________________________________________
+
+		Size			preferredSize() const;
+
+
+	protected:
+		SignalPlot();
+		virtual ~SignalPlot();
+		virtual Widget* _newOfMyType() const { return new SignalPlot(); };
+
+		void			_cloneContent( const Widget * _pOrg );
+		void			_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window );
+		void			_setSize( const Size& size );
+
+	private:
+
+		struct MinMax
+		{
+			float	min;
+			float	max;
+		};
+
+		int				_update();
+		void			_appendSample( float value );
+		void			_resizeHistory( int samples );
+		bool			_minMax( int64_t begin, int64_t end, MinMax& result ) const;
+		bool			_columnSamples( int column, int width, int64_t& begin, int64_t& end ) const;
+		void			_requestColumnRender( int64_t firstBucket, int nColumns );
+		Rect			_contentRect() const;
+		int				_minHistorySize() const;
+
+		Color			m_lineColor;
+		float			m_valueMin;
+		float			m_valueMax;
+		Mode			m_mode;
+		int				m_sweepGap;
+		int				m_samplesPerColumn;
+		int				m_updateInterval;
+
+		TaskId			m_updateTask;
+
+		// Queue between producer and us. Producer only writes m_queueWrite, we only write m_queueRead.
+
+		std::vector<float>		m_queue;
+		std::atomic<uint64_t>	m_queueWrite;
+		std::atomic<uint64_t>	m_queueRead;
+		std::atomic<uint64_t>	m_nDropped;
+
+		// History of samples with min/max pyramid. Level k of pyramid covers blocks of 2^(k+1) samples.
+		// Both are ring buffers indexed by sample number, masked by their size.
+
+		std::vector<float>					m_samples;
+		std::vector<std::vector<MinMax>>	m_pyramid;
+		int64_t								m_nSamples;			// Number of samples received since clear().
+		int64_t								m_firstSample;		// First sample kept since clear() or resize of history.
+	};
+
+} // namespace wg
+#endif //WG_SIGNALPLOT_DOT_H
@@ -26,6 +26,7 @@
 #include <wg_msg.h>
 #include <wg_base.h>
 #include <wg_msgrouter.h>
+#include <wg_scheduler.h>
 
 #include <math.h>
 
@@ -73,15 +74,14 @@ namespace wg
 
 		m_bUseFades = false;
 
-		m_tickRouteId = Base::msgRouter()->addRoute( MsgType::Tick, this );
+		m_updateTask = Base::scheduler()->addTask( [this](int64_t timestamp, int timediff) { return _updateLEDs(); } );
 	}
 
 	//____ Destructor _____________________________________________________________
 
 	VolumeMeter::~VolumeMeter()
 	{
-		if( m_tickRouteId )
-			Base::msgRouter()->deleteRoute( m_tickRouteId );
+		Base::scheduler()->removeTask( m_updateTask );
 	}
 
 	//____ isInstanceOf() _________________________________________________________
@@ -171,6 +171,8 @@ namespace wg
 		m_LEDStates.resize(m_nLEDs);
 		for(int i=0;i<m_nLEDs;i++)
 			m_LEDStates[i] = 0.0f;
+
+		Base::scheduler()->wakeTask( m_updateTask );
 	}
 
 	//____ setLEDSpacing() ___________________________________________________________
@@ -207,6 +209,7 @@ namespace wg
 
 		m_fPeak = fPeak;
 
+		Base::scheduler()->wakeTask( m_updateTask );
 	}
 
 
@@ -245,127 +248,125 @@ namespace wg
 			m_iSidePadding = 0;
 	}
 
-	//____ _onEvent() ______________________________________________________________
+	//____ _updateLEDs() __________________________________________________________
+	// Scheduler task updating LED states. Only needs to run while LEDs are fading out,
+	// setValue() wakes it up again.
 
-	void VolumeMeter::_receive( Msg * pMsg )
+	int VolumeMeter::_updateLEDs()
 	{
-		switch( pMsg->type() )
+		bool bFading = false;
+
+		int firstRenderLED = -1;
+		int lastRenderLED = -1;
+
+		for( int i = 0 ; i < m_nLEDs ; i++ )
 		{
-			case MsgType::Tick:
+			bool 	on = false;
+
+			// NB: Hold is not implemented for Zero In Middle
+			if(m_bZeroInMiddle)
 			{
-				int firstRenderLED = -1;
-				int lastRenderLED = -1;
+				float id = d*(float)i;
 
-				for( int i = 0 ; i < m_nLEDs ; i++ )
-				{
-					bool 	on = false;
-
-					// NB: Hold is not implemented for Zero In Middle
-					if(m_bZeroInMiddle)
-					{
-						float id = d*(float)i;
-
-						// This one is tricky...
-
-						if(id < 0.5f)
-						{
-							if(m_fPeak < id + d2)
-								on = true;
-						}
-						else if(id > 0.5f)
-						{
-							if(m_fPeak > id - d2)
-								on = true;
-						}
-						else
-							on = true;
-					}
-					else // Normal mode
-					{
-						if( i < m_iPeak || i+1 == m_iHold )
-							on = true;
-					}
-
-
-					float	LEDState;
-
-					if( on )
-						LEDState = 1.f;
-					else
-					{
-						if( m_bUseFades )
-						{
-							LEDState = m_LEDStates[i]*0.7f; // Fade out
-
-							if(LEDState < 0.1f)
-								LEDState = 0.f;
-						}
-						else LEDState =0.f;
-					}
-
-					if( LEDState != m_LEDStates[i] )
-					{
-						m_LEDStates[i] = LEDState;
-						if( firstRenderLED == -1 )
-							firstRenderLED = i;
-						lastRenderLED = i;
-					}
+				// This one is tricky...
 
+				if(id < 0.5f)
+				{
+					if(m_fPeak < id + d2)
+						on = true;
 				}
+				else if(id > 0.5f)
+				{
+					if(m_fPeak > id - d2)
+						on = true;
+				}
+				else
+					on = true;
+			}
+			else // Normal mode
+			{
+				if( i < m_iPeak || i+1 == m_iHold )
+					on = true;
+			}
 
-				// Possibly calculate a dirty rectangle
 
-				if( firstRenderLED != -1 )
+			float	LEDState;
+
+			if( on )
+				LEDState = 1.f;
+			else
+			{
+				if( m_bUseFades )
 				{
-					Size sz = Size();
-					Rect rect;
-
-					int meterLen = (m_direction == Direction::Up || m_direction == Direction::Down) ? sz.h : sz.w;
-
-					int dirtBeg = firstRenderLED*meterLen/m_nLEDs;
-					int dirtLen = (lastRenderLED+1)*meterLen/m_nLEDs + 1 - dirtBeg;	// One pixels margin, due to subpixel precision one LED can end on same that the next start
-
-					switch( m_direction )
-					{
-						case Direction::Up:
-
-							rect.x = 0;
-							rect.y = sz.h - (dirtBeg+dirtLen);
-							rect.w = sz.w;
-							rect.h = dirtLen;
-						break;
-
-						case Direction::Down:
-							rect.x = 0;
-							rect.y = dirtBeg;
-							rect.w = sz.w;
-							rect.h = dirtLen;
-						break;
-
-						case Direction::Left:
-							rect.x = sz.w - (dirtBeg+dirtLen);
-							rect.y = 0;
-							rect.w = dirtLen;
-							rect.h = sz.h;
-						break;
-
-						case Direction::Right:
-							rect.x = dirtBeg;
-							rect.y = 0;
-							rect.w = dirtLen;
-							rect.h = sz.h;
-						break;
-					}
-
-					_requestRender(rect);
+					LEDState = m_LEDStates[i]*0.7f; // Fade out
+
+					if(LEDState < 0.1f)
+						LEDState = 0.f;
 				}
+				else LEDState =0.f;
 			}
-			pMsg->swallow();
-			break;
 
-			default:
-			break;
+			if( LEDState > 0.f && LEDState < 1.f )
+				bFading = true;
+
+			if( LEDState != m_LEDStates[i] )
+			{
+				m_LEDStates[i] = LEDState;
+				if( firstRenderLED == -1 )
+					firstRenderLED = i;
+				lastRenderLED = i;
+			}
+
+		}
+
+		// Possibly calculate a dirty rectangle
+
+		if( firstRenderLED != -1 )
+		{
+			Size sz = Size();
+			Rect rect;
+
+			int meterLen = (m_direction == Direction::Up || m_direction == Direction::Down) ? sz.h : sz.w;
+
+			int dirtBeg = firstRenderLED*meterLen/m_nLEDs;
+			int dirtLen = (lastRenderLED+1)*meterLen/m_nLEDs + 1 - dirtBeg;	// One pixels margin, due to subpixel precision one LED can end on same that the next start
+
+			switch( m_direction )
+			{
+				case Direction::Up:
+
+					rect.x = 0;
+					rect.y = sz.h - (dirtBeg+dirtLen);
+					rect.w = sz.w;
+					rect.h = dirtLen;
+				break;
+
+				case Direction::Down:
+					rect.x = 0;
+					rect.y = dirtBeg;
+					rect.w = sz.w;
+					rect.h = dirtLen;
+				break;
+
+				case Direction::Left:
+					rect.x = sz.w - (dirtBeg+dirtLen);
+					rect.y = 0;
+					rect.w = dirtLen;
+					rect.h = sz.h;
+				break;
+
+				case Direction::Right:
+					rect.x = dirtBeg;
+					rect.y = 0;
+					rect.w = dirtLen;
+					rect.h = sz.h;
+				break;
+			}
+
+			_requestRender(rect);
 		}
+
+		return bFading ? 0 : -1;
 	}
 
 
@@ -82,13 +82,13 @@ namespace wg
 		virtual ~VolumeMeter();
 		virtual Widget* _newOfMyType() const { return new VolumeMeter(); };
 
-		void			_receive( Msg * pMsg );
+		int				_updateLEDs();
 		void			_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window );
 		void			_cloneContent( const Widget * _pOrg );
 		bool			_alphaTest( const Coord& ofs );
 		void			_setSize( const Size& size );
 
-		RouteId			m_tickRouteId;
+		TaskId			m_updateTask;
 
 		Direction		m_direction;
 		Color			m_LEDColors[3][2];
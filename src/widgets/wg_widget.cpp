@@ -32,6 +32,8 @@ namespace wg
 
 	const char Widget::CLASSNAME[] = {"Widget"};
 
+	RenderStats *	Widget::s_pRenderStats = nullptr;
+
 
 	//____ Constructor ____________________________________________________________
 
@@ -483,6 +485,12 @@ namespace wg
 
 	void Widget::_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Patches& patches )
 	{
+		if( s_pRenderStats )
+		{
+			s_pRenderStats->widgetsVisited++;
+			s_pRenderStats->widgetsRendered++;
+		}
+
 		pDevice->setClipList(patches.size(), patches.begin());
 		_render( pDevice, _canvas, _window );
 	}
@@ -504,6 +512,24 @@ namespace wg
 		}
 	}
 
+	//____ _invalidateOpaqueRegion() ____________________________________________
+	/*
+		Containers cache the area covered by their opaque descendants, so any change
+		in appearance or geometry needs to invalidate the cache of all our ancestors.
+		An already invalid container has invalid ancestors as well, so we can stop there.
+	*/
+
+	void Widget::_invalidateOpaqueRegion()
+	{
+		Container * p = isContainer() ? static_cast<Container*>(this) : _parent();
+
+		while( p && p->m_bOpaqueRegionValid )
+		{
+			p->m_bOpaqueRegionValid = false;
+			p = p->_parent();
+		}
+	}
+
 	//____ _render() ____________________________________________________________
 
 	void Widget::_render( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window )
@@ -516,6 +542,9 @@ namespace wg
 
 	void Widget::_setSize( const Size& size )
 	{
+		if( size != m_size )
+			_invalidateOpaqueRegion();
+
 		m_size = size;
 //		_requestRender();		Do NOT request render here, it is the responsibility of ancestor initiating the series of events.
 	}
@@ -55,6 +55,22 @@ namespace wg
 	typedef	StrongPtr<Msg>			Msg_p;
 	typedef	WeakPtr<Msg>			Msg_wp;
 
+	//____ RenderStats ________________________________________________________
+	/**
+	 * @brief Statistics for rendering a widget hierarchy.
+	 *
+	 * Collected by RootPanel when enabled with RootPanel::setRenderStatsEnabled().
+	 * Cleared by RootPanel::beginRender().
+	 */
+
+	struct RenderStats
+	{
+		int		dirtyPatches;		///< Dirty patches rendered.
+		int64_t	dirtyPixels;		///< Pixels covered by the dirty patches.
+		int		widgetsVisited;		///< Widgets the dirty patches were passed to.
+		int		widgetsRendered;	///< Widgets that rendered themselves.
+	};
+
 
 	/**
 	 * @brief Base class for widgets.
@@ -204,8 +220,8 @@ namespace wg
 
 		// Convenient calls to holder
 
-		inline void		_requestRender() { if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot ); }
-		inline void		_requestRender( const Rect& rect ) { if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot, rect ); }
+		inline void		_requestRender() { _invalidateOpaqueRegion(); if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot ); }
+		inline void		_requestRender( const Rect& rect ) { _invalidateOpaqueRegion(); if( m_pHolder ) m_pHolder->_childRequestRender( m_pSlot, rect ); }
 		inline void		_requestResize() { if( m_pHolder ) m_pHolder->_childRequestResize( m_pSlot ); }
 		inline void		_requestInView() const { if( m_pHolder ) m_pHolder->_childRequestInView( m_pSlot ); }
 		inline void		_requestInView( const Rect& mustHaveArea, const Rect& niceToHaveArea ) const { if( m_pHolder ) m_pHolder->_childRequestInView( m_pSlot, mustHaveArea, niceToHaveArea ); }
@@ -222,6 +238,7 @@ namespace wg
 		virtual void	_renderPatches( GfxDevice * pDevice, const Rect& _canvas, const Rect& _window, const Patches& patches );
 		virtual void	_collectPatches( Patches& container, const Rect& geo, const Rect& clip );
 		virtual void	_maskPatches( Patches& patches, const Rect& geo, const Rect& clip, BlendMode blendMode );
+		void			_invalidateOpaqueRegion();
 
 		Widget *		_clone() const;
 		virtual void	_cloneContent( const Widget * _pOrg );
@@ -229,6 +246,8 @@ namespace wg
 
 		virtual void	_refresh();
 		virtual void	_setSize( const Size& size );
+
+		static RenderStats *	s_pRenderStats;		// Set by RootPanel during rendering when stats are enabled.
 		virtual void	_setSkin( Skin * pSkin );
 		virtual void	_setState( State state );
 
@@ -49,6 +49,7 @@
 #include <wg_gfxstreamlogger.h>
 #include <wg_gfxstreamplayer.h>
 #include <wg_inputhandler.h>
+#include <wg_scheduler.h>
 #include <wg_componentholder.h>
 #include <wg_key.h>
 #include <wg_mempool.h>
@@ -59,10 +60,13 @@
 #include <wg_nullgfxdevice.h>
 #include <wg_object.h>
 #include <wg_paddedslot.h>
+#include <wg_palette.h>
 #include <wg_patches.h>
+#include <wg_bandedpatches.h>
 #include <wg_pointers.h>
 #include <wg_receiver.h>
 #include <wg_resdb.h>
+#include <wg_resbundle.h>
 #include <wg_resloader.h>
 #include <wg_scrollbartarget.h>
 #include <wg_slot.h>
@@ -72,11 +76,13 @@
 #include <wg_strongptr.h>
 #include <wg_surface.h>
 #include <wg_surfacefactory.h>
+#include <wg_surfaceatlas.h>
 #include <wg_textlink.h>
 #include <wg_textstyle.h>
 #include <wg_textstylemanager.h>
 #include <wg_texttool.h>
 #include <wg_togglegroup.h>
+#include <wg_trace.h>
 #include <wg_types.h>
 #include <wg_util.h>
 #include <wg_weakinterfaceptr.h>
@@ -152,6 +158,7 @@
 #include <wg_refreshbutton.h>
 #include <wg_rulerlabels.h>
 #include <wg_scrollbar.h>
+#include <wg_signalplot.h>
 #include <wg_simplevolumemeter.h>
 #include <wg_textdisplay.h>
 #include <wg_texteditor.h>